@@ -0,0 +1,100 @@
+/**
+ * @file arena.h
+ * @brief Contains declarations of the arena (bump) allocator
+ * @authors Michal Repcik (xrepcim00)
+ *
+ * Arena hands out memory from large pages by bumping an offset, individual
+ * allocations are never freed, all pages are released at once by destroy_arena().
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_PAGE_SIZE (1 << 16)    ///< Default size of arena page in bytes.
+#define ARENA_ALIGN sizeof(void*)      ///< Alignment of every allocation (nodes hold pointers at most).
+
+/**
+ * @struct ArenaPage
+ * @brief Page of memory, pages of the arena form a linked list (newest first).
+*/
+typedef struct ArenaPage {
+    struct ArenaPage* next;     ///< Previously allocated page.
+    size_t size;                ///< Number of bytes in data.
+    size_t used;                ///< Number of used bytes in data.
+    unsigned char* data;        ///< Memory of the page (follows the header).
+} ArenaPage;
+
+/**
+ * @struct Arena
+ * @brief Struct containing pages and statistics of the arena, zero initialized arena is empty.
+*/
+typedef struct {
+    ArenaPage* page;            ///< Current page, NULL if nothing was allocated.
+    size_t alloc_count;         ///< Number of allocations.
+    size_t page_count;          ///< Number of allocated pages.
+} Arena;
+
+/**
+ * @fn void* arena_alloc_page(Arena* arena, size_t size)
+ * @brief Allocates new page large enough for size bytes and returns memory from it.
+ *
+ * Used by arena_alloc() when the current page is full.
+ *
+ * @param[in, out] arena Pointer to arena
+ * @param[in] size Number of bytes (aligned)
+ * @return Pointer to memory or NULL if allocation failed
+*/
+void* arena_alloc_page(Arena* arena, size_t size);
+
+/**
+ * @brief Returns size bytes of memory owned by the arena or NULL if allocation failed.
+*/
+static inline void* arena_alloc(Arena* arena, size_t size) {
+    size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+    ArenaPage* page = arena->page;
+    if (page == NULL || page->size - page->used < size) {
+        return arena_alloc_page(arena, size);
+    }
+    void* ptr = page->data + page->used;
+    page->used += size;
+    arena->alloc_count++;
+    return ptr;
+}
+
+/**
+ * @fn void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size)
+ * @brief Grows memory returned by the arena to new_size bytes.
+ *
+ * The last allocation is grown in place when the page has enough space,
+ * otherwise content is copied into a new allocation.
+ *
+ * @param[in, out] arena Pointer to arena
+ * @param[in] ptr Pointer to memory of old_size bytes from this arena (or NULL)
+ * @param[in] old_size Size of memory pointed to by ptr
+ * @param[in] new_size Requested size
+ * @return Pointer to memory or NULL if allocation failed
+*/
+void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size);
+
+/**
+ * @fn char* arena_strdup(Arena* arena, const char* str)
+ * @brief Copies null terminated string into the arena.
+ *
+ * @param[in, out] arena Pointer to arena
+ * @param[in] str String to copy
+ * @return Pointer to the copy or NULL if allocation failed
+*/
+char* arena_strdup(Arena* arena, const char* str);
+
+/**
+ * @fn void destroy_arena(Arena* arena)
+ * @brief Frees all pages of the arena, arena can be used again afterwards.
+ *
+ * @param[in, out] arena Pointer to arena
+ * @return void
+*/
+void destroy_arena(Arena* arena);
+
+#endif // ARENA_H
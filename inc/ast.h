@@ -8,6 +8,8 @@
 #define AST_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include "arena.h"
 
 /**
  * @enum ASTNodeType
@@ -64,78 +66,102 @@ typedef enum {
     AST_NOT_EQU         ///< '!=' operator
 } OperatorType;
 
+/**
+ * @struct ExpressionInfo
+ * @brief Type of an expression computed by semantic analysis
+ *
+ * Literal and null nodes get it when they are created, identifiers, binary
+ * operators and function calls when semantic analysis evaluates them (once).
+ * It fits into padding after the node type, so it does not make nodes larger.
+*/
+typedef struct {
+    uint8_t data_type;      ///< DataType of the value, AST_UNSPECIFIED for null or if not evaluated
+    bool nullable;          ///< Flag if the value can be null
+    bool constant;          ///< Flag if the value is known at compile time (literals and constants initialized by them)
+    bool evaluated;         ///< Flag if the type was already computed
+} ExpressionInfo;
+
 /**
  * @struct ASTNode
  * @brief Representation of a node in Abstract Syntax Tree
  * 
  * @param type Type of node
  * @union Encapsulates different types of substructures for nodes (declarations, statements, expression)
+ *
+ * Nodes are allocated only as large as the variant of their type, so fields of
+ * other variants must not be accessed. Child lists live in ast_children.
 */
 typedef struct ASTNode ASTNode;     ///< Forward declaration to ensure ASTNode is defined before its usage
 struct ASTNode {
     ASTNodeType type;
+    ExpressionInfo expr;            ///< Type of expression nodes (literals, null, identifier, binary operator, function call)
     union {
         struct {
-            int decl_capacity;      ///< Number of allocated pointers to declaration nodes
             int decl_count;         ///< Number of top level declarations
-            ASTNode** declarations; ///< Top level declaration (fn, var, const)
+            uint32_t declarations;  ///< Index of the first top level declaration in ast_children
         } Program;                  ///< Program node (root of AST)
  
         struct {
-            char* fn_name;          ///< Function name
+            const char* fn_name;    ///< Function name
             int param_count;        ///< Number of parameters
-            int param_capacity;     ///< Number of allocated pointers to parameter nodes
-            ASTNode** params;       ///< Array of pointers to function parameters
+            uint32_t params;        ///< Index of the first parameter in ast_children
             ASTNode* block;         ///< Pointer to node encapsulating content of the function
             bool nullable;          ///< Flag if the function return type is nullable
             DataType return_type;   ///< Return type
+            int local_count;        ///< Number of local symbols (set by name resolution)
         } FnDecl;
 
         struct {
             DataType data_type;     ///< Expected data type
             bool nullable;          ///< Flag if the parameter is nullable
-            char* identifier;       ///< Name of varaible used in function
+            const char* identifier; ///< Name of varaible used in function
+            int symbol;             ///< Local symbol id (set by name resolution)
+            bool redeclared;        ///< Flag if the name was already visible (set by name resolution)
         } Param;
 
         struct {
-            char* var_name;         ///< Variable name
+            const char* var_name;   ///< Variable name
             bool nullable;          ///< Flag if the variable is nullable
             DataType data_type;     ///< Data type (optional)
             ASTNode* expression;    ///< Expression/identifier/number
+            int symbol;             ///< Local symbol id, -1 for discard (set by name resolution)
+            bool redeclared;        ///< Flag if the name was already visible (set by name resolution)
         } VarDecl;
 
         struct {
-            char* const_name;       ///< Constant name
+            const char* const_name; ///< Constant name
             bool nullable;          ///< Flag if the constant is nullable
             DataType data_type;     ///< Data type (optional)
             ASTNode* expression;    ///< Expression/identifier/number
+            int symbol;             ///< Local symbol id, -1 for discard (set by name resolution)
+            bool redeclared;        ///< Flag if the name was already visible (set by name resolution)
         } ConstDecl;
 
         struct {
             int node_count;         ///< Number of nodes;
-            int node_capacity;      ///< Number of allocated pointers to nodes
-            ASTNode** nodes;        ///< Array of pointer to nodes (delcaration or statements)
+            uint32_t nodes;         ///< Index of the first node (delcaration or statement) in ast_children
         } Block;
 
         struct {
             ASTNode* expression;    ///< Expression controlling cycle
-            char* element_bind;     ///< Ellement bind (optional)
+            const char* element_bind; ///< Ellement bind (optional)
             ASTNode* block;         ///< Pointer to a node encapsulating while cycle
+            int bind_symbol;        ///< Local symbol id of element bind (set by name resolution)
         } WhileCycle;
 
         struct {
             ASTNode* expression;    ///< Expression controlling cycle
-            char* element_bind;     ///< Ellement bind (optional)
+            const char* element_bind; ///< Ellement bind (optional)
             ASTNode* if_block;      ///< Pointer to a node encapsulating if block
             ASTNode* else_block;    ///< Pointer to a node encapsulating else block
+            int bind_symbol;        ///< Local symbol id of element bind (set by name resolution)
         } IfElse;
 
         struct {
-            char* fn_name;          ///< Function name
+            const char* fn_name;    ///< Function name
             int arg_count;          ///< Number of arguments
-            int arg_capacity;       ///< Number of allocated pointers to function arguments
+            uint32_t args;          ///< Index of the first argument in ast_children
             bool is_builtin;        ///< Flag for builtin function
-            ASTNode** args;         ///< Array of pointers to function arguments
         } FnCall;
 
         struct {
@@ -165,7 +191,8 @@ struct ASTNode {
         } String;
 
         struct {
-            char* identifier;       ///< Identifier node (used in binary expressions)
+            const char* identifier; ///< Identifier node (used in binary expressions)
+            int symbol;             ///< Local symbol id, -1 if not declared (set by name resolution)
         } Identifier;
 
         struct {
@@ -173,28 +200,57 @@ struct ASTNode {
         } Expression;
 
         struct {
-            char* identifier;
+            const char* identifier;
             ASTNode* expression;
+            int symbol;             ///< Local symbol id, -1 if not declared (set by name resolution)
+            DataType data_type;     ///< Type of the assigned variable (set by semantic analysis)
         } Assignment;
     };
 };
 
+/**
+ * @struct ASTNodeArray
+ * @brief Growing array of node pointers.
+ *
+ * Child lists of all nodes (declarations, parameters, block nodes and arguments)
+ * are stored as contiguous ranges in one such array, nodes keep only the index of
+ * their first child and the child count.
+*/
+typedef struct {
+    ASTNode** nodes;            ///< Array of node pointers
+    uint32_t count;             ///< Number of used pointers
+    uint32_t capacity;          ///< Number of allocated pointers
+} ASTNodeArray;
+
+/**
+ * @var ASTNodeArray ast_children
+ * @brief Side array holding child lists of all nodes of the AST.
+*/
+extern ASTNodeArray ast_children;
+
+/**
+ * @brief Returns i-th child of the list starting at index first in ast_children.
+*/
+static inline ASTNode* ast_child(uint32_t first, int i) {
+    return ast_children.nodes[first + i];
+}
+
 ASTNode* create_null_node();
 
-ASTNode* create_assignment_node(char* identifier);
+ASTNode* create_assignment_node(const char* identifier);
 
 /**
- * @fn ASTNode* create_identifier_node(char* identifier)
+ * @fn ASTNode* create_identifier_node(const char* identifier)
  * @brief Function that creates an identifier node
  * 
  * Node type is set to AST_IDENTIFIER, and the Identifier struct's `identifier` field
- * is set based on the argument. Memory is allocated for the identifier string using
- * strdup (must be freed later).
+ * is set based on the argument. Identifier has to be interned (see intern.h),
+ * node only stores the pointer.
  * 
  * @param[in] identifier The identifier string (e.g., variable name)
  * @return Returns pointer to ASTNode or NULL if memory allocation failed
  */
-ASTNode* create_identifier_node(char* identifier);
+ASTNode* create_identifier_node(const char* identifier);
 
 /**
  * @fn ASTNode* create_binary_op_node(int operator, ASTNode* left, ASTNode* right)
@@ -235,7 +291,7 @@ ASTNode* create_i32_node(int value);
 ASTNode* create_f64_node(double value);
 
 /**
- * @fn ASTNode* create_string_node(char* value)
+ * @fn ASTNode* create_string_node(const char* value)
  * @brief Function that creates a string literal node
  * 
  * Node type is set to AST_STRING, and the Float struct's `number` field
@@ -244,49 +300,47 @@ ASTNode* create_f64_node(double value);
  * @param[in] value The integer value
  * @return Returns pointer to ASTNode or NULL if memory allocation failed
  */
-ASTNode* create_string_node(char* value);
+ASTNode* create_string_node(const char* value);
 
 /**
  * @fn ASTNode* create_program_node()
  * @brief Function that creates program (root) node for AST
  *  
  * Node type is set to AST_PROGRAM, Program structs values are set to default values
- * (has prolog = false, declaration count = 0) and array of declaration pointers is 
- * pre-allocated for DEFAULT_PROGRAM_DECL_CNT nodes. Decalaration capacity is set 
- * to the same value and all pointers to declaration nodes are set to NULL.
+ * (declaration count = 0). Declarations are stored in ast_children once the list
+ * is closed by close_child_list().
  *  
  * @return Returns pointer to ASTNode or null if memory allocation failed
 */
 ASTNode* create_program_node();
 
 /**
- * @fn ASTNode* create_fn_decl_node(char* fn_name)
+ * @fn ASTNode* create_fn_decl_node(const char* fn_name)
  * @brief Function that creates function declaration node
  * 
  * Node type is set to AST_FN_DECL, Function declaration struct values are set to default
- * (return type = unspecified, block = NULL) and array of parameter pointers is pre-allocated for
- * DEFAULT_FN_PARAM_CNT nodes. Parameter capacity is set to the same value and all
- * pointers to parameter nodes are set to NULL.
- * Memory is allocated for fn_name using strdup (must be freed later).
+ * (return type = unspecified, block = NULL, parameter count = 0). Parameters are stored
+ * in ast_children once the list is closed by close_child_list().
+ * fn_name has to be interned (see intern.h), node only stores the pointer.
  * 
  * @param[in] fn_name Name of the function (identifier)
  * @return Returns pointer to ASTNode or null if memory allocation failed
 */
-ASTNode* create_fn_decl_node(char* fn_name);
+ASTNode* create_fn_decl_node(const char* fn_name);
 
 /**
- * @fn ASTNode* create_param_node(DataType data_type, char* identifier)
+ * @fn ASTNode* create_param_node(DataType data_type, const char* identifier)
  * @brief Function that creates parameter node
  * 
  * Node type is set to AST_PARAM, Parameter struct values are set 
- * based on the arguments (data_type, identifier). Memory is allocated
- * for idnetifier using strdup (must be freed later).
+ * based on the arguments (data_type, identifier). Identifier has to be
+ * interned (see intern.h).
  * 
  * @param[in] data_type Data type of the identifier
  * @param[in] identifier Name of the variable (identifier)
  * @return Returns pointer to ASTNode or null if memory allocation failed
 */
-ASTNode* create_param_node(DataType data_type, char* identifier);
+ASTNode* create_param_node(DataType data_type, const char* identifier);
 
 /**
  * @fn ASTNode* create_return_node()
@@ -299,41 +353,40 @@ ASTNode* create_param_node(DataType data_type, char* identifier);
 ASTNode* create_return_node();
 
 /**
- * @fn ASTNode* create_var_decl_node(DataType data_type, char* var_name)
+ * @fn ASTNode* create_var_decl_node(DataType data_type, const char* var_name)
  * @brief Function that creates variable declaration node
  * 
  * Node type is set to AST_VAR_DECL, Variable declaration struct values are
  * set based on arguemnts (data_type, var_name) and expression pointer is set
- * to default (NULL). Memory is allocated for var_name using strdup (must be freed later).
+ * to default (NULL). var_name has to be interned (see intern.h).
  * 
  * @param[in] data_type Data type of the variable
  * @param[in] var_name Variable identifier
  * @return Returns pointer to ASTNode or null if memory allocation failed
 */
-ASTNode* create_var_decl_node(DataType data_type, char* var_name);
+ASTNode* create_var_decl_node(DataType data_type, const char* var_name);
 
 /**
- * @fn ASTNode* create_const_decl_node(DataType data_type, char* const_name)
+ * @fn ASTNode* create_const_decl_node(DataType data_type, const char* const_name)
  * @brief Function that creates constant declaration node
  * 
  * Node type is set to AST_CONST_DECL, Constant declaration struct values are
  * set based on arguemnts (data_type, const_name) and expression pointer is set
- * to default (NULL). Memory is allocated for const_name using strdup (must be freed later).
+ * to default (NULL). const_name has to be interned (see intern.h).
  * 
  * @param[in] data_type Data type of the constant
  * @param[in] var_name Constant identifier
  * @return Returns pointer to ASTNode or null if memory allocation failed
 */
-ASTNode* create_const_decl_node(DataType data_type, char* const_name);
+ASTNode* create_const_decl_node(DataType data_type, const char* const_name);
 
 /**
  * @fn ASTNode* create_block_node()
  * @brief Function that creates block node
  * 
  * Node type is set to AST_BLOCK, Block struct values are
- * set to default (node_count = 0), memory is preallocated for
- * DEFAULT_BLOCK_NODE_COUNT nodes (can be re-allocated later) and all
- * pointers are set to NULL.
+ * set to default (node_count = 0). Nodes are stored in ast_children
+ * once the list is closed by close_child_list().
  * 
  * @return Returns pointer to ASTNode or null if memory allocation failed
 */
@@ -362,18 +415,17 @@ ASTNode* create_while_node();
 ASTNode* create_if_node();
 
 /**
- * @fn ASTNode* create_fn_call_node(char* fn_name)
+ * @fn ASTNode* create_fn_call_node(const char* fn_name)
  * @brief Function that creates fn call node
  * 
  * Node type is set to AST_FN_CALL, Function call struct values
- * are set to default, memory is pre-allocated for argument array and capacity
- * is set to DEFAULT_FN_ARG_CNT. Memory for function name is allocaetd using strdup
- * (must be freed later). All pointers are set to NULL.
+ * are set to default (argument count = 0). Arguments are stored in ast_children
+ * once the list is closed by close_child_list(). Function name has to be interned (see intern.h).
  * 
  * @param[in] fn_name Identifier of the function
  * @return Returns pointer to ASTNode or null if memory allocation failed
 */
-ASTNode* create_fn_call_node(char* fn_name);
+ASTNode* create_fn_call_node(const char* fn_name);
 
 /**
  * @fn ASTNode* create_arg_node()
@@ -392,24 +444,37 @@ ASTNode* create_arg_node();
 */
 
 /**
- * @fn void free_ast_node(ASTNode* node)
- * @brief Function that frees memory for all child node of node passed as an argument
- * 
- * This function deletes all nodes based on their types recursively,
- * function uses switch statement to switch between different node types
- * and frees coresponding structs within nodes based on the node type.
- * 
- * @param[in, out] node pointer to a node
+ * @var Arena ast_arena
+ * @brief Arena that owns all nodes and strings of the AST.
+*/
+extern Arena ast_arena;
+
+/**
+ * @fn char* ast_strdup(const char* str)
+ * @brief Copies string into the AST arena
+ *
+ * @param[in] str String to copy
+ * @return Pointer to the copy or NULL if allocation failed
+*/
+char* ast_strdup(const char* str);
+
+/**
+ * @fn void free_ast(void)
+ * @brief Frees memory of all nodes of the AST at once
+ *
+ * Nodes are never freed one by one, nodes of subtrees discarded after
+ * syntax error stay in the arena until this function is called. Child lists
+ * in ast_children are freed as well.
+ *
  * @return void
 */
-void free_ast_node(ASTNode* node);
+void free_ast(void);
 
 /**
  * @fn int append_decl_to_prog(ASTNode* program_node, ASTNode* decl_node)
  * @brief Function that appends declaratio node into program_node declaration array
  * 
- * Functions reallocates memory for pointer array of declarations inside program node
- * if declaration count reaches declaration capacity and appends new declaration into array.
+ * Declaration is pushed on top of the open child lists, see close_child_list().
  * 
  * @param[in, out] program_node Pointer to a program node
  * @param[in] decl_node Pointer to a declaration node
@@ -421,8 +486,7 @@ int append_decl_to_prog(ASTNode* program_node, ASTNode* decl_node);
  * @fn int append_param_to_fn(ASTNode* fn_node, ASTNode* param_node)
  * @brief Function that appends declaratio node into program_node declaration array
  * 
- * Functions reallocates memory for pointer array of parameters inside function declaration node
- * if parameter count reaches parameter capacity and appends new parameter into array.
+ * Parameter is pushed on top of the open child lists, see close_child_list().
  * 
  * @param[in, out] fn_node Pointer to a function declaration node
  * @param[in] param_node Pointer to a parameter node
@@ -434,8 +498,7 @@ int append_param_to_fn(ASTNode* fn_node, ASTNode* param_node);
  * @fn int append_node_to_block(ASTNode* block, ASTNode* node)
  * @brief Function that appends node to block node
  * 
- * Functions reallocates memory for pointer array of nodes inside block node
- * if node count reaches node capacity and appends new node into array.
+ * Node is pushed on top of the open child lists, see close_child_list().
  * 
  * @param[in, out] block Pointer to a block node
  * @param[in] node Pointer to a node
@@ -447,8 +510,7 @@ int append_node_to_block(ASTNode* block, ASTNode* node);
  * @fn int append_arg_to_fn(ASTNode* fn_node, ASTNode* arg_node)
  * @brief Function that appends argument node to function node
  * 
- * Functions reallocates memory for pointer array of nodes inside fn_call node
- * if node count reaches node capacity and appends new node into array.
+ * Argument is pushed on top of the open child lists, see close_child_list().
  * 
  * @param[in, out] fn_node Pointer to a fn call node
  * @param[in] arg_node Pointer to an argument node
@@ -456,4 +518,18 @@ int append_node_to_block(ASTNode* block, ASTNode* node);
 */
 int append_arg_to_fn(ASTNode* fn_node, ASTNode* arg_node);
 
+/**
+ * @fn int close_child_list(ASTNode* node)
+ * @brief Moves children of the node (program, function declaration, block or fn call) into ast_children
+ *
+ * Children appended by append_* functions are kept on a stack of open lists, list
+ * of a nested node is always closed before its parent gets another child, so the
+ * children of the node are on top of the stack. They are moved into ast_children
+ * as one contiguous range and the node stores index of the first one.
+ *
+ * @param[in, out] node Pointer to a node with child list
+ * @return 0 if success, otherwise return 1
+*/
+int close_child_list(ASTNode* node);
+
 #endif // AST_H
@@ -29,8 +29,11 @@ typedef enum {
 /**
  * @var ErrorType error_tracker
  * @brief Global variable across all files to keep track of different error types
+ *
+ * Every thread has its own tracker, lexer threads of tokenize_parallel()
+ * do not interfere with the main thread.
 */
-extern ErrorType error_tracker;
+extern _Thread_local ErrorType error_tracker;
 
 /**
  * @fn set_error(ErrorType error)
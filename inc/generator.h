@@ -21,6 +21,13 @@
  * @return 0 on success, non-zero on failure.
  */
 int generate_code(ASTNode* root);
+
+/**
+ * @brief Generates code for an AST node and all its children.
+ * @param node The AST node to generate code for.
+ */
+void generate_code_in_node(ASTNode* node);
+
 /**
  * @brief Generates code for assignment statements.
  * @param node The AST node representing the assignment.
@@ -71,7 +78,7 @@ int while_stack_size();
 
 /**
  * @brief Retrieves the identifier of the while loop at a specific index in the stack.
- * @param index The index of the desired while loop (0 is the bottom of the stack).
+ * @param index The index of the desired while loop (0 is the top of the stack).
  * @return The identifier of the while loop at the specified index.
  */
 int get_while_at_index(int index);
@@ -90,18 +97,19 @@ void increment_tmp_counter();
 
 
 /**
- * @brief Structure representing a node in the while loop stack.
+ * @brief Context of one while loop that is being generated.
  */
-typedef struct WhileStackNode {
+typedef struct LoopContext {
     int while_number;                  ///< Unique identifier for the while loop.
-    struct WhileStackNode *next;       ///< Pointer to the next node in the stack.
-} WhileStackNode;
+} LoopContext;
 
 /**
  * @brief Structure representing the stack of while loops.
  */
 typedef struct WhileStack {
-    WhileStackNode *top;               ///< Pointer to the top of the stack.
+    LoopContext *loops;                ///< Array of loop contexts, the last one is the innermost loop.
+    int size;                          ///< Number of loops in the stack.
+    int capacity;                      ///< Allocated capacity of the loops array.
 } WhileStack;
 
 /**
@@ -128,6 +136,11 @@ bool is_it_local(const char* var_name);
  */
 void add_to_local(const char* var_name);
 
+/**
+ * @brief Emits DEFVAR for every variable added to the local frame of the current function.
+ */
+void def_local_frame();
+
 /**
  * @brief Error handler for the generator.
  */
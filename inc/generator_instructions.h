@@ -9,33 +9,88 @@
 #include "ast.h"
 #include "error.h"
 #include "generator.h"
+#include "ir.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 /**
- * Escapes special characters in a string (e.g., newline, tab) to ensure proper formatting in IFJcode24.
- * @param input Original string.
- * @return Escaped string.
+ * Appends an instruction to the instruction list (see ir.h), operands are appended by the operand_* functions.
+ * @param opcode Opcode of the instruction.
  */
-char* escape_string(const char* input);
+void instruction(IROpcode opcode);
 
 /**
- * Determines the frame prefix (GF, LF, or TF) based on variable scoping.
- * @param var Name of the variable.
- * @return The frame prefix as a string.
+ * Appends a variable operand (variables are always in the local frame).
+ * @param var Interned name of the variable.
  */
-const char* frame_prefix(const char* var);
+void operand_var(const char* var);
 
 /**
- * Prints text with appropriate indentation for better readability in debugging.
+ * Appends an integer constant operand.
+ * @param value Value of the constant.
+ */
+void operand_int(long long value);
+
+/**
+ * Appends a float constant operand.
+ * @param value Value of the constant.
+ */
+void operand_float(double value);
+
+/**
+ * Appends a string constant operand, special characters (e.g., newline, space) are escaped when the code is written.
+ * @param string Original string, it is not copied.
+ */
+void operand_string(const char* string);
+
+/**
+ * Appends a bool constant operand.
+ * @param value Value of the constant.
+ */
+void operand_bool(bool value);
+
+/**
+ * Appends the nil@nil operand.
+ */
+void operand_nil();
+
+/**
+ * Appends a type operand of READ.
+ * @param type The type.
+ */
+void operand_type(IRType type);
+
+/**
+ * Appends a label or function name operand.
+ * @param name Name of the label.
+ */
+void operand_name(const char* name);
+
+/**
+ * Appends a label operand made of a prefix and a unique number.
+ * @param prefix Name of the label without the number, it is not copied.
+ * @param number Unique number of the label.
+ */
+void operand_label(const char* prefix, int number);
+
+/**
+ * Builds the name of a temporary variable from a prefix and a unique number.
+ * @param prefix Name of the variable without the number.
+ * @param number Unique number of the variable.
+ * @return Interned name of the variable.
+ */
+const char* temp_name(const char* prefix, int number);
+
+/**
+ * Appends text with appropriate indentation for better readability in debugging.
  * @param text The text to be printed.
  */
 void print_with_indent(const char* text);
 
 /**
- * Prints a newline character in the generated code.
+ * Appends an empty line to the generated code.
  */
 void print_new_line();
 
@@ -61,7 +116,7 @@ void gen_push_frame();
 void gen_pop_frame();
 
 /**
- * Declares a variable in the current frame.
+ * Declares a variable in the current frame, its DEFVAR is emitted at the function entry.
  * @param var Name of the variable to be declared.
  */
 void def_var(const char* var);
@@ -92,23 +147,23 @@ void pops(const char* var);
 /**
  * Generates an AND operation between two symbols and stores the result in a variable.
  * @param var The result variable.
- * @param symb1 The first operand.
- * @param symb2 The second operand.
+ * @param symb1 The first operand variable.
+ * @param symb2 The second operand variable.
  */
 void and(const char* var, const char* symb1, const char* symb2);
 
 /**
  * Generates an OR operation between two symbols and stores the result in a variable.
  * @param var The result variable.
- * @param symb1 The first operand.
- * @param symb2 The second operand.
+ * @param symb1 The first operand variable.
+ * @param symb2 The second operand variable.
  */
 void or(const char* var, const char* symb1, const char* symb2);
 
 /**
  * Generates a NOT operation on a symbol and stores the result in a variable.
  * @param var The result variable.
- * @param symb The operand.
+ * @param symb The operand variable.
  */
 void not(const char* var, const char* symb);
 
@@ -123,7 +178,7 @@ void concat(const char* var, const char* symb1, const char* symb2);
 /**
  * Determines the type of a symbol (e.g., int, float, string) and stores it in a variable.
  * @param var The result variable to store the type.
- * @param symb The symbol to determine the type of.
+ * @param symb The variable to determine the type of.
  */
 void type(const char* var, const char* symb);
 
@@ -0,0 +1,60 @@
+/**
+ * @file intern.h
+ * @brief Contains declarations of the string intern pool
+ * @authors Michal Repcik (xrepcim00)
+ *
+ * Every distinct identifier is stored only once, interned strings are equal
+ * if and only if their pointers are equal. Hash and length of the string are
+ * stored in front of it, so tables keyed by interned names never rehash strings.
+*/
+
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @struct InternHeader
+ * @brief Header stored right before every interned string.
+*/
+typedef struct {
+    uint32_t hash;      ///< Hash of the string.
+    uint32_t length;    ///< Length of the string (without null terminator).
+} InternHeader;
+
+/**
+ * @fn const char* intern(const char* str, size_t len)
+ * @brief Returns unique null terminated copy of the first len characters of str.
+ *
+ * Calls exit(INTERNAL_ERROR) when memory allocation fails.
+ *
+ * @param[in] str String (does not have to be null terminated)
+ * @param[in] len Length of the string
+ * @return Pointer to interned string, valid until free_interns() is called
+*/
+const char* intern(const char* str, size_t len);
+
+/**
+ * @fn void free_interns(void)
+ * @brief Frees all interned strings and the pool itself.
+ *
+ * @return void
+*/
+void free_interns(void);
+
+/**
+ * @brief Returns precomputed hash of interned string.
+*/
+static inline uint32_t intern_hash(const char* name) {
+    return ((const InternHeader*)name - 1)->hash;
+}
+
+/**
+ * @brief Returns length of interned string.
+*/
+static inline size_t intern_length(const char* name) {
+    return ((const InternHeader*)name - 1)->length;
+}
+
+#endif // INTERN_H
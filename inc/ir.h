@@ -0,0 +1,235 @@
+/**
+ * @file ir.h
+ * @brief Contains declaration of the in-memory IFJcode24 instruction list
+ * @authors Michal Repcik (xrepcim00)
+ *
+ * Generator appends instructions to one growing array instead of printing
+ * them, later passes can inspect and rewrite the list and write_ir() turns
+ * it into text at the end. Instructions are 16 bytes, operands are small
+ * values or indices into pools of names, floats and strings.
+*/
+
+#ifndef IR_H
+#define IR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "arena.h"
+
+#define IR_MAX_OPERANDS 3 ///< Maximum number of operands of an instruction.
+
+/**
+ * @enum IROpcode
+ * @brief Opcodes of IFJcode24 and pseudo instructions of the listing.
+*/
+typedef enum {
+    IR_HEADER,          ///< '.IFJcode24' header line
+    IR_BLANK,           ///< Empty line
+    IR_TEXT,            ///< Indented verbatim text (string operand)
+    IR_MOVE,
+    IR_CREATEFRAME,
+    IR_PUSHFRAME,
+    IR_POPFRAME,
+    IR_DEFVAR,
+    IR_CALL,
+    IR_RETURN,
+    IR_PUSHS,
+    IR_POPS,
+    IR_CLEARS,
+    IR_ADD,
+    IR_SUB,
+    IR_MUL,
+    IR_DIV,
+    IR_IDIV,
+    IR_ADDS,
+    IR_SUBS,
+    IR_MULS,
+    IR_DIVS,
+    IR_IDIVS,
+    IR_LT,
+    IR_GT,
+    IR_EQ,
+    IR_LTS,
+    IR_GTS,
+    IR_EQS,
+    IR_AND,
+    IR_OR,
+    IR_NOT,
+    IR_ANDS,
+    IR_ORS,
+    IR_NOTS,
+    IR_INT2FLOAT,
+    IR_FLOAT2INT,
+    IR_INT2CHAR,
+    IR_STRI2INT,
+    IR_INT2FLOATS,
+    IR_FLOAT2INTS,
+    IR_INT2CHARS,
+    IR_STRI2INTS,
+    IR_READ,
+    IR_WRITE,
+    IR_CONCAT,
+    IR_STRLEN,
+    IR_GETCHAR,
+    IR_SETCHAR,
+    IR_TYPE,
+    IR_LABEL,
+    IR_JUMP,
+    IR_JUMPIFEQ,
+    IR_JUMPIFNEQ,
+    IR_JUMPIFEQS,
+    IR_JUMPIFNEQS,
+    IR_EXIT,
+    IR_BREAK,
+    IR_DPRINT,
+    IR_OPCODE_COUNT     ///< Number of opcodes
+} IROpcode;
+
+/**
+ * @enum IROperandKind
+ * @brief Kind of an operand, decides meaning of its value.
+*/
+typedef enum {
+    IR_OPERAND_VAR,     ///< Variable in the local frame, value is index into names
+    IR_OPERAND_LABEL,   ///< Label or function, value is index into names
+    IR_OPERAND_NUMBERED_LABEL, ///< Label made of a prefix and a number, value is index into labels
+    IR_OPERAND_INT,     ///< Integer constant, value is the number
+    IR_OPERAND_FLOAT,   ///< Float constant, value is index into floats
+    IR_OPERAND_STRING,  ///< String constant (not escaped), value is index into strings
+    IR_OPERAND_BOOL,    ///< Bool constant, value is 0 or 1
+    IR_OPERAND_NIL,     ///< nil@nil, value is not used
+    IR_OPERAND_TYPE     ///< Type operand of READ, value is IRType
+} IROperandKind;
+
+/**
+ * @enum IRType
+ * @brief Type operand of READ.
+*/
+typedef enum {
+    IR_TYPE_INT,
+    IR_TYPE_FLOAT,
+    IR_TYPE_STRING,
+    IR_TYPE_BOOL
+} IRType;
+
+/**
+ * @struct IRInstruction
+ * @brief One instruction of the listing.
+*/
+typedef struct {
+    uint8_t opcode;                         ///< IROpcode
+    uint8_t operand_count;                  ///< Number of used operands
+    uint16_t kinds;                         ///< IROperandKind of every operand, 4 bits each (see ir_kind())
+    int32_t values[IR_MAX_OPERANDS];        ///< Values of operands, see IROperandKind
+} IRInstruction;
+
+/**
+ * @brief Returns kind of i-th operand of the instruction.
+*/
+static inline IROperandKind ir_kind(const IRInstruction* instruction, int i) {
+    return (IROperandKind)((instruction->kinds >> (4 * i)) & 0xf);
+}
+
+/**
+ * @struct IRLabel
+ * @brief Numbered label, kept apart so that labels are not built and interned during generation.
+*/
+typedef struct {
+    const char* prefix;         ///< Name of the label without the number, string literal of the generator
+    int32_t number;             ///< Unique number of the label
+} IRLabel;
+
+/**
+ * @struct IRProgram
+ * @brief Instruction list with pools of operand values.
+*/
+typedef struct {
+    IRInstruction* code;        ///< Instructions in program order
+    size_t count;               ///< Number of instructions
+    size_t capacity;            ///< Capacity of code
+    const char** names;         ///< Interned names of variables and labels by index
+    int name_count;             ///< Number of names
+    int name_capacity;          ///< Capacity of names
+    int* name_slots;            ///< Open addressing map of interned name to index + 1, 0 for empty slot
+    int slot_capacity;          ///< Number of slots, always power of two
+    double* floats;             ///< Float constants by index
+    int float_count;            ///< Number of float constants
+    int float_capacity;         ///< Capacity of floats
+    const char** strings;       ///< String constants by index, owned by the AST
+    int string_count;           ///< Number of string constants
+    int string_capacity;        ///< Capacity of strings
+    IRLabel* labels;            ///< Numbered labels by index
+    int label_count;            ///< Number of numbered labels
+    int label_capacity;         ///< Capacity of labels
+    Arena arena;                ///< Strings created by passes over the program
+} IRProgram;
+
+/**
+ * @var IRProgram ir
+ * @brief Program that is being generated.
+*/
+extern IRProgram ir;
+
+/**
+ * @fn void init_ir(void)
+ * @brief Starts an empty program.
+*/
+void init_ir(void);
+
+/**
+ * @fn void free_ir(void)
+ * @brief Frees the program and all its pools.
+*/
+void free_ir(void);
+
+/**
+ * @fn void ir_instruction(IROpcode opcode)
+ * @brief Appends instruction without operands.
+*/
+void ir_instruction(IROpcode opcode);
+
+/**
+ * @fn void ir_operand(IROperandKind kind, int32_t value)
+ * @brief Appends operand to the last instruction.
+*/
+void ir_operand(IROperandKind kind, int32_t value);
+
+/**
+ * @fn int32_t ir_name(const char* name)
+ * @brief Returns index of interned name, adds it to the pool if it is not there yet.
+*/
+int32_t ir_name(const char* name);
+
+/**
+ * @fn int32_t ir_float(double value)
+ * @brief Adds float constant to the pool and returns its index.
+*/
+int32_t ir_float(double value);
+
+/**
+ * @fn int32_t ir_string(const char* string)
+ * @brief Adds string constant to the pool and returns its index, string is not copied.
+*/
+int32_t ir_string(const char* string);
+
+/**
+ * @fn char* ir_string_buffer(size_t length)
+ * @brief Allocates string of length characters (and null terminator) freed together with the program.
+*/
+char* ir_string_buffer(size_t length);
+
+/**
+ * @fn int32_t ir_label(const char* prefix, int32_t number)
+ * @brief Adds numbered label to the pool and returns its index, prefix is not copied.
+*/
+int32_t ir_label(const char* prefix, int32_t number);
+
+/**
+ * @fn void write_ir(void)
+ * @brief Writes the program as IFJcode24 text through the writer (see writer.h).
+*/
+void write_ir(void);
+
+#endif // IR_H
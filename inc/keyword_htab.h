@@ -1,124 +1,56 @@
 /**
  * @file keyword_htab.h
- * @brief Header file containing implementation of hash table for keyword tokens
+ * @brief Header file containing perfect hash table for keyword tokens
  * @authors Michal Repcik (xrepcim00)
+ *
+ * Table is generated by tools/gen_keyword_hash.c into keyword_table.h,
+ * run 'make keywords' after changing the keyword set.
 */
 
 #ifndef KEYWORD_HTAB_H
 #define KEYWORD_HTAB_H
 
-#include <stdio.h>
-#include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 
 #include "token.h"
 
-#define OPTIMAL_SIZE 113 ///< Optimal size to ensure perfect hashing and O(1) complexity for keywords.
-
 /**
- * @struct KeywordHtabItem
+ * @struct KeywordEntry
  * @brief Struct containing a keyword and its corresponding token.
  * 
- * This structure represents a single entry in the keyword hash table,
- * mapping a valid keyword to its associated token type.
+ * This structure represents a single slot in the keyword hash table,
+ * empty slots have zero length.
 */
 typedef struct {
     const char* keyword;         ///< Valid keyword string.
+    size_t length;               ///< Length of the keyword.
     TokenType keyword_token;     ///< Token for the given keyword.
-} KeywordHtabItem;
-
-/**
- * @struct KeywordHtab
- * @brief Struct containing items and size of the hash table.
- * 
- * This structure represents the keyword hash table, which stores 
- * keywords and their corresponding token types for efficient lookup.
-*/
-typedef struct {
-    int size;                    ///< Number of buckets (total number of items).
-    KeywordHtabItem* items;      ///< Pointer to the array of items in the hash table.
-} KeywordHtab;
-
-
-/**
- * @fn KeywordHtab* create_keyword_htab(int size)
- * @brief Allocates memory for hash table, items and initializes size.
- * 
- * @param[in] size Number of items
- * @return Returns pointer to KeywordHtab
-*/
-KeywordHtab* create_keyword_htab(int size);
-
-/**
- * @fn void destroy_keyword_htab(KeywordHtab* htab)
- * @brief Frees all memory previoulsy allocated by create_keyword_htab function.
- * 
- * @param[in, out] htab pointer to a hash table
- * @return void
-*/
-void destroy_keyword_htab(KeywordHtab* htab);
-
-/**
- * @fn void init_keyword_htab(KeywordHtab* htab)
- * @brief Initializes hash table with all valid keywords.
- * 
- * @param[in, out] htab pointer to a hash table
- * @return void
-*/
-void init_keyword_htab(KeywordHtab* htab);
+} KeywordEntry;
 
-/**
- * @fn int insert_keyword_htab(KeywordHtab* htab, const char* keyword, TokenType token)
- * @brief Inserts keyword with coresponding token into hash table. 
- * 
- * @param[in, out] htab pointer to a hash table
- * @param keyword Keyword to be inserted into hash table (used as key)
- * @param token Tpye of token that matches the keyword
- * @return Returns 0 if everything went succesfully, otherwise returns -1
- * 
- * @note Memory is allocated in this function using strdup and potentially malloc (memory is freed
- * in destroy_keyword_htab function). This funcition does not take into account already existing items,
- * since main goal of the hash table is to ensure 0(1) complexity for keyword lookups. To prevent overwriting, 
- * increase OPTIMAL_SIZE constant or use different algorithm for hash_keyword function.
-*/
-int insert_keyword_htab(KeywordHtab* htab, const char* keyword, TokenType token);
+#include "keyword_table.h"
 
 /**
- * @fn inline unsigned long hash_keyword(const char* str)
- * @brief Implementation of djb2 hashing algorithm.
- * 
- * @param str String used as key for hashing
- * @return Returns hash as unsigned long
- * 
- * @note Function is inlined to prevent function call overhead.
-*/
-inline unsigned long hash_keyword(const char* str) {
-    unsigned long hash = 5381;
-    int c;
-
-    while ((c = *str++)) {
-        hash = ((hash << 5) + hash) + c;
-    }
-    return hash;
-}
-
-/**
- * @fn inline TokenType find_keyword(KeywordHtab* htab, const char* keyword)
+ * @fn static inline TokenType find_keyword(const char* keyword, size_t len)
  * @brief Tries to find given keyword inside hash table.
  * 
- * @param keyword Keyword to be found
- * @return Returns either corresponding token or token for identifiers
+ * Every keyword has its own slot, so non keywords are rejected after
+ * at most one length check and one comparison.
  * 
- * @note Function is inlined to prevent function call overhead.
+ * @param keyword Keyword to be found (does not have to be null terminated)
+ * @param len Length of the keyword
+ * @return Returns either corresponding token or token for identifiers
 */
-inline TokenType find_keyword(KeywordHtab* htab, const char* keyword) {
-    unsigned long hash = hash_keyword(keyword);
-    int idx = hash % htab->size;
+static inline TokenType find_keyword(const char* keyword, size_t len) {
+    if (len < KEYWORD_MIN_LEN || len > KEYWORD_MAX_LEN) {
+        return TOKEN_IDENTIFIER;
+    }
+    unsigned idx = ((unsigned char)keyword[0] * KEYWORD_HASH_A +
+                    (unsigned char)keyword[len - 1] * KEYWORD_HASH_B + (unsigned)len) & (KEYWORD_TABLE_SIZE - 1);
+    const KeywordEntry* entry = &keyword_table[idx];
 
-    if (htab->items[idx].keyword != NULL) {
-        if (strcmp(htab->items[idx].keyword, keyword) == 0) {
-            return htab->items[idx].keyword_token;
-        }
+    if (entry->length == len && memcmp(entry->keyword, keyword, len) == 0) {
+        return entry->keyword_token;
     }
     return TOKEN_IDENTIFIER;
 }
@@ -0,0 +1,42 @@
+/* Generated by tools/gen_keyword_hash.c (make keywords), do not edit. */
+
+#define KEYWORD_HASH_A 1 ///< Multiplier of the first character.
+#define KEYWORD_HASH_B 22 ///< Multiplier of the last character.
+#define KEYWORD_TABLE_SIZE 32 ///< Number of slots in keyword table.
+#define KEYWORD_MIN_LEN 2 ///< Length of the shortest keyword.
+#define KEYWORD_MAX_LEN 6 ///< Length of the longest keyword.
+
+static const KeywordEntry keyword_table[KEYWORD_TABLE_SIZE] = {
+    {"const", 5, TOKEN_CONST},
+    {"f64", 3, TOKEN_F64},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"var", 3, TOKEN_VAR},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"u8", 2, TOKEN_U8},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"while", 5, TOKEN_WHILE},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"return", 6, TOKEN_RETURN},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"if", 2, TOKEN_IF},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"void", 4, TOKEN_VOID},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"else", 4, TOKEN_ELSE},
+    {"i32", 3, TOKEN_I32},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"null", 4, TOKEN_NULL},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"fn", 2, TOKEN_FN},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"", 0, TOKEN_IDENTIFIER},
+    {"pub", 3, TOKEN_PUB},
+};
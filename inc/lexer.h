@@ -9,6 +9,8 @@
 
 #include <stdio.h>
 #include "token.h"
+#include "source.h"
+#include "token_stream.h"
 #include "ascii_lookup.h"
 #include "keyword_htab.h"
 
@@ -50,12 +52,15 @@ typedef enum {
  * context information used for code tokeniziation.
 */
 typedef struct {
-    FILE* src;                     ///< Pointer to the source file or stdin.
+    SourceBuffer src;              ///< Contents of the source file or stdin.
     LookupTable ascii_l_table;     ///< Lookup table for validating ASCII characters.
-    KeywordHtab* keyword_htab;     ///< Hash table for fast keyword access.
     LexerState state;              ///< Current state of the lexer.
-    char* buff;                    ///< Buffer that holds the value of the last created token.
+    uint32_t line;                 ///< Current line in the source (starting from 1).
+    size_t line_start;             ///< Offset of the first character of the current line.
+    char* buff;                    ///< Buffer that holds the last value materialized by token_text.
     int buff_len;                  ///< Length of the buffer.
+    TokenStream tokens;            ///< Tokens of the whole source (empty unless tokenize was called).
+    size_t token_pos;              ///< Index of the next token in tokens.
 } Lexer;
 
 /**
@@ -71,7 +76,7 @@ int init_lexer(Lexer* lexer, FILE* fp);
 
 /**
  * @fn destroy_lexer(Lexer* lexer)
- * @brief Closes src, destroys keyword_htab, frees buffer and sets all pointers to NULL.
+ * @brief Releases src, frees buffer and sets all pointers to NULL.
  * 
  * @param[in, out] lexer Pointer to a lexer struct
  * @return void
@@ -79,12 +84,65 @@ int init_lexer(Lexer* lexer, FILE* fp);
 void destroy_lexer(Lexer* lexer);
 
 /**
- * @fn Token* get_token(Lexer* lexer)
+ * @fn Token get_token(Lexer* lexer)
  * @brief Scans source code and extracts tokens using FSM.
  *
  * @param[in, out] lexer Pointer to lexer struct
- * @return Pointer to a token struct or NULL if the token is invalid (Lexical error)
+ * @return Token referencing its value in the source, token type is set to
+ * INVALID if the token is invalid (Lexical error)
 */
-Token* get_token(Lexer* lexer);
+Token get_token(Lexer* lexer);
+
+/**
+ * @fn int tokenize(Lexer* lexer)
+ * @brief Scans whole source into the token stream of the lexer.
+ *
+ * Scanning stops after TOKEN_EOF or the first INVALID token, tokens are
+ * then read by advance_token() by index instead of calling get_token().
+ * Lexical error is not set here but when the parser reaches the invalid
+ * token, so errors are reported in the same order as without the pre-pass.
+ *
+ * @param[in, out] lexer Pointer to lexer struct
+ * @return Returns 0 when everything went succesfully, otherwise returns -1
+*/
+int tokenize(Lexer* lexer);
+
+/**
+ * @fn int tokenize_parallel(Lexer* lexer, int threads)
+ * @brief Scans whole source into the token stream of the lexer using multiple threads.
+ *
+ * Source is split into chunks at new lines and chunks are lexed concurrently,
+ * resulting token stream is identical to the one produced by tokenize().
+ * Small sources are tokenized sequentially.
+ *
+ * @param[in, out] lexer Pointer to lexer struct
+ * @param[in] threads Maximum number of threads (including the calling one)
+ * @return Returns 0 when everything went succesfully, otherwise returns -1
+*/
+int tokenize_parallel(Lexer* lexer, int threads);
+
+/**
+ * @fn const char* token_text(Lexer* lexer, const Token* token)
+ * @brief Materializes value of the token as null terminated string.
+ *
+ * Value is copied into the lexer buffer, multi line strings are decoded.
+ *
+ * @param[in, out] lexer Pointer to lexer struct that produced the token
+ * @param[in] token Pointer to a token
+ * @return Pointer to the value, valid until next call of this function
+*/
+const char* token_text(Lexer* lexer, const Token* token);
+
+/**
+ * @fn const char* token_intern(Lexer* lexer, const Token* token)
+ * @brief Interns value of the token straight from the source.
+ *
+ * Identifiers are compared by pointer from here on, see intern.h.
+ *
+ * @param[in, out] lexer Pointer to lexer struct that produced the token
+ * @param[in] token Pointer to a token
+ * @return Pointer to interned value, valid until free_interns() is called
+*/
+const char* token_intern(Lexer* lexer, const Token* token);
 
 #endif // LEXER_H
@@ -0,0 +1,99 @@
+/**
+ * @file lexer_dfa.h
+ * @brief Contains constants shared by the table driven lexer and its table generator
+ * @authors Michal Repcik (xrepcim00)
+ *
+ * Table driven lexer is an alternative implementation of get_token() selected
+ * by building with LEXER=dfa. Transition table is generated at build time by
+ * tools/gen_lexer_dfa.c into lexer_dfa_table.h.
+*/
+
+#ifndef LEXER_DFA_H
+#define LEXER_DFA_H
+
+#include "lexer.h"
+
+#define DFA_STATE_BITS 5                            ///< Number of bits used for state in table entry.
+#define DFA_STATE_MASK ((1 << DFA_STATE_BITS) - 1)  ///< Mask for state in table entry.
+
+/**
+ * @enum DfaState
+ * @brief Additional states of the DFA.
+ *
+ * DFA uses all states from LexerState, counters from the FSM are expanded
+ * into additional states. HEX_NUM is used as the state for the first
+ * hexadecimal digit and IMPORT as the state before first character of the directive.
+*/
+typedef enum {
+    DFA_IMPORT1 = IMPORT + 1,   ///< One character of the directive read.
+    DFA_IMPORT2,                ///< Two characters of the directive read.
+    DFA_IMPORT3,                ///< Three characters of the directive read.
+    DFA_IMPORT4,                ///< Four characters of the directive read.
+    DFA_IMPORT5,                ///< Five characters of the directive read.
+    DFA_HEX2,                   ///< Second hexadecimal digit of '\xdd' esc sequence.
+    DFA_STRING_X,               ///< String literal after '\xdd' esc sequence.
+    DFA_ESC_SEQ_X,              ///< Escape sequence after '\xdd' esc sequence.
+    DFA_HEX_DEAD,               ///< Another '\x' in the same string, always invalid.
+    DFA_STATE_COUNT             ///< Number of DFA states.
+} DfaState;
+
+/**
+ * @enum DfaClass
+ * @brief Character classes, all characters in a class behave the same in every state.
+*/
+typedef enum {
+    CLS_OTHER,          ///< Characters not allowed outside of strings and comments.
+    CLS_NEWLINE,        ///< '\n'
+    CLS_BLANK,          ///< ' ' and '\t'
+    CLS_SPACE,          ///< Remaining whitespace ('\v', '\f', '\r')
+    CLS_SLASH,          ///< '/'
+    CLS_BSLASH,         ///< '\'
+    CLS_AT,             ///< '@'
+    CLS_QUOTE,          ///< '"'
+    CLS_ZERO,           ///< '0'
+    CLS_DIGIT,          ///< '1' - '9'
+    CLS_QMARK,          ///< '?'
+    CLS_UNDERSCORE,     ///< '_'
+    CLS_L_BRACKET,      ///< '['
+    CLS_R_BRACKET,      ///< ']'
+    CLS_CMP,            ///< '<', '>' and '!'
+    CLS_EQ,             ///< '='
+    CLS_DOT,            ///< '.'
+    CLS_SIGN,           ///< '+' and '-'
+    CLS_PUNCT,          ///< Remaining single character tokens
+    CLS_E,              ///< 'e' and 'E'
+    CLS_X,              ///< 'x'
+    CLS_HEX,            ///< Remaining hexadecimal letters
+    CLS_ESC,            ///< 'n', 't' and 'r'
+    CLS_ALPHA,          ///< Remaining letters
+    DFA_CLASS_COUNT     ///< Number of character classes.
+} DfaClass;
+
+/**
+ * @enum DfaAction
+ * @brief Actions performed on transition, stored above the state bits in table entry.
+*/
+typedef enum {
+    ACT_NONE,           ///< Continue scanning.
+    ACT_NEWLINE,        ///< New line outside of a token.
+    ACT_MARK,           ///< First character of a token.
+    ACT_MARK_ML,        ///< First character of a multi line string.
+    ACT_ML_NEWLINE,     ///< New line inside of a multi line string.
+    ACT_EMIT_CHAR,      ///< Single character token.
+    ACT_EMIT_Q_MARK,    ///< Question mark token.
+    ACT_EMIT_ML_STRING, ///< End of multi line string (character is put back).
+    ACT_EMIT_IMPORT,    ///< Last character of the '@import' directive.
+    ACT_EMIT_MULTI_EQ,  ///< Two character operator ending with '='.
+    ACT_EMIT_MULTI_OP,  ///< Single character operator (character is put back).
+    ACT_EMIT_ID,        ///< Identifier or keyword (character is put back).
+    ACT_EMIT_STRING,    ///< End of string literal.
+    ACT_EMIT_UNDERSCORE,///< Underscore token (character is put back).
+    ACT_EMIT_INTEGER,   ///< Integer literal (character is put back).
+    ACT_EMIT_FLOAT,     ///< Float literal (character is put back).
+    ACT_EMIT_DIV,       ///< Division operator (character is put back).
+    ACT_EMIT_SLICE,     ///< Slice token '[]'.
+    ACT_ERROR,          ///< Lexical error.
+    ACT_MARK_ERROR      ///< Lexical error on the first character of a token.
+} DfaAction;
+
+#endif // LEXER_DFA_H
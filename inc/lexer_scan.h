@@ -0,0 +1,153 @@
+/**
+ * @file lexer_scan.h
+ * @brief Contains scanning kernels used by the lexer to consume runs of characters
+ * @authors Michal Repcik (xrepcim00)
+ *
+ * Kernels process 32 (AVX2) or 16 (SSE2) bytes at a time, selected at compile
+ * time (build with -mavx2 to enable AVX2), with portable scalar fallback.
+ * Every kernel returns number of bytes at the start of p that belong to the run,
+ * loads never cross p + n.
+*/
+
+#ifndef LEXER_SCAN_H
+#define LEXER_SCAN_H
+
+#include <stddef.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SCAN_WIDTH 32
+typedef __m256i ScanVec;
+#define scan_load(p) _mm256_loadu_si256((const __m256i*)(p))
+#define scan_set1(c) _mm256_set1_epi8((char)(c))
+#define scan_eq(a, b) _mm256_cmpeq_epi8((a), (b))
+#define scan_gt(a, b) _mm256_cmpgt_epi8((a), (b))
+#define scan_or(a, b) _mm256_or_si256((a), (b))
+#define scan_and(a, b) _mm256_and_si256((a), (b))
+#define scan_mask(v) ((unsigned)_mm256_movemask_epi8(v))
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SCAN_WIDTH 16
+typedef __m128i ScanVec;
+#define scan_load(p) _mm_loadu_si128((const __m128i*)(p))
+#define scan_set1(c) _mm_set1_epi8((char)(c))
+#define scan_eq(a, b) _mm_cmpeq_epi8((a), (b))
+#define scan_gt(a, b) _mm_cmpgt_epi8((a), (b))
+#define scan_or(a, b) _mm_or_si128((a), (b))
+#define scan_and(a, b) _mm_and_si128((a), (b))
+#define scan_mask(v) ((unsigned)_mm_movemask_epi8(v))
+#endif
+
+#ifdef SCAN_WIDTH
+#define SCAN_FULL ((unsigned)((1ULL << SCAN_WIDTH) - 1)) ///< Mask with bit set for every byte of vector.
+
+// Mask of bytes in range <lo, hi> (both bounds below 128, bytes above 127 never match)
+static inline ScanVec scan_range(ScanVec v, int lo, int hi) {
+    return scan_and(scan_gt(v, scan_set1(lo - 1)), scan_gt(scan_set1(hi + 1), v));
+}
+#endif
+
+/**
+ * @brief Returns length of run of ' ', '\t' and '\n' characters.
+ *
+ * @param[out] newlines Incremented by number of '\n' characters in the run
+ * @param[out] line_start Set to the offset (relative to p) after the last '\n' in the run,
+ * unchanged if there is none
+*/
+static inline size_t scan_space(const unsigned char* p, size_t n, size_t* newlines, size_t* line_start) {
+    size_t i = 0;
+#ifdef SCAN_WIDTH
+    for (; i + SCAN_WIDTH <= n; i += SCAN_WIDTH) {
+        ScanVec v = scan_load(p + i);
+        ScanVec nl = scan_eq(v, scan_set1('\n'));
+        unsigned space = scan_mask(scan_or(nl, scan_or(scan_eq(v, scan_set1(' ')), scan_eq(v, scan_set1('\t')))));
+        unsigned lines = scan_mask(nl);
+        if (space != SCAN_FULL) {
+            unsigned len = __builtin_ctz(~space);
+            lines &= (1u << len) - 1;
+            if (lines) {
+                *newlines += __builtin_popcount(lines);
+                *line_start = i + (31 - __builtin_clz(lines)) + 1;
+            }
+            return i + len;
+        }
+        if (lines) {
+            *newlines += __builtin_popcount(lines);
+            *line_start = i + (31 - __builtin_clz(lines)) + 1;
+        }
+    }
+#endif
+    for (; i < n && (p[i] == ' ' || p[i] == '\t' || p[i] == '\n'); i++) {
+        if (p[i] == '\n') {
+            (*newlines)++;
+            *line_start = i + 1;
+        }
+    }
+    return i;
+}
+
+/**
+ * @brief Returns length of run of characters other than '\n' (comment body).
+*/
+static inline size_t scan_line(const unsigned char* p, size_t n) {
+    size_t i = 0;
+#ifdef SCAN_WIDTH
+    for (; i + SCAN_WIDTH <= n; i += SCAN_WIDTH) {
+        unsigned stop = scan_mask(scan_eq(scan_load(p + i), scan_set1('\n')));
+        if (stop) {
+            return i + __builtin_ctz(stop);
+        }
+    }
+#endif
+    for (; i < n && p[i] != '\n'; i++) {
+    }
+    return i;
+}
+
+/**
+ * @brief Returns length of run of identifier characters (letters, digits and '_').
+*/
+static inline size_t scan_ident(const unsigned char* p, size_t n) {
+    size_t i = 0;
+#ifdef SCAN_WIDTH
+    for (; i + SCAN_WIDTH <= n; i += SCAN_WIDTH) {
+        ScanVec v = scan_load(p + i);
+        ScanVec lower = scan_or(v, scan_set1(0x20)); // Lower case for letters
+        ScanVec ident = scan_or(scan_range(lower, 'a', 'z'),
+                        scan_or(scan_range(v, '0', '9'), scan_eq(v, scan_set1('_'))));
+        unsigned mask = scan_mask(ident);
+        if (mask != SCAN_FULL) {
+            return i + __builtin_ctz(~mask);
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        unsigned char c = p[i];
+        if (!((c | 0x20) >= 'a' && (c | 0x20) <= 'z') && !(c >= '0' && c <= '9') && c != '_') {
+            break;
+        }
+    }
+    return i;
+}
+
+/**
+ * @brief Returns length of run of string literal characters (up to '"', '\' or '\n').
+*/
+static inline size_t scan_string(const unsigned char* p, size_t n) {
+    size_t i = 0;
+#ifdef SCAN_WIDTH
+    for (; i + SCAN_WIDTH <= n; i += SCAN_WIDTH) {
+        ScanVec v = scan_load(p + i);
+        unsigned stop = scan_mask(scan_or(scan_eq(v, scan_set1('"')),
+                                  scan_or(scan_eq(v, scan_set1('\\')), scan_eq(v, scan_set1('\n')))));
+        if (stop) {
+            return i + __builtin_ctz(stop);
+        }
+    }
+#endif
+    for (; i < n && p[i] != '"' && p[i] != '\\' && p[i] != '\n'; i++) {
+    }
+    return i;
+}
+
+#endif // LEXER_SCAN_H
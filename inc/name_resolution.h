@@ -0,0 +1,32 @@
+/**
+ * @file name_resolution.h
+ * @brief Contains declaration of the name resolution pass
+ * @authors Michal Repcik (xrepcim00)
+ *
+ * Name resolution runs once after parsing. Every local symbol (parameter,
+ * variable, constant or element bind) gets id unique within its function,
+ * identifiers and assignments are annotated with id of the declaration they
+ * refer to, so later phases never look up names.
+*/
+
+#ifndef NAME_RESOLUTION_H
+#define NAME_RESOLUTION_H
+
+#include "ast.h"
+
+/**
+ * @fn void resolve_names(ASTNode* root)
+ * @brief Annotates identifiers, assignments and declarations of the program with local symbol ids.
+ *
+ * Sets `symbol` of identifiers and assignments (-1 if the name is not declared
+ * in a visible scope of the function), `symbol` and `redeclared` of parameters
+ * and declarations, `bind_symbol` of while and if nodes and `local_count` of
+ * function declarations. Reports no semantic errors, those are left to semantic
+ * analysis. Calls exit(INTERNAL_ERROR) when memory allocation fails.
+ *
+ * @param[in, out] root Root node of the AST (program)
+ * @return void
+*/
+void resolve_names(ASTNode* root);
+
+#endif // NAME_RESOLUTION_H
@@ -0,0 +1,54 @@
+/**
+ * @file optimizer.h
+ * @brief Contains declaration of the AST optimization pass
+ * @authors Michal Repcik (xrepcim00)
+ *
+ * Optimization runs after semantic analysis, so every expression node already
+ * knows its type (see ExpressionInfo), and before code generation. It rewrites
+ * the AST in place, the generator does not know whether it ran.
+*/
+
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "ast.h"
+
+/**
+ * @fn void fold_constants(ASTNode* root)
+ * @brief Folds constant expressions and simplifies branches with constant conditions.
+ *
+ * Arithmetic binary operations of two numeric literals are replaced by their
+ * result, when it is representable by a literal node: i32 operations that
+ * overflow or divide by zero and f64 results that are not exact in the float
+ * literal are left for run time. Identifiers of non-nullable constants
+ * initialized by a numeric literal are replaced by the literal, converted to
+ * the type of the constant. If statements with constant condition are replaced
+ * by the taken block, while cycles with false condition are removed.
+ *
+ * Arguments of builtins whose code generation needs a variable (ifj.length,
+ * ifj.concat, ifj.ord, ifj.chr) and conditions with element bind
+ * are not rewritten. Calls exit(INTERNAL_ERROR) when memory allocation fails.
+ *
+ * @param[in, out] root Root node of the AST (program)
+ * @return void
+*/
+void fold_constants(ASTNode* root);
+
+/**
+ * @fn void eliminate_dead_code(ASTNode* root)
+ * @brief Removes code that is never executed or whose result is never used.
+ *
+ * Drops statements following a return (or an if whose both branches return),
+ * functions not reachable from main through calls, and declarations and
+ * assignments of symbols that are never read, when their expression has no
+ * side effects and cannot fail (no user function calls, reads, writes or
+ * division by non-literal). Runs after fold_constants(), which removes
+ * branches with constant conditions and leaves propagated constants unread.
+ * Calls exit(INTERNAL_ERROR) when memory allocation fails.
+ *
+ * @param[in, out] root Root node of the AST (program)
+ * @return void
+*/
+void eliminate_dead_code(ASTNode* root);
+
+#endif // OPTIMIZER_H
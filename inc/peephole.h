@@ -0,0 +1,35 @@
+/**
+ * @file peephole.h
+ * @brief Contains declaration of the peephole pass over generated instructions
+ * @authors Michal Repcik (xrepcim00)
+ *
+ * Pass runs after the whole program was generated into the instruction list
+ * (see ir.h) and before it is written out. It only looks at a few neighbouring
+ * instructions, so it does not need to know how the generator produced them.
+*/
+
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+/**
+ * @fn void peephole_ir(void)
+ * @brief Rewrites short instruction sequences of the program into cheaper ones.
+ *
+ * Instructions are appended one by one to the rewritten list and its tail is
+ * rewritten as long as some pattern matches, so results of one rewrite take
+ * part in the next one:
+ *  - PUSHS a, POPS b becomes MOVE b a (nothing if a is b),
+ *  - EQS, PUSHS bool@false, JUMPIFEQS L becomes JUMPIFNEQS L,
+ *  - EQS, PUSHS bool@true, JUMPIFEQS L becomes JUMPIFEQS L,
+ *  - NOTS, PUSHS bool@false, JUMPIFEQS L becomes PUSHS bool@true, JUMPIFEQS L,
+ *  - PUSHS a, PUSHS b, JUMPIFEQS L becomes JUMPIFEQ L a b (same for JUMPIFNEQS),
+ *  - JUMP L followed only by labels and empty lines up to LABEL L is removed,
+ *  - runs of WRITE with string or int constant are merged into one WRITE.
+ *
+ * Calls exit(INTERNAL_ERROR) when memory allocation fails.
+ *
+ * @return void
+*/
+void peephole_ir(void);
+
+#endif // PEEPHOLE_H
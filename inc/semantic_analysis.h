@@ -48,24 +48,24 @@ void check_main_function(SymbolTable *global_table);
  * @param node Pointer to the AST node representing the binary operation.
  * @param global_table Pointer to the global symbol table.
  * @param local_stack Pointer to the local scope stack.
- * @param local_frame Pointer to the current local frame.
  * @return The resulting data type of the binary operation.
  */
-DataType evaluate_operator_type(ASTNode *node, SymbolTable *global_table, ScopeStack *local_stack, Frame *local_frame);
+DataType evaluate_operator_type(ASTNode *node, SymbolTable *global_table, ScopeStack *local_stack);
 
 /**
  * @brief Evaluates the type of an expression node.
  *
  * Determines the data type of the given expression, checking symbol declarations
- * and ensuring type compatibility.
+ * and ensuring type compatibility. Type, nullability and constness are recorded
+ * on the node (see ExpressionInfo), so every expression is evaluated only once
+ * and later passes read the result from the AST.
  *
  * @param node Pointer to the AST node representing the expression.
  * @param global_table Pointer to the global symbol table.
  * @param local_stack Pointer to the local scope stack.
- * @param local_frame Pointer to the current local frame.
  * @return The data type of the evaluated expression.
  */
-DataType evaluate_expression_type(ASTNode *node, SymbolTable *global_table, ScopeStack *local_stack, Frame *local_frame);
+DataType evaluate_expression_type(ASTNode *node, SymbolTable *global_table, ScopeStack *local_stack);
 
 /**
  * @brief Processes a variable or constant declaration.
@@ -75,6 +75,8 @@ DataType evaluate_expression_type(ASTNode *node, SymbolTable *global_table, Scop
  * @param global_table Pointer to the global symbol table.
  * @param local_stack Pointer to the local scope stack.
  * @param name Name of the variable or constant.
+ * @param symbol Local symbol id of the declaration (see name_resolution.h).
+ * @param redeclared Indicates if the name was already declared in a visible scope.
  * @param data_type_declared Declared data type of the variable or constant.
  * @param expression Pointer to the AST node for the initializing expression.
  * @param is_constant Indicates if the declaration is a constant.
@@ -85,6 +87,8 @@ void process_declaration(
     SymbolTable *global_table,
     ScopeStack *local_stack,
     const char *name,
+    int symbol,
+    bool redeclared,
     DataType data_type_declared,
     ASTNode *expression,
     bool is_constant,
@@ -113,17 +117,12 @@ void check_type_compatibility(
 );
 
 /**
- * @brief Checks the nullability of an identifier in the current scope.
+ * @brief Checks if a built-in function returns nullable value.
  *
- * Determines if the specified identifier can hold null values based on its declaration.
- *
- * @param node Pointer to the AST node representing the identifier.
- * @param global_table Pointer to the global symbol table.
- * @param local_stack Pointer to the local scope stack.
- * @param local_frame Pointer to the current local frame.
- * @return True if the identifier is nullable, false otherwise.
+ * @param fn_name Name of the built-in function.
+ * @return True if the function can return null, false otherwise (also for unknown names).
  */
-bool evaluate_nullable_operand(SymbolTable *global_table, ASTNode *node, ScopeStack *local_stack, Frame *local_frame);
+bool builtin_is_nullable(const char *fn_name);
 
 /**
  * @brief Processes the initialization and binding of elements in control statements.
@@ -133,8 +132,8 @@ bool evaluate_nullable_operand(SymbolTable *global_table, ASTNode *node, ScopeSt
  * @param expression Pointer to the AST node for the expression being bound.
  * @param global_table Pointer to the global symbol table.
  * @param local_stack Pointer to the local scope stack.
- * @param current_frame Pointer to the current local frame.
  * @param bind_name Name of the variable being bound.
+ * @param bind_symbol Local symbol id of the variable being bound.
  * @param condition_type Data type of the condition being evaluated.
  * @param has_literal Indicates if the expression has a literal value.
  */
@@ -142,8 +141,8 @@ void process_binding(
     ASTNode *expression,
     SymbolTable *global_table,
     ScopeStack *local_stack,
-    Frame *current_frame,
     const char *bind_name,
+    int bind_symbol,
     DataType condition_type,
     bool has_literal
 );
@@ -0,0 +1,69 @@
+/**
+ * @file source.h
+ * @brief Contains declarations of the source buffer used by the lexer
+ * @authors Michal Repcik (xrepcim00)
+*/
+
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/**
+ * @struct SourceBuffer
+ * @brief Contiguous view of the whole source code with a read cursor.
+ *
+ * Regular files are memory mapped, anything else (stdin, pipes) is read
+ * into a growing heap buffer in large chunks.
+*/
+typedef struct {
+    const unsigned char* data;  ///< Start of the source bytes (NULL for empty source).
+    size_t len;                 ///< Number of bytes available in data.
+    size_t pos;                 ///< Cursor, index of the next byte to be read.
+    void* map;                  ///< Start of the mapping (NULL if data is heap allocated).
+    size_t map_len;             ///< Length of the mapping.
+    FILE* fp;                   ///< Underlying file, closed by destroy_source.
+} SourceBuffer;
+
+/**
+ * @fn int init_source(SourceBuffer* src, FILE* fp)
+ * @brief Makes remaining content of fp available as a contiguous byte range.
+ *
+ * @param[out] src Pointer to source buffer struct
+ * @param[in] fp Pointer to a file/stdin, ownership is passed to src
+ * @return Returns 0 when everything went succesfully, otherwise returns -1
+*/
+int init_source(SourceBuffer* src, FILE* fp);
+
+/**
+ * @fn void destroy_source(SourceBuffer* src)
+ * @brief Unmaps or frees source data and closes the underlying file.
+ *
+ * @param[in, out] src Pointer to source buffer struct
+ * @return void
+*/
+void destroy_source(SourceBuffer* src);
+
+/**
+ * @brief Returns next byte and advances cursor, EOF at the end of source.
+*/
+static inline int src_next(SourceBuffer* src) {
+    return src->pos < src->len ? src->data[src->pos++] : EOF;
+}
+
+/**
+ * @brief Returns next byte without advancing cursor, EOF at the end of source.
+*/
+static inline int src_peek(const SourceBuffer* src) {
+    return src->pos < src->len ? src->data[src->pos] : EOF;
+}
+
+/**
+ * @brief Moves cursor one byte back (counterpart of ungetc).
+*/
+static inline void src_unget(SourceBuffer* src) {
+    src->pos--;
+}
+
+#endif // SOURCE_H
@@ -10,116 +10,99 @@
 #include "symtable.h"
 #include <stdbool.h>
 
-struct SymbolTable;
-typedef struct SymbolTable SymbolTable;
-
-struct Symbol;
-typedef struct Symbol Symbol;
-
-/**
- * @struct Frame
- * @brief Struct representing a frame that holds a symbol table.
- *
- * A frame corresponds to a specific scope in the program (e.g., function, loop, or conditional block).
- */
-typedef struct Frame {
-    SymbolTable *symbol_table;
-} Frame;
-
-
 /**
  * @struct ScopeStack
- * @brief Represents a stack of frames within a function or local scope.
+ * @brief Scopes and local symbols of the function that is being analyzed.
  *
- * The stack is used to manage nested scopes (e.g., function bodies, if/while blocks).
+ * Identifiers are resolved to local symbol ids before semantic analysis (see name_resolution.h),
+ * so symbols are stored in an array indexed by the id and no names are looked up. Scopes only
+ * remember which symbols were declared in them, to check unused variables when they are left.
  */
 typedef struct ScopeStack {
-    Frame **frames;      /**< Dynamic array of pointers to `Frame` elements. */
-    int top;             /**< Index of the top frame on the stack. */
-    int capacity;        /**< Current maximum capacity of the stack. */
+    Symbol *symbols;     /**< Local symbols of the analyzed function indexed by symbol id. */
+    int *declared;       /**< Ids of symbols declared in open scopes, in declaration order. */
+    int declared_count;  /**< Number of ids in declared. */
+    int declared_capacity; /**< Current maximum capacity of declared. */
+    int *scopes;         /**< Index into declared of the first symbol of every open scope. */
+    int top;             /**< Index of the top scope, -1 if no scope is open. */
+    int capacity;        /**< Current maximum capacity of the scopes array. */
+    Symbol *function;    /**< Function that is being analyzed, NULL outside of functions. */
 } ScopeStack;
 
 /**
- * @brief Initializes a new ScopeStack for managing frames within a function or scope.
+ * @brief Initializes a new empty ScopeStack.
  *
  * Allocates memory for the stack and initializes its capacity.
- * 
- * @return Pointer to the newly initialized `ScopeStack`, or `NULL` if memory allocation fails.
+ *
+ * @return Pointer to the newly initialized `ScopeStack`.
  */
 ScopeStack *init_scope_stack();
 
 /**
- * @brief Looks up a symbol in the local stack and global table.
- * 
- * This function searches for a symbol starting from the top frame of the local stack 
- * and then falls back to the global table if not found in the local scopes.
- * 
- * @param local_stack Pointer to the local scope stack.
- * @param name Name of the symbol to look for.
- * @param local_frame Pointer to a specific local frame to search first, or NULL to skip.
- * @return Pointer to the found symbol or NULL if not found.
- */
-Symbol *lookup_symbol_in_scope(ScopeStack *local_stack, const char *name, Frame *local_frame);
-
-/**
- * @brief Pushes a new frame onto the ScopeStack, resizing if needed.
- *
- * Creates a new frame with an empty symbol table and adds it to the top of the stack.
+ * @brief Returns local symbol with the given id.
  *
- * @param scope_stack Pointer to the `ScopeStack` to push a new frame onto.
+ * @param scope_stack Pointer to the scope stack.
+ * @param symbol Local symbol id from the AST.
+ * @return Pointer to the symbol or NULL if the id is -1 (name was not declared).
  */
-void push_frame(ScopeStack *scope_stack);
+static inline Symbol *local_symbol(ScopeStack *scope_stack, int symbol) {
+    return symbol >= 0 ? &scope_stack->symbols[symbol] : NULL;
+}
 
 /**
- * @brief Removes the top frame from the ScopeStack.
- *
- * Frees memory allocated for the top frame and its associated symbol table.
+ * @brief Returns symbol declared in the open scopes.
  *
- * @param scope_stack Pointer to the `ScopeStack` to pop from.
+ * @param scope_stack Pointer to the scope stack.
+ * @param index Index into `declared`, see top_frame().
+ * @return Pointer to the symbol.
  */
-void pop_frame(ScopeStack *scope_stack);
+static inline Symbol *declared_symbol(ScopeStack *scope_stack, int index) {
+    return &scope_stack->symbols[scope_stack->declared[index]];
+}
 
 /**
- * @brief Frees the memory associated with a single frame.
- * 
- * @param frame Pointer to the Frame to be freed.
+ * @brief Declares a variable in the top scope.
+ *
+ * @param scope_stack Pointer to the scope stack.
+ * @param symbol Local symbol id of the declaration.
+ * @param name Interned name of the variable.
+ * @param type The data type of the variable.
+ * @param is_constant Whether the variable is a constant.
+ * @param is_nullable Whether the variable can hold null.
+ * @param has_literal Whether the variable has a literal value.
+ * @param value The initial value of the variable.
  */
-void free_frame(Frame *frame);
+void add_scope_variable(ScopeStack *scope_stack, int symbol, const char *name, DataType type, bool is_constant, bool is_nullable, bool has_literal, double value);
 
 /**
- * @brief Frees the memory associated with a ScopeStack.
- * 
- * @param stack Pointer to the ScopeStack to be freed.
+ * @brief Opens a new scope on top of the ScopeStack, resizing if needed.
+ *
+ * @param scope_stack Pointer to the `ScopeStack` to push a new scope onto.
  */
-void free_scope_stack(ScopeStack *stack);
+void push_frame(ScopeStack *scope_stack);
 
 /**
- * @brief Retrieves the top frame of the ScopeStack without removing it.
+ * @brief Closes the top scope of the ScopeStack.
  *
- * Returns the frame at the top of the stack, or `NULL` if the stack is empty.
- *
- * @param scope_stack Pointer to the `ScopeStack`.
- * @return Pointer to the top `Frame`, or `NULL` if the stack is empty.
+ * @param scope_stack Pointer to the `ScopeStack` to pop from.
  */
-Frame *top_frame(ScopeStack *scope_stack);
+void pop_frame(ScopeStack *scope_stack);
 
 /**
- * @brief Resizes the ScopeStack when the capacity is reached.
+ * @brief Returns index into `declared` of the first symbol of the top scope.
  *
- * Doubles the current capacity of the stack and reallocates memory for frames.
+ * Symbols of the top scope are the ones from this index up to `declared_count`.
  *
- * @param scope_stack Pointer to the `ScopeStack` to resize.
+ * @param scope_stack Pointer to the `ScopeStack`.
+ * @return Index of the first symbol, `declared_count` if no scope is open.
  */
-void resize_scope_stack(ScopeStack *scope_stack);
+int top_frame(ScopeStack *scope_stack);
 
 /**
- * @brief Initializes a new frame with an empty symbol table.
- *
- * Allocates memory for the frame and initializes its symbol table.
+ * @brief Frees the memory associated with a ScopeStack.
  *
- * @return Pointer to the initialized `Frame`, or `NULL` if memory allocation fails.
+ * @param stack Pointer to the ScopeStack to be freed.
  */
-Frame *init_frame();
-
+void free_scope_stack(ScopeStack *stack);
 
 #endif // STACK_H
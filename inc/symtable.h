@@ -7,30 +7,27 @@
 #ifndef SYMTABLE_H
 #define SYMTABLE_H
 
+#include <stdint.h>
 #include "ast.h"
 
-struct ScopeStack; 
-typedef struct ScopeStack ScopeStack;
-
 /**
  * @brief Represents a function symbol in the symbol table.
  */
 typedef struct FuncSymbol {
-    char *name;              /**< Name of the function. */
+    const char *name;        /**< Interned name of the function. */
     DataType type;           /**< Return type of the function. */
     bool has_return;         /**< Indicates if the function has a return statement if not of void type. */
     bool used;               /**< Indicates if the function has been called. */
     bool is_nullable;        /**< Indicates if the function's expression can be of `AST_NULL` value. */
     bool is_initialized;     /**< Indicates if the function has been initialized. */
     ASTNode *fn_node;        /**< Pointer to the AST node representing the function declaration. */
-    ScopeStack *scope_stack; /**< Pointer to a ScopeStack for managing the function's scope. */
 } FuncSymbol;
 
 /**
  * @brief Represents a variable symbol in the symbol table.
  */
 typedef struct VarSymbol {
-    char *name;              /**< Name of the variable. */
+    const char *name;        /**< Interned name of the variable. */
     DataType type;           /**< Data type of the variable. */
     bool is_constant;        /**< Indicates if the variable is a constant. */
     bool used;               /**< Indicates if the variable has been used. */
@@ -59,13 +56,28 @@ typedef struct Symbol {
     };
 } Symbol;
 
+/**
+ * @brief Marks slot of a removed symbol (tombstone), probing continues past it.
+ */
+extern const char symbol_tombstone;
+#define SYMBOL_TOMBSTONE (&symbol_tombstone)
+
 /**
  * @brief Represents the symbol table.
+ *
+ * Open addressing table with linear probing, capacity is always a power of two.
+ * Slots are stored in parallel arrays, probing touches only the array of names
+ * (names are interned, so they are compared by pointer) and symbols are stored
+ * inline in their own array. Pointers returned by lookup_symbol() point into that
+ * array and stay valid only until the next symbol is added to the same table.
  */
 typedef struct SymbolTable {
-    Symbol **symbols; /**< Array of pointers to symbols. */
-    int count;        /**< Current number of symbols in the table. */
-    int capacity;     /**< Maximum capacity of the table. */
+    const char **names; /**< Interned names (keys), NULL for empty slot or SYMBOL_TOMBSTONE. */
+    uint32_t *hashes;   /**< Cached hashes of the names, used when the table is resized. */
+    Symbol *symbols;    /**< Symbols, valid only in slots with a name. */
+    int count;          /**< Current number of symbols in the table. */
+    int used;           /**< Number of slots holding a symbol or a tombstone. */
+    int capacity;       /**< Number of slots (power of two), 0 until the first symbol is added. */
 } SymbolTable;
 
 /**
@@ -80,7 +92,7 @@ SymbolTable *init_symbol_table();
 /**
  * @brief Frees the memory associated with a symbol table.
  *
- * Releases all memory allocated for the symbols and the table itself.
+ * Releases slot arrays and the table itself.
  *
  * @param table Pointer to the symbol table to free.
  */
@@ -89,7 +101,8 @@ void free_symbol_table(SymbolTable *table);
 /**
  * @brief Resizes the symbol table when the load factor is exceeded.
  *
- * Doubles the capacity of the symbol table and rehashes all symbols.
+ * Rehashes all symbols into a new slot array (using cached hashes), which
+ * also drops tombstones of removed symbols.
  *
  * @param table Pointer to the symbol table to resize.
  */
@@ -99,7 +112,7 @@ void resize(SymbolTable *table);
  * @brief Adds a function symbol to the symbol table.
  *
  * @param table Pointer to the symbol table.
- * @param name Name of the function.
+ * @param name Interned name of the function (see intern.h).
  * @param return_type Return type of the function.
  * @param is_initialized Indicates if the function is initialized.
  * @param fn_node Pointer to the AST node for the function declaration.
@@ -111,7 +124,7 @@ void add_function_symbol(SymbolTable *table, const char *name, DataType return_t
  * @brief Adds a variable symbol to the symbol table.
  *
  * @param table Pointer to the symbol table.
- * @param name Name of the variable.
+ * @param name Interned name of the variable (see intern.h).
  * @param type Data type of the variable.
  * @param is_constant Indicates if the variable is constant.
  * @param is_nullable Indicates if the variable can have a nullable value.
@@ -124,9 +137,30 @@ void add_variable_symbol(SymbolTable *table, const char *name, DataType type, bo
  * @brief Looks up a symbol in the symbol table by its name.
  *
  * @param table Pointer to the symbol table.
- * @param name Name of the symbol to look for.
+ * @param name Interned name of the symbol to look for.
  * @return Pointer to the symbol if found, or `NULL` if not found.
  */
 Symbol *lookup_symbol(SymbolTable *table, const char *name);
 
+/**
+ * @brief Removes a symbol from the symbol table.
+ *
+ * Slot of the symbol is marked as deleted, so symbols placed after it stay reachable.
+ *
+ * @param table Pointer to the symbol table.
+ * @param name Interned name of the symbol to remove.
+ * @return `true` if the symbol was removed, `false` if it was not found.
+ */
+bool remove_symbol(SymbolTable *table, const char *name);
+
+/**
+ * @brief Returns symbol stored in the slot at index or `NULL` if the slot holds no symbol.
+ *
+ * Used to iterate over all symbols of the table (indexes 0 to capacity - 1).
+ */
+static inline Symbol *symbol_at(SymbolTable *table, int index) {
+    const char *name = table->names[index];
+    return name != NULL && name != SYMBOL_TOMBSTONE ? &table->symbols[index] : NULL;
+}
+
 #endif // SYMTABLE_H
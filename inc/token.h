@@ -8,6 +8,7 @@
 #define TOKEN_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 /**
  * @enum TokenType
@@ -60,36 +61,48 @@ typedef enum {
     TOKEN_IMPORT          ///< Constant for '@import' directive.
 } TokenType;
 
+/**
+ * @brief Token flag marking multi line string, its value has to be decoded.
+*/
+#define TOKEN_FLAG_MULTILINE 0x1
+
 /**
  * @struct Token
  * @brief Struct containing informations about token.
+ *
+ * Token is a small value type, its value is not copied but referenced
+ * by offset and length into the source buffer of the lexer. String literal
+ * values exclude surrounding quotes, use token_text() to get the value.
 */
 typedef struct {
     TokenType token_type;   ///< Type of token
-    char* value;            ///< Token value 
+    uint32_t offset;        ///< Offset of token value in the source
+    uint32_t length;        ///< Length of token value in the source
+    uint32_t line;          ///< Line where token starts (starting from 1)
+    uint16_t col;           ///< Column where token starts (starting from 1, saturated)
+    uint16_t flags;         ///< Additional token flags (TOKEN_FLAG_*)
 } Token;
 
 /**
- * @fn Token* create_token(TokenType token_type, size_t lenght, const char* value)
- * @brief Allocates and initializes Token struct.
- * 
- * @param[in] toke_type Type of token
- * @param[in] length Length of string that that is passed as value
- * @param[in] value String that is assigned as token value
- * @return Returns pointer to a token
- * 
- * @note When function is called with length set to 0, memory for value
- * wont be allocated and char* value in Token will be set to NULL pointer.
-*/
-Token* create_token(TokenType token_type, size_t lenght, const char* value);
-
-/**
- * @fn void free_token(Token *token)
- * @brief Frees memory allocated for Token struct.
+ * @fn static inline Token create_token(TokenType token_type, size_t start, size_t end, uint32_t line, size_t col)
+ * @brief Initializes Token struct with value in source range <start, end).
  * 
- * @param[in] token Pointer to a token
- * @return void
+ * @param[in] token_type Type of token
+ * @param[in] start Offset of the first character of the value
+ * @param[in] end Offset after the last character of the value
+ * @param[in] line Line where token starts
+ * @param[in] col Column where token starts
+ * @return Returns token
 */
-void free_token(Token *token);
+static inline Token create_token(TokenType token_type, size_t start, size_t end, uint32_t line, size_t col) {
+    Token token;
+    token.token_type = token_type;
+    token.offset = (uint32_t)start;
+    token.length = (uint32_t)(end - start);
+    token.line = line;
+    token.col = col > UINT16_MAX ? UINT16_MAX : (uint16_t)col;
+    token.flags = 0;
+    return token;
+}
 
 #endif // TOKEN_H
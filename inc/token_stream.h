@@ -0,0 +1,88 @@
+/**
+ * @file token_stream.h
+ * @brief Contains declarations of the token stream produced by the lexer pre-pass
+ * @authors Michal Repcik (xrepcim00)
+*/
+
+#ifndef TOKEN_STREAM_H
+#define TOKEN_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "token.h"
+
+/**
+ * @struct TokenStream
+ * @brief Tokens of the whole source stored as struct of arrays.
+ *
+ * Every field of Token has its own contiguous array indexed by token number,
+ * so scanning token types does not pull offsets and positions into cache.
+ * Stream always ends with TOKEN_EOF or INVALID token.
+*/
+typedef struct {
+    uint8_t* types;         ///< Token types (TokenType).
+    uint32_t* offsets;      ///< Offsets of token values in the source.
+    uint32_t* lengths;      ///< Lengths of token values in the source.
+    uint32_t* lines;        ///< Lines where tokens start.
+    uint16_t* cols;         ///< Columns where tokens start.
+    uint16_t* flags;        ///< Token flags (TOKEN_FLAG_*).
+    size_t count;           ///< Number of tokens in the stream.
+    size_t capacity;        ///< Number of tokens arrays can hold.
+} TokenStream;
+
+/**
+ * @fn int init_token_stream(TokenStream* stream, size_t capacity)
+ * @brief Allocates arrays of the stream for capacity tokens.
+ *
+ * @param[out] stream Pointer to token stream struct
+ * @param[in] capacity Initial number of tokens (at least 1)
+ * @return Returns 0 when everything went succesfully, otherwise returns -1
+*/
+int init_token_stream(TokenStream* stream, size_t capacity);
+
+/**
+ * @fn void destroy_token_stream(TokenStream* stream)
+ * @brief Frees arrays of the stream and sets all pointers to NULL.
+ *
+ * @param[in, out] stream Pointer to token stream struct
+ * @return void
+*/
+void destroy_token_stream(TokenStream* stream);
+
+/**
+ * @fn int push_token(TokenStream* stream, const Token* token)
+ * @brief Appends token at the end of the stream, arrays grow when full.
+ *
+ * @param[in, out] stream Pointer to token stream struct
+ * @param[in] token Pointer to a token
+ * @return Returns 0 when everything went succesfully, otherwise returns -1
+*/
+int push_token(TokenStream* stream, const Token* token);
+
+/**
+ * @fn int append_tokens(TokenStream* stream, const TokenStream* other, size_t count, uint32_t line_offset)
+ * @brief Appends first count tokens of other stream, their lines are shifted by line_offset.
+ *
+ * @param[in, out] stream Pointer to token stream struct
+ * @param[in] other Pointer to token stream with tokens to append
+ * @param[in] count Number of tokens to append (at most other->count)
+ * @param[in] line_offset Number added to line of every appended token
+ * @return Returns 0 when everything went succesfully, otherwise returns -1
+*/
+int append_tokens(TokenStream* stream, const TokenStream* other, size_t count, uint32_t line_offset);
+
+/**
+ * @brief Returns token with index i (i < stream->count).
+*/
+static inline Token token_at(const TokenStream* stream, size_t i) {
+    Token token;
+    token.token_type = (TokenType)stream->types[i];
+    token.offset = stream->offsets[i];
+    token.length = stream->lengths[i];
+    token.line = stream->lines[i];
+    token.col = stream->cols[i];
+    token.flags = stream->flags[i];
+    return token;
+}
+
+#endif // TOKEN_STREAM_H
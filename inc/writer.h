@@ -0,0 +1,71 @@
+/**
+ * @file writer.h
+ * @brief Contains declaration of the buffered output writer
+ * @authors Michal Repcik (xrepcim00)
+ *
+ * Generated code is appended to one large buffer by appenders that do not
+ * parse format strings. Full buffer is written out either directly or, with
+ * background flushing, handed to a flush thread while generation continues
+ * into a second buffer.
+*/
+
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef WRITER_BUFFER_SIZE
+#define WRITER_BUFFER_SIZE (1 << 20) ///< Size of one output buffer in bytes.
+#endif
+
+/**
+ * @fn int init_writer(FILE* out, bool background)
+ * @brief Sets up the writer for output stream.
+ *
+ * @param[in] out Stream the generated code is written to, it is not closed by the writer
+ * @param[in] background Flag if full buffers are written by a flush thread
+ * @return 0 on success, 1 if memory allocation or thread creation failed
+*/
+int init_writer(FILE* out, bool background);
+
+/**
+ * @fn int destroy_writer(void)
+ * @brief Writes out the rest of the output, stops the flush thread and frees the buffers.
+ *
+ * @return 0 on success, 1 if any write to the output stream failed
+*/
+int destroy_writer(void);
+
+/**
+ * @fn void write_chars(const char* data, size_t length)
+ * @brief Appends length bytes of data.
+*/
+void write_chars(const char* data, size_t length);
+
+/**
+ * @fn void write_str(const char* str)
+ * @brief Appends null terminated string.
+*/
+void write_str(const char* str);
+
+/**
+ * @fn void write_char(char c)
+ * @brief Appends one character.
+*/
+void write_char(char c);
+
+/**
+ * @fn void write_int(long long value)
+ * @brief Appends decimal representation of value.
+*/
+void write_int(long long value);
+
+/**
+ * @fn void write_float(double value)
+ * @brief Appends hexadecimal representation of value, same as printf("%a").
+*/
+void write_float(double value);
+
+#endif // WRITER_H
@@ -0,0 +1,88 @@
+/**
+ * @file arena.c
+ * @brief Contains definitions of functions declared in arena.h
+ * @authors Michal Repcik (xrepcim00)
+*/
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+// Size of page header rounded up to alignment, data follows the header
+#define ARENA_HEADER_SIZE ((sizeof(ArenaPage) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+void* arena_alloc_page(Arena* arena, size_t size) {
+    size_t page_size = size > ARENA_PAGE_SIZE ? size : ARENA_PAGE_SIZE;
+    ArenaPage* page = malloc(ARENA_HEADER_SIZE + page_size);
+    if (page == NULL) {
+        return NULL;
+    }
+
+    page->data = (unsigned char*)page + ARENA_HEADER_SIZE;
+    page->size = page_size;
+    page->used = size;
+    page->next = arena->page;
+    // Oversized allocation goes below the current page, so its free space is not lost
+    if (arena->page != NULL && page_size > ARENA_PAGE_SIZE) {
+        page->next = arena->page->next;
+        arena->page->next = page;
+    }
+    else {
+        arena->page = page;
+    }
+    arena->page_count++;
+    arena->alloc_count++;
+    return page->data;
+}
+
+void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size) {
+    if (ptr == NULL) {
+        return arena_alloc(arena, new_size);
+    }
+
+    old_size = (old_size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+    new_size = (new_size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+    if (new_size <= old_size) {
+        return ptr;
+    }
+    ArenaPage* page = arena->page;
+    // Last allocation of the current page can be extended in place
+    if (page != NULL && (unsigned char*)ptr + old_size == page->data + page->used &&
+        page->size - page->used >= new_size - old_size) {
+        page->used += new_size - old_size;
+        return ptr;
+    }
+
+    void* new_ptr = arena_alloc(arena, new_size);
+    if (new_ptr == NULL) {
+        return NULL;
+    }
+    memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    return new_ptr;
+}
+
+char* arena_strdup(Arena* arena, const char* str) {
+    size_t len = strlen(str) + 1;
+    char* copy = arena_alloc(arena, len);
+    if (copy == NULL) {
+        return NULL;
+    }
+    memcpy(copy, str, len);
+    return copy;
+}
+
+void destroy_arena(Arena* arena) {
+    if (arena == NULL) {
+        return;
+    }
+
+    ArenaPage* page = arena->page;
+    while (page != NULL) {
+        ArenaPage* next = page->next;
+        free(page);
+        page = next;
+    }
+    arena->page = NULL;
+    arena->alloc_count = 0;
+    arena->page_count = 0;
+}
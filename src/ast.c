@@ -3,6 +3,7 @@
  * @brief Implementation of function that handle nodes of AST
  * @authors Michal Repcik (xrepcim00) Simon Bobko (xbobkos00)
 */
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -11,13 +12,59 @@
 #include "ast.h"
 #include "error.h"
 
-#define DEFAULT_PROGRAM_DECL_CNT    10  ///< Used for pre-allocating memory for declaration array inside program node
-#define DEFAULT_FN_ARG_CNT          3   ///< Used for pre-allocating memory for argument array inside function declaration node
-#define DEFAULT_FN_PARAM_CNT        3   ///< Used for pre-allocating memory for parameter array inside function call node
-#define DEFAULT_BLOCK_NODE_CNT      5   ///< Used for pre-allocating memory for node array inside block
+#define DEFAULT_CHILDREN_CNT        64  ///< Initial capacity of arrays of child lists
+
+// Size of node of the given variant, nodes are allocated only as large as their variant
+#define AST_NODE_SIZE(variant) (offsetof(ASTNode, variant) + sizeof(((ASTNode*)0)->variant))
+
+Arena ast_arena = {0};
+ASTNodeArray ast_children = {0};
+static ASTNodeArray open_children = {0}; // Children of lists that are not closed yet
+
+char* ast_strdup(const char* str) {
+    return arena_strdup(&ast_arena, str);
+}
+
+void free_ast(void) {
+    destroy_arena(&ast_arena);
+    free(ast_children.nodes);
+    free(open_children.nodes);
+    ast_children = (ASTNodeArray){0};
+    open_children = (ASTNodeArray){0};
+}
+
+// Makes room for count more pointers in the array, returns 0 on success
+static int reserve_children(ASTNodeArray* array, uint32_t count) {
+    if (array->count + count <= array->capacity) {
+        return 0;
+    }
+    uint32_t capacity = array->capacity ? array->capacity : DEFAULT_CHILDREN_CNT;
+    while (capacity < array->count + count) {
+        capacity *= 2;
+    }
+    ASTNode** nodes = realloc(array->nodes, capacity * sizeof(ASTNode*));
+    if (nodes == NULL) {
+        set_error(INTERNAL_ERROR);
+        fprintf(stderr, "Failed to reallocate memory for child lists of AST\n");
+        return 1;
+    }
+    array->nodes = nodes;
+    array->capacity = capacity;
+    return 0;
+}
+
+// Pushes child on top of the open lists, returns 0 on success
+static int push_child(ASTNode* child) {
+    if (reserve_children(&open_children, 1) != 0) {
+        return 1;
+    }
+    open_children.nodes[open_children.count++] = child;
+    return 0;
+}
 
 ASTNode* create_null_node(){
-    ASTNode* node = malloc(sizeof(ASTNode));
+    // Sized as float node, semantic analysis reads literal value of every declaration expression
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(Float));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         fprintf(stderr, "Memory allocation for null node failed\n");
@@ -25,23 +72,22 @@ ASTNode* create_null_node(){
     }
 
     node->type = AST_NULL;
+    node->expr = (ExpressionInfo){.data_type = AST_UNSPECIFIED, .nullable = true, .constant = true, .evaluated = true};
     return node;
 }
 
-ASTNode* create_assignment_node(char* identifier) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+ASTNode* create_assignment_node(const char* identifier) {
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(Assignment));
     if (node == NULL) {
         return NULL;
     }
 
-    node->Assignment.identifier = strdup(identifier);
-    if (node->Assignment.identifier == NULL) {
-        free(node);
-        return NULL;
-    }
+    node->Assignment.identifier = identifier;
 
     node->type = AST_ASSIGNMENT;
     node->Assignment.expression = NULL;
+    node->Assignment.symbol = -1;
+    node->Assignment.data_type = AST_UNSPECIFIED;
     return node;
 }
 
@@ -86,7 +132,7 @@ ASTNode* create_binary_op_node(int operator, ASTNode* left, ASTNode* right) {
     }
 
     // Allocate memory for the ASTNode
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(BinaryOperator));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         return NULL;
@@ -94,6 +140,7 @@ ASTNode* create_binary_op_node(int operator, ASTNode* left, ASTNode* right) {
 
     // Set node type
     node->type = AST_BIN_OP;
+    node->expr = (ExpressionInfo){.data_type = AST_UNSPECIFIED};
 
     // Initialize the BinaryOperator struct
     node->BinaryOperator.operator = op_type;
@@ -103,36 +150,34 @@ ASTNode* create_binary_op_node(int operator, ASTNode* left, ASTNode* right) {
     return node;
 }
 
-ASTNode* create_identifier_node(char* identifier) {
+ASTNode* create_identifier_node(const char* identifier) {
     // Allocate memory for the ASTNode
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(Identifier));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         return NULL;
     }
 
     node->type = AST_IDENTIFIER;
+    node->expr = (ExpressionInfo){.data_type = AST_UNSPECIFIED};
 
     // Initialize the Identifier struct
-    node->Identifier.identifier = strdup(identifier);
-    if (node->Identifier.identifier == NULL) {
-        set_error(INTERNAL_ERROR);
-        free(node);
-        return NULL;
-    }
+    node->Identifier.identifier = identifier;
+    node->Identifier.symbol = -1;
 
     return node;
 }
 
 ASTNode* create_i32_node(int value) {
     // Allocate memory for the ASTNode
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(Integer));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         return NULL;
     }
 
     node->type = AST_INT;
+    node->expr = (ExpressionInfo){.data_type = AST_I32, .constant = true, .evaluated = true};
 
     // Set the integer value
     node->Integer.number = value;
@@ -141,30 +186,31 @@ ASTNode* create_i32_node(int value) {
 }
 
 ASTNode* create_f64_node(double value) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(Float));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         return NULL;
     }
 
     node->type = AST_FLOAT;
+    node->expr = (ExpressionInfo){.data_type = AST_F64, .constant = true, .evaluated = true};
     node->Float.number = value;
 
     return node;
 }
 
-ASTNode* create_string_node(char* value) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
+ASTNode* create_string_node(const char* value) {
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(String));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         return NULL;
     }
 
     node->type = AST_STRING;
-    node->String.string = strdup(value);
+    node->expr = (ExpressionInfo){.data_type = AST_SLICE, .constant = true, .evaluated = true};
+    node->String.string = ast_strdup(value);
     if (node->String.string == NULL) {
         set_error(INTERNAL_ERROR);
-        free(node);
         return NULL;
     }
 
@@ -172,7 +218,7 @@ ASTNode* create_string_node(char* value) {
 }
 
 ASTNode* create_program_node() {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(Program));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         fprintf(stderr, "Memory allocation for program node failed\n");
@@ -181,27 +227,13 @@ ASTNode* create_program_node() {
 
     node->type = AST_PROGRAM;
     node->Program.decl_count = 0;
-
-    // Allocate meory for default size (can be reallocated later)
-    node->Program.decl_capacity = DEFAULT_PROGRAM_DECL_CNT;
-    node->Program.declarations = malloc(DEFAULT_PROGRAM_DECL_CNT * sizeof(ASTNode*));
-    if (node->Program.declarations == NULL) {
-        free(node);
-        set_error(INTERNAL_ERROR);
-        fprintf(stderr, "Memory allocation for declaration array in program node failed\n");
-        return NULL;
-    }
-
-    // Set all pointers to NULL
-    for (int i = 0; i < DEFAULT_PROGRAM_DECL_CNT; i++) {
-        node->Program.declarations[i] = NULL;
-    }
+    node->Program.declarations = 0; // Set by close_child_list
 
     return node;
 }
 
-ASTNode* create_fn_decl_node(char* fn_name) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+ASTNode* create_fn_decl_node(const char* fn_name) {
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(FnDecl));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         fprintf(stderr, "Memory allocation for function declaration node failed\n");
@@ -209,40 +241,21 @@ ASTNode* create_fn_decl_node(char* fn_name) {
     }
 
     node->type = AST_FN_DECL;
-    node->FnDecl.fn_name = strdup(fn_name);
-    if (node->FnDecl.fn_name == NULL) {
-        set_error(INTERNAL_ERROR);
-        free(node);
-        fprintf(stderr, "Memory allocation for function name in function declaration node failed\n");
-    }
+    node->FnDecl.fn_name = fn_name;
 
     node->FnDecl.param_count = 0;
-
-    // Allocate memory for default parameter count (can be re-allocated later)
-    node->FnDecl.param_capacity = DEFAULT_FN_PARAM_CNT;
-    node->FnDecl.params = malloc(DEFAULT_FN_PARAM_CNT * sizeof(ASTNode*));
-    if (node->FnDecl.params == NULL) {
-        set_error(INTERNAL_ERROR);
-        free(node->FnDecl.fn_name);
-        free(node);
-        fprintf(stderr, "Memroy allocation for paramaeter array in function declaration node failed\n");
-        return NULL;
-    }
-
-    // Set all pointers to NULL
-    for (int i = 0; i < DEFAULT_FN_PARAM_CNT; i++) {
-        node->FnDecl.params[i] = NULL;
-    }
+    node->FnDecl.params = 0; // Set by close_child_list
 
     node->FnDecl.block = NULL;
     node->FnDecl.nullable = false;
     node->FnDecl.return_type = AST_UNSPECIFIED; // Not specified when creating node
+    node->FnDecl.local_count = 0;
 
     return node;
 }
 
-ASTNode* create_param_node(DataType data_type, char* identifier) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+ASTNode* create_param_node(DataType data_type, const char* identifier) {
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(Param));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         fprintf(stderr, "Memory allocation for parameter node failed\n");
@@ -252,19 +265,15 @@ ASTNode* create_param_node(DataType data_type, char* identifier) {
     node->type = AST_PARAM;
     node->Param.nullable = false;
     node->Param.data_type = data_type;
-    node->Param.identifier = strdup(identifier);
-    if (node->Param.identifier == NULL) {
-        set_error(INTERNAL_ERROR);
-        free(node);
-        fprintf(stderr, "Memory allocation for identifier in parameter node failed\n");
-        return NULL;
-    }
+    node->Param.identifier = identifier;
+    node->Param.symbol = -1;
+    node->Param.redeclared = false;
 
     return node;
 }
 
 ASTNode* create_return_node() {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(Return));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         fprintf(stderr, "Memory allocation for return node failed\n");
@@ -276,8 +285,8 @@ ASTNode* create_return_node() {
     return node;
 }
 
-ASTNode* create_var_decl_node(DataType data_type, char* var_name) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+ASTNode* create_var_decl_node(DataType data_type, const char* var_name) {
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(VarDecl));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         fprintf(stderr, "Memory allocation for variable declaration node failed\n");
@@ -288,19 +297,15 @@ ASTNode* create_var_decl_node(DataType data_type, char* var_name) {
     node->VarDecl.data_type = data_type;
     node->VarDecl.expression = NULL;
     node->VarDecl.nullable = false;
-    node->VarDecl.var_name = strdup(var_name);
-    if (node->VarDecl.var_name == NULL) {
-        set_error(INTERNAL_ERROR);
-        free(node);
-        fprintf(stderr, "Memory allocation for variable name in variable declaration node failed\n");
-        return NULL;
-    }
+    node->VarDecl.var_name = var_name;
+    node->VarDecl.symbol = -1;
+    node->VarDecl.redeclared = false;
 
     return node;
 }
 
-ASTNode* create_const_decl_node(DataType data_type, char* const_name) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+ASTNode* create_const_decl_node(DataType data_type, const char* const_name) {
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(ConstDecl));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         fprintf(stderr, "Memory allocation for const declaration node failed\n");
@@ -311,19 +316,15 @@ ASTNode* create_const_decl_node(DataType data_type, char* const_name) {
     node->ConstDecl.data_type = data_type;
     node->ConstDecl.expression = NULL;
     node->ConstDecl.nullable = false;
-    node->ConstDecl.const_name = strdup(const_name);
-    if (node->VarDecl.var_name == NULL) {
-        set_error(INTERNAL_ERROR);
-        free(node);
-        fprintf(stderr, "Memory allocation for const name in constant declaration node failed\n");
-        return NULL;
-    }
+    node->ConstDecl.const_name = const_name;
+    node->ConstDecl.symbol = -1;
+    node->ConstDecl.redeclared = false;
 
     return node;
 }
 
 ASTNode* create_block_node() {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(Block));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         fprintf(stderr, "Memory allocation for block node failed\n");
@@ -332,25 +333,13 @@ ASTNode* create_block_node() {
 
     node->type = AST_BLOCK;
     node->Block.node_count = 0;
-    node->Block.node_capacity = DEFAULT_BLOCK_NODE_CNT;
-    node->Block.nodes = malloc(DEFAULT_BLOCK_NODE_CNT * sizeof(ASTNode*));
-    if (node->Block.nodes == NULL) {
-        set_error(INTERNAL_ERROR);
-        free(node);
-        fprintf(stderr, "Memory allocation for pointer array in block node failed\n");
-        return NULL;
-    }
-
-    // Set all pointers to NULL
-    for (int i = 0; i < DEFAULT_BLOCK_NODE_CNT; i++) {
-        node->Block.nodes[i] = NULL;
-    }
+    node->Block.nodes = 0; // Set by close_child_list
 
     return node;
 }
 
 ASTNode* create_while_node() {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(WhileCycle));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         fprintf(stderr, "Memory allocation for while node failed\n");
@@ -361,12 +350,13 @@ ASTNode* create_while_node() {
     node->WhileCycle.element_bind = NULL;     
     node->WhileCycle.expression = NULL;
     node->WhileCycle.block = NULL;
+    node->WhileCycle.bind_symbol = -1;
 
     return node;
 }
 
 ASTNode* create_if_node() {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(IfElse));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         fprintf(stderr, "Memory allocation for if/else node failed\n");
@@ -378,12 +368,13 @@ ASTNode* create_if_node() {
     node->IfElse.if_block = NULL;
     node->IfElse.else_block = NULL;
     node->IfElse.expression = NULL;
+    node->IfElse.bind_symbol = -1;
 
     return node;
 }
 
-ASTNode* create_fn_call_node(char* fn_name) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+ASTNode* create_fn_call_node(const char* fn_name) {
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(FnCall));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         fprintf(stderr, "Memory allocation for function call node failed\n");
@@ -391,35 +382,17 @@ ASTNode* create_fn_call_node(char* fn_name) {
     }
 
     node->type = AST_FN_CALL;
-    node->FnCall.fn_name = strdup(fn_name);
-    if (node->FnCall.fn_name == NULL) {
-        set_error(INTERNAL_ERROR);
-        free(node);
-        fprintf(stderr, "Memory allocation for function name in function call node failed\n");
-        return NULL;
-    }
+    node->expr = (ExpressionInfo){.data_type = AST_UNSPECIFIED};
+    node->FnCall.fn_name = fn_name;
     node->FnCall.is_builtin = false;
     node->FnCall.arg_count = 0;
-    // Allocate memory for default arguemnt count (can be re-allocated later)
-    node->FnCall.arg_capacity = DEFAULT_FN_ARG_CNT;
-    node->FnCall.args = malloc(DEFAULT_FN_ARG_CNT * sizeof(ASTNode*));
-    if (node->FnCall.args == NULL) {
-        set_error(INTERNAL_ERROR);
-        free(node);
-        fprintf(stderr, "Memory allocation for pointer array in function call node failed\n");
-        return NULL;
-    }
-
-    // Set all pointes to NULL
-    for (int i = 0; i < DEFAULT_FN_ARG_CNT; i++) {
-        node->FnCall.args[i] = NULL;
-    }
+    node->FnCall.args = 0; // Set by close_child_list
 
     return node;
 }
 
 ASTNode* create_arg_node() {
-    ASTNode* node = malloc(sizeof(ASTNode));
+    ASTNode* node = arena_alloc(&ast_arena, AST_NODE_SIZE(Argument));
     if (node == NULL) {
         set_error(INTERNAL_ERROR);
         fprintf(stderr, "Memory allocation for argument node failed\n");
@@ -432,185 +405,15 @@ ASTNode* create_arg_node() {
     return node;
 }
 
-void free_ast_node(ASTNode* node) {
-    if (node == NULL) {
-        return;
-    }
-
-    switch (node->type) {
-        case AST_ASSIGNMENT:
-            free(node->Assignment.identifier);
-            free_ast_node(node->Assignment.expression);
-            break;
-        case AST_BIN_OP:
-            // Recursively free left and right operands
-            free_ast_node(node->BinaryOperator.left);
-            free_ast_node(node->BinaryOperator.right);
-            break;
-        case AST_IDENTIFIER:
-            if (node->Identifier.identifier != NULL) {
-                free(node->Identifier.identifier);
-            }
-            break;
-            
-        case AST_INT:
-            break;
-
-        case AST_FLOAT:
-            break;
-
-        case AST_NULL:
-            break;
-
-        case AST_STRING:
-            if (node->String.string != NULL) {
-                free(node->String.string);
-            }
-            break;
-        case AST_PROGRAM:
-            // Free all declarations recursively
-            for (int i = 0; i < node->Program.decl_count; i++) {
-                if (node->Program.declarations[i] != NULL) {
-                    free_ast_node(node->Program.declarations[i]);
-                }
-            }
-            free(node->Program.declarations); // Free array itself
-            break;
-
-        case AST_FN_DECL:
-            free(node->FnDecl.fn_name); // Free name
-            // Free all parameters recursively
-            for (int i = 0; i < node->FnDecl.param_count; i++) {
-                if (node->FnDecl.params[i] != NULL) {
-                    free_ast_node(node->FnDecl.params[i]);
-                }
-            }
-            free(node->FnDecl.params); // Free array itself
-            // Free block node
-            if (node->FnDecl.block != NULL) {
-                free_ast_node(node->FnDecl.block);
-            }
-            break;
-
-        case AST_PARAM:
-            free(node->Param.identifier); // Free identifier
-            break;
-
-        case AST_RETURN:
-            // Free exression node
-            if (node->Return.expression != NULL) {
-                free_ast_node(node->Return.expression);
-            }
-            break;
-
-        case AST_VAR_DECL:
-            free(node->VarDecl.var_name); // Free name
-            // Free expression node
-            if (node->VarDecl.expression != NULL) {
-                free_ast_node(node->VarDecl.expression);
-            }
-            break;
-
-        case AST_CONST_DECL:
-            free(node->ConstDecl.const_name); // Free name
-            // Free expression node
-            if (node->ConstDecl.expression != NULL) {
-                free_ast_node(node->ConstDecl.expression);
-            }
-            break;
-
-        case AST_BLOCK:
-            // Free all block nodes recursively
-            for (int i = 0; i < node->Block.node_count; i++) {
-                if (node->Block.nodes[i] != NULL) {
-                    free_ast_node(node->Block.nodes[i]);
-                }
-            }
-            free(node->Block.nodes); // Free array itself
-            break;
-
-        case AST_WHILE:
-            // Free expression
-            if (node->WhileCycle.expression != NULL) {
-                free_ast_node(node->WhileCycle.expression);
-            }
-            // Free while block
-            if (node->WhileCycle.block != NULL) {
-                free_ast_node(node->WhileCycle.block);
-            }
-            // Free element bind
-            if (node->WhileCycle.element_bind != NULL) {
-                free(node->WhileCycle.element_bind);
-            }
-            break;
-
-        case AST_IF_ELSE:
-            // Free expression
-            if (node->IfElse.expression != NULL) {
-                free_ast_node(node->IfElse.expression);
-            }
-            // Free if block
-            if (node->IfElse.if_block != NULL) {
-                free_ast_node(node->IfElse.if_block);
-            }
-            // Free else block
-            if (node->IfElse.else_block != NULL) {
-                free_ast_node(node->IfElse.else_block);
-            }
-            // Free element bind
-            if (node->IfElse.element_bind != NULL) {
-                free(node->IfElse.element_bind);
-            }
-            break;
-
-        case AST_FN_CALL:
-            free(node->FnCall.fn_name); // Free name
-            // Free all arguments recursively
-            for (int i = 0; i < node->FnCall.arg_count; i++) {
-                if (node->FnCall.args[i] != NULL) {
-                    free_ast_node(node->FnCall.args[i]);
-                }
-            }
-            free(node->FnCall.args); // Free array itself
-            break;
-
-        case AST_ARG:
-            // Free expression
-            if (node->Argument.expression != NULL) {
-                free_ast_node(node->Argument.expression);
-            }
-            break;
-
-        default:
-            set_error(INTERNAL_ERROR);
-            fprintf(stderr, "Unknown node type: %d\n", node->type);
-            break;
-    }
-
-    free(node); // Free node itself
-}
-
 int append_decl_to_prog(ASTNode* program_node, ASTNode* decl_node) {
     if (program_node == NULL || decl_node == NULL) {
         set_error(INTERNAL_ERROR);
         return 1;
     }
 
-    // If capacity is reached, double the size of an array
-    if (program_node->Program.decl_count >= program_node->Program.decl_capacity) {
-        program_node->Program.decl_capacity *= 2;
-        ASTNode** new_decl = realloc(program_node->Program.declarations, program_node->Program.decl_capacity * sizeof(ASTNode*));
-        if (new_decl == NULL) {
-            set_error(INTERNAL_ERROR);
-            fprintf(stderr, "Failed to reallocate memory for program node declarations\n");
-            return 1;
-        }
-
-        program_node->Program.declarations = new_decl;
-
+    if (push_child(decl_node) != 0) {
+        return 1;
     }
-    // Append node to declaration pointer array
-    program_node->Program.declarations[program_node->Program.decl_count] = decl_node;
     program_node->Program.decl_count++;
     return 0;
 }
@@ -621,21 +424,9 @@ int append_param_to_fn(ASTNode* fn_node, ASTNode* param_node) {
         return 1;
     }
 
-    // If capacity is reached, double the size of an array
-    if (fn_node->FnDecl.param_count >= fn_node->FnDecl.param_capacity) {
-        fn_node->FnDecl.param_capacity *= 2;
-        ASTNode** new_params = realloc(fn_node->FnDecl.params, fn_node->FnDecl.param_capacity * sizeof(ASTNode*));
-        if (new_params == NULL) {
-            set_error(INTERNAL_ERROR);
-            fprintf(stderr, "Failed to reallocate memory for parameters in function declaration node\n");
-            return 1;
-        }
-
-        fn_node->FnDecl.params = new_params;
-
+    if (push_child(param_node) != 0) {
+        return 1;
     }
-    // Append node to parameter pointer array
-    fn_node->FnDecl.params[fn_node->FnDecl.param_count] = param_node;
     fn_node->FnDecl.param_count++;
     return 0;
 }
@@ -646,19 +437,9 @@ int append_node_to_block(ASTNode* block, ASTNode* node) {
         return 1;
     }
 
-    if (block->Block.node_count >= block->Block.node_capacity) {
-        block->Block.node_capacity *= 2;
-        ASTNode** new_nodes = realloc(block->Block.nodes, block->Block.node_capacity*sizeof(ASTNode*));
-        if (new_nodes == NULL) {
-            set_error(INTERNAL_ERROR);
-            fprintf(stderr, "Failed to reallocate memory for nodes array in block node\n");
-            return 1;
-        }
-
-        block->Block.nodes = new_nodes;
+    if (push_child(node) != 0) {
+        return 1;
     }
-    // Append node to node pointer array
-    block->Block.nodes[block->Block.node_count] = node;
     block->Block.node_count++;
     return 0;
 }
@@ -669,21 +450,54 @@ int append_arg_to_fn(ASTNode* fn_node, ASTNode* arg_node) {
         return 1;
     }
 
-    // If capacity is reached, double the size of an array
-    if (fn_node->FnCall.arg_count >= fn_node->FnCall.arg_capacity) {
-        fn_node->FnCall.arg_capacity *= 2;
-        ASTNode** new_args = realloc(fn_node->FnCall.args, fn_node->FnCall.arg_capacity * sizeof(ASTNode*));
-        if (new_args == NULL) {
+    if (push_child(arg_node) != 0) {
+        return 1;
+    }
+    fn_node->FnCall.arg_count++;
+    return 0;
+}
+
+int close_child_list(ASTNode* node) {
+    if (node == NULL) {
+        set_error(INTERNAL_ERROR);
+        return 1;
+    }
+
+    int count;
+    uint32_t* first;
+    switch (node->type) {
+        case AST_PROGRAM:
+            count = node->Program.decl_count;
+            first = &node->Program.declarations;
+            break;
+        case AST_FN_DECL:
+            count = node->FnDecl.param_count;
+            first = &node->FnDecl.params;
+            break;
+        case AST_BLOCK:
+            count = node->Block.node_count;
+            first = &node->Block.nodes;
+            break;
+        case AST_FN_CALL:
+            count = node->FnCall.arg_count;
+            first = &node->FnCall.args;
+            break;
+        default:
             set_error(INTERNAL_ERROR);
-            fprintf(stderr, "Failed to reallocate memory for arguments in function call node\n");
             return 1;
-        }
-
-        fn_node->FnCall.args = new_args;
+    }
+    if ((uint32_t)count > open_children.count || reserve_children(&ast_children, count) != 0) {
+        set_error(INTERNAL_ERROR);
+        return 1;
+    }
 
+    // Children of the node are on top of the open lists
+    open_children.count -= count;
+    if (count > 0) {
+        memcpy(ast_children.nodes + ast_children.count, open_children.nodes + open_children.count,
+               count * sizeof(ASTNode*));
     }
-    // Append node to parameter pointer array
-    fn_node->FnCall.args[fn_node->FnCall.arg_count] = arg_node;
-    fn_node->FnCall.arg_count++;
+    *first = ast_children.count;
+    ast_children.count += count;
     return 0;
 }
@@ -64,14 +64,7 @@ ASTNode* top_ast_node(ASTNodeStackPtr stack) {
 
 void free_ast_node_stack(ASTNodeStackPtr stack) {
     if (stack != NULL) {
-        // Free any ASTNodes in the stack
-        while (!is_empty_ast_node_stack(stack)) {
-            ASTNode* node = pop_ast_node(stack);
-            if (node) {
-                free_ast_node(node);
-            }
-        }
-
+        // Nodes left in the stack are owned by the AST arena
         // Free the array of ASTNode* pointers
         if (stack->arr != NULL) {
             free(stack->arr);
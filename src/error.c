@@ -6,7 +6,7 @@
 
 #include "error.h"
 
-ErrorType error_tracker = NO_ERROR;
+_Thread_local ErrorType error_tracker = NO_ERROR;
 
 void set_error(ErrorType error) {
     // set new error only if no error was encoutered before
@@ -7,6 +7,9 @@
 #include <setjmp.h>
 #include "generator.h"
 #include "generator_instructions.h"
+#include "intern.h"
+#include "ir.h"
+#include "peephole.h"
 
 jmp_buf error_buf;                  // Buffer for error handling
 
@@ -19,6 +22,13 @@ static int if_counter = 1420;       // Initial numbering for unique labels used
 static int while_counter = 1420;    // Initial numbering for unique labels used in while loops
 int tmp_counter = 128;              // Initial numbering for unique temporary variables
 
+#define THREE_ADDRESS_MAX_DEPTH 3   // Maximum depth of arithmetic expressions lowered to three-address code
+
+#define SUBSTRING_HELPER "$substring"   // Label of the shared ifj.substring routine
+#define STRCMP_HELPER "$strcmp"         // Label of the shared ifj.strcmp routine
+static bool substring_used = false;     // ifj.substring was called, its routine is emitted at the end
+static bool strcmp_used = false;        // ifj.strcmp was called, its routine is emitted at the end
+
 /**
  * @brief Error handler for the generator.
  */
@@ -44,7 +54,7 @@ void increment_tmp_counter() {
 /**
  * @brief Global stack structure for managing nested while loops.
  */
-WhileStack while_stack = { .top = NULL };
+WhileStack while_stack = { .loops = NULL, .size = 0, .capacity = 0 };
 
 
 /**
@@ -52,32 +62,20 @@ WhileStack while_stack = { .top = NULL };
  * @return Number of while loops currently in the stack.
  */
 int while_stack_size() {
-    int size = 0;
-    WhileStackNode *current = while_stack.top;
-    while (current != NULL) {
-        size++;
-        current = current->next;
-    }
-    return size;
+    return while_stack.size;
 }
 
 /**
  * @brief Retrieve the while loop identifier at a specific index in the stack.
- * @param index Index in the stack (0 is the bottom).
+ * @param index Index in the stack (0 is the top).
  * @return Identifier of the while loop at the given index.
  */
 int get_while_at_index(int index) {
-    int i = 0;
-    WhileStackNode *current = while_stack.top;
-    while (current != NULL) {
-        if (i == index) {
-            return current->while_number;
-        }
-        i++;
-        current = current->next;
+    if (index < 0 || index >= while_stack.size) {
+        fprintf(stderr, "Chyba: Index mimo rozsahu zásobníka while.\n");
+        exit(99);
     }
-    fprintf(stderr, "Chyba: Index mimo rozsahu zásobníka while.\n");
-    exit(99);
+    return while_stack.loops[while_stack.size - 1 - index].while_number;
 }
 
 /**
@@ -85,27 +83,28 @@ int get_while_at_index(int index) {
  * @param while_number The unique identifier for the while loop.
  */
 void add_while_stack(int while_number) {
-    WhileStackNode *new_node = (WhileStackNode *)malloc(sizeof(WhileStackNode));
-    if (!new_node) {
-        fprintf(stderr, "Chyba: Nepodarilo sa alokovať pamäť pre uzol zásobníka.\n");
-        exit(99);
+    if (while_stack.size == while_stack.capacity) {
+        int capacity = while_stack.capacity ? while_stack.capacity * 2 : 16;
+        LoopContext *loops = realloc(while_stack.loops, capacity * sizeof(LoopContext));
+        if (!loops) {
+            fprintf(stderr, "Chyba: Nepodarilo sa alokovať pamäť pre zásobník while.\n");
+            exit(99);
+        }
+        while_stack.loops = loops;
+        while_stack.capacity = capacity;
     }
-    new_node->while_number = while_number;
-    new_node->next = while_stack.top;
-    while_stack.top = new_node;
+    while_stack.loops[while_stack.size++] = (LoopContext){ .while_number = while_number };
 }
 
 /**
  * @brief Remove the topmost while loop identifier from the global stack.
  */
 void remove_while_stack() {
-    if (while_stack.top == NULL) {
+    if (while_stack.size == 0) {
         fprintf(stderr, "Chyba: Zásobník while cyklov je prázdny.\n");
         exit(99);
     }
-    WhileStackNode *temp = while_stack.top;
-    while_stack.top = while_stack.top->next;
-    free(temp);
+    while_stack.size--;
 }
 
 /**
@@ -113,118 +112,445 @@ void remove_while_stack() {
  * @return Identifier of the current while loop.
  */
 int actual_while() {
-    if (while_stack.top == NULL) {
+    if (while_stack.size == 0) {
         fprintf(stderr, "Chyba: Zásobník while cyklov je prázdny.\n");
         exit(99);
     }
-    return while_stack.top->while_number;
+    return while_stack.loops[while_stack.size - 1].while_number;
 }
 
 /**
  * @brief Free the entire while stack, releasing all allocated memory.
  */
 void free_while_stack() {
-    WhileStackNode *current = while_stack.top;
-    while (current) {
-        WhileStackNode *temp = current;
-        current = current->next;
-        free(temp);
-    }
-    while_stack.top = NULL;
+    free(while_stack.loops);
+    while_stack.loops = NULL;
+    while_stack.size = 0;
+    while_stack.capacity = 0;
 }
 
 /**
- * @brief Dynamic array structure for managing variables in the local frame.
+ * @brief Hash set of variables defined in the local frame of the current function.
+ *
+ * Names are interned, so they are hashed by their precomputed hash and compared by pointer.
+ * Slot is occupied only if it was filled in the current generation, clearing the set
+ * between functions just starts a new generation.
  */
-typedef struct LocalFrameArray {
-    char **variables;    ///< Array of variable names.
-    size_t size;         ///< Current number of variables.
-    size_t capacity;     ///< Capacity of the array.
-} LocalFrameArray;
+typedef struct LocalFrameSet {
+    const char **variables; ///< Open addressing slots of interned variable names.
+    unsigned *generations;  ///< Generation in which the slot was filled.
+    const char **order;     ///< Variables in order of declaration, used to emit DEFVARs.
+    unsigned generation;    ///< Current generation, slots of older generations are empty.
+    size_t size;            ///< Current number of variables.
+    size_t capacity;        ///< Number of slots (power of two), order holds half of it.
+} LocalFrameSet;
 
 /**
- * @brief Global dynamic local frame for managing local variables.
+ * @brief Global local frame set for managing local variables.
  */
-static LocalFrameArray local_frame = {NULL, 0, 0};
+static LocalFrameSet local_frame = {NULL, NULL, NULL, 0, 0, 0};
 
 /**
- * @brief Initialize the dynamic local frame array.
+ * @brief Allocate slots and order list for the current capacity of the local frame set.
  */
-void init_local_frame() {
-    local_frame.size = 0;
-    local_frame.capacity = 8; // Počiatočná kapacita
+static void alloc_local_frame() {
     local_frame.variables = malloc(local_frame.capacity * sizeof(char *));
-    if (local_frame.variables == NULL) {
+    local_frame.generations = calloc(local_frame.capacity, sizeof(unsigned));
+    local_frame.order = realloc(local_frame.order, local_frame.capacity / 2 * sizeof(char *));
+    if (local_frame.variables == NULL || local_frame.generations == NULL || local_frame.order == NULL) {
         generator_error_handler(99);
     }
 }
 
 /**
- * @brief Free all memory associated with the dynamic local frame array.
+ * @brief Initialize the local frame set.
+ */
+void init_local_frame() {
+    local_frame.size = 0;
+    local_frame.generation = 1;
+    local_frame.capacity = 64; // Initial capacity (power of two)
+    alloc_local_frame();
+}
+
+/**
+ * @brief Free all memory associated with the local frame set.
  */
 void free_local_frame() {
-    for (size_t i = 0; i < local_frame.size; ++i) {
-        free(local_frame.variables[i]);
-    }
     free(local_frame.variables);
+    free(local_frame.generations);
+    free(local_frame.order);
     local_frame.variables = NULL;
+    local_frame.generations = NULL;
+    local_frame.order = NULL;
     local_frame.size = 0;
     local_frame.capacity = 0;
 }
 
 /**
- * @brief Clear all variables in the local frame without deallocating the array.
+ * @brief Clear all variables in the local frame without touching the slots.
  */
 void clear_local_frame() {
-    for (size_t i = 0; i < local_frame.size; ++i) {
-        free(local_frame.variables[i]);
-    }
     local_frame.size = 0;
+    local_frame.generation++;
 }
 
 /**
- * @brief Add a variable to the local frame array.
- * @param var_name Name of the variable to add.
+ * @brief Find slot of a variable, or the empty slot where it belongs.
+ * @param var_name Interned name of the variable.
+ * @return Index of the slot.
  */
-void add_to_local(const char* var_name) {
-    // Check if the variable already exists
+static size_t find_local(const char* var_name) {
+    size_t mask = local_frame.capacity - 1;
+    size_t index = intern_hash(var_name) & mask;
+    while (local_frame.generations[index] == local_frame.generation && local_frame.variables[index] != var_name) {
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+/**
+ * @brief Double the number of slots and reinsert variables of the current generation.
+ */
+static void grow_local_frame() {
+    free(local_frame.variables);
+    free(local_frame.generations);
+    local_frame.capacity *= 2;
+    alloc_local_frame();
+
     for (size_t i = 0; i < local_frame.size; ++i) {
-        if (strcmp(local_frame.variables[i], var_name) == 0) {
-            return; // Variable already exists, no need to add it
-        }
+        size_t index = find_local(local_frame.order[i]);
+        local_frame.variables[index] = local_frame.order[i];
+        local_frame.generations[index] = local_frame.generation;
     }
+}
 
-    // Expand the array if necessary
-    if (local_frame.size >= local_frame.capacity) {
-        local_frame.capacity *= 2; // Double the capacity
-        local_frame.variables = realloc(local_frame.variables, local_frame.capacity * sizeof(char *));
-        if (local_frame.variables == NULL) {
-            generator_error_handler(99);
-        }
+/**
+ * @brief Add a variable to the local frame set.
+ * @param var_name Interned name of the variable to add.
+ */
+void add_to_local(const char* var_name) {
+    // Keep load factor under 0.5
+    if ((local_frame.size + 1) * 2 > local_frame.capacity) {
+        grow_local_frame();
     }
 
-    // Add the new variable with dynamic allocation
-    size_t name_length = strlen(var_name) + 1; // Include null terminator
-    local_frame.variables[local_frame.size] = malloc(name_length);
-    if (local_frame.variables[local_frame.size] == NULL) {
-        generator_error_handler(99);
+    size_t index = find_local(var_name);
+    if (local_frame.generations[index] == local_frame.generation) {
+        return; // Variable already exists, no need to add it
     }
-    strncpy(local_frame.variables[local_frame.size], var_name, name_length);
-    local_frame.size++;
+    local_frame.variables[index] = var_name;
+    local_frame.generations[index] = local_frame.generation;
+    local_frame.order[local_frame.size++] = var_name;
 }
 
 /**
  * @brief Check if a variable exists in the local frame.
- * @param var_name Name of the variable to check.
+ * @param var_name Interned name of the variable to check.
  * @return true if the variable exists, false otherwise.
  */
 bool is_it_local(const char* var_name) {
+    return local_frame.generations[find_local(var_name)] == local_frame.generation;
+}
+
+/**
+ * @brief Emit DEFVAR for every variable in the local frame, in order of declaration.
+ */
+void def_local_frame() {
     for (size_t i = 0; i < local_frame.size; ++i) {
-        if (strcmp(local_frame.variables[i], var_name) == 0) {
-            return true; // Variable exists
+        instruction(IR_DEFVAR);
+        operand_var(local_frame.order[i]);
+    }
+}
+
+/**
+ * @brief Append an instruction jumping to (or a label of) the body of a function.
+ * @param opcode IR_LABEL or IR_JUMP.
+ * @param fn_name Name of the function.
+ */
+static void body_label(IROpcode opcode, const char* fn_name) {
+    size_t length = strlen(fn_name) + 6; // "$" fn_name "$body"
+    char* name = malloc(length + 1);
+    if (name == NULL) {
+        generator_error_handler(99);
+    }
+    snprintf(name, length + 1, "$%s$body", fn_name);
+    instruction(opcode);
+    ir_operand(IR_OPERAND_LABEL, ir_name(intern(name, length)));
+    free(name);
+}
+
+/**
+ * @brief Generate code for a function with all its DEFVARs executed once at the entry.
+ *
+ * Variables are collected while the body is generated, so the entry of the function
+ * (label, frame and DEFVARs) is placed after the body and jumps back to it.
+ * @param fn_decl Function declaration node.
+ */
+static void generate_function(ASTNode* fn_decl) {
+    const char* fn_name = fn_decl->FnDecl.fn_name;
+
+    body_label(IR_LABEL, fn_name);
+    generate_code_in_node(fn_decl);
+    gen_pop_frame();
+    if (strcmp(fn_name, "main") == 0) {
+        instruction(IR_EXIT);
+        operand_int(0);
+    } else {
+        return_f();
+    }
+
+    // entry of the function
+    label(fn_name);
+    gen_create_frame();
+    gen_push_frame();
+    def_local_frame();
+    body_label(IR_JUMP, fn_name);
+    print_new_line();
+    clear_local_frame();
+}
+
+/**
+ * @brief Get the data type of an expression recorded by semantic analysis.
+ * @param node Expression node.
+ * @return Data type of the expression, AST_UNSPECIFIED for null or if it was not analyzed.
+ */
+static DataType expression_type(ASTNode* node) {
+    return (DataType)node->expr.data_type;
+}
+
+/**
+ * @brief Write a numeric literal operand converted to the type of the variable it is stored in.
+ * @param node Integer or float literal node.
+ * @param data_type Type of the variable, AST_UNSPECIFIED keeps the type of the literal.
+ */
+static void print_number(ASTNode* node, DataType data_type) {
+    if (node->type == AST_INT && data_type != AST_F64) {
+        operand_int(node->Integer.number);
+    } else if (node->type == AST_INT) {
+        operand_float((double)node->Integer.number);
+    } else if (data_type == AST_I32) {
+        operand_int((int)node->Float.number);
+    } else {
+        operand_float(node->Float.number);
+    }
+}
+
+/**
+ * @brief Generate code for an operand of a binary operation.
+ * @param node Operand node.
+ * @param to_float Convert the integer operand to float.
+ */
+static void generate_operand(ASTNode* node, bool to_float) {
+    if (to_float && node->type == AST_INT) {
+        instruction(IR_PUSHS);
+        operand_float((double)node->Integer.number);
+        return;
+    }
+    generate_code_in_node(node);
+    if (to_float) {
+        instruction(IR_INT2FLOATS);
+    }
+}
+
+/**
+ * @brief Check if an expression can be computed by three-address instructions without the data stack.
+ *
+ * Variables and numeric literals are used as operands directly, arithmetic operations
+ * up to the given depth keep their intermediate results in register variables.
+ * @param node Expression node.
+ * @param depth Maximum number of nested operations.
+ * @return true if the expression can be lowered.
+ */
+static bool is_three_address(ASTNode* node, int depth) {
+    switch (node->type) {
+        case AST_IDENTIFIER:
+        case AST_INT:
+        case AST_FLOAT:
+            return true;
+        case AST_BIN_OP:
+            switch (node->BinaryOperator.operator) {
+                case AST_PLUS:
+                case AST_MINUS:
+                case AST_MUL:
+                case AST_DIV:
+                    return depth > 0 &&
+                           is_three_address(node->BinaryOperator.left, depth - 1) &&
+                           is_three_address(node->BinaryOperator.right, depth - 1);
+                default:
+                    return false;
+            }
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Get the register variable with the given number, it is defined in the current function.
+ * @param reg Number of the register.
+ * @return Interned name of the register variable.
+ */
+static const char* register_var(int reg) {
+    const char* name = temp_name("tmp_reg_", reg);
+    def_var(name);
+    return name;
+}
+
+/**
+ * @brief Operand of a three-address instruction, a literal or variable node or a register variable.
+ */
+typedef struct ThreeAddressOperand {
+    ASTNode* node;      ///< Literal or identifier used directly, NULL if the value is in var.
+    const char* var;    ///< Register variable holding the value.
+    bool to_float;      ///< Integer literal node is written as float.
+} ThreeAddressOperand;
+
+static void lower_binary(ASTNode* node, const char* result, int reg);
+
+/**
+ * @brief Prepare an operand of a three-address instruction, nested operation is computed into a register.
+ * @param node Operand node, accepted by is_three_address().
+ * @param to_float Convert the integer operand to float.
+ * @param reg Number of the first free register.
+ * @return The operand.
+ */
+static ThreeAddressOperand lower_operand(ASTNode* node, bool to_float, int reg) {
+    if (node->type != AST_BIN_OP && (!to_float || node->type == AST_INT)) {
+        return (ThreeAddressOperand){ .node = node, .var = NULL, .to_float = to_float };
+    }
+
+    const char* var = register_var(reg);
+    if (node->type == AST_BIN_OP) {
+        lower_binary(node, var, reg);
+        if (to_float) {
+            instruction(IR_INT2FLOAT);
+            operand_var(var);
+            operand_var(var);
         }
+    } else {
+        instruction(IR_INT2FLOAT);
+        operand_var(var);
+        operand_var(node->Identifier.identifier);
     }
-    return false;  // Variable does not exist
+    return (ThreeAddressOperand){ .node = NULL, .var = var, .to_float = false };
+}
+
+/**
+ * @brief Append an operand prepared by lower_operand().
+ * @param operand The operand.
+ */
+static void append_operand(ThreeAddressOperand operand) {
+    if (operand.var != NULL) {
+        operand_var(operand.var);
+    } else if (operand.node->type == AST_IDENTIFIER) {
+        operand_var(operand.node->Identifier.identifier);
+    } else {
+        print_number(operand.node, operand.to_float ? AST_F64 : AST_UNSPECIFIED);
+    }
+}
+
+/**
+ * @brief Prepare both operands of a binary operation, integer operand is converted if the other one is float.
+ * @param node Binary operation node.
+ * @param reg Number of the first free register.
+ * @param left Prepared left operand.
+ * @param right Prepared right operand.
+ * @return true if the operation is done in floats.
+ */
+static bool lower_operands(ASTNode* node, int reg, ThreeAddressOperand* left, ThreeAddressOperand* right) {
+    DataType left_type = expression_type(node->BinaryOperator.left);
+    DataType right_type = expression_type(node->BinaryOperator.right);
+    bool is_float = left_type == AST_F64 || right_type == AST_F64;
+    *left = lower_operand(node->BinaryOperator.left, is_float && left_type == AST_I32, reg);
+    *right = lower_operand(node->BinaryOperator.right, is_float && right_type == AST_I32, left->var != NULL ? reg + 1 : reg);
+    return is_float;
+}
+
+/**
+ * @brief Generate three-address code of an arithmetic operation storing its result into a variable.
+ * @param node Binary operation node, accepted by is_three_address().
+ * @param result Variable for the result, it may be an operand of the operation.
+ * @param reg Number of the first free register.
+ */
+static void lower_binary(ASTNode* node, const char* result, int reg) {
+    ThreeAddressOperand left, right;
+    bool is_float = lower_operands(node, reg, &left, &right);
+
+    switch (node->BinaryOperator.operator) {
+        case AST_PLUS: instruction(IR_ADD); break;
+        case AST_MINUS: instruction(IR_SUB); break;
+        case AST_MUL: instruction(IR_MUL); break;
+        case AST_DIV: instruction(is_float ? IR_DIV : IR_IDIV); break;
+        default:
+            generator_error_handler(12);
+    }
+    operand_var(result);
+    append_operand(left);
+    append_operand(right);
+}
+
+/**
+ * @brief Generate an arithmetic expression storing its result into a variable.
+ * Shallow expressions are lowered to three-address code, others go through the data stack.
+ * @param node Binary operation node.
+ * @param result Variable for the result.
+ */
+static void generate_binary_into(ASTNode* node, const char* result) {
+    if (is_three_address(node, THREE_ADDRESS_MAX_DEPTH)) {
+        lower_binary(node, result, 0);
+        return;
+    }
+    generate_code_in_node(node);
+    pops(result);
+}
+
+/**
+ * @brief Generate a jump taken when a comparison of shallow expressions is false.
+ * @param node Condition of an if statement or a while loop.
+ * @param prefix Name of the label without the number.
+ * @param number Unique number of the label.
+ * @return true if the jump was generated, false if the condition has to be evaluated on the data stack.
+ */
+static bool generate_false_jump(ASTNode* node, const char* prefix, int number) {
+    if (node->type != AST_BIN_OP ||
+        !is_three_address(node->BinaryOperator.left, THREE_ADDRESS_MAX_DEPTH - 1) ||
+        !is_three_address(node->BinaryOperator.right, THREE_ADDRESS_MAX_DEPTH - 1)) {
+        return false;
+    }
+
+    IROpcode compare;
+    bool jump_if = false; // Value of the comparison for which the jump is taken
+    switch (node->BinaryOperator.operator) {
+        case AST_GREATER: compare = IR_GT; break;
+        case AST_GREATER_EQU: compare = IR_LT; jump_if = true; break;
+        case AST_LESS: compare = IR_LT; break;
+        case AST_LESS_EQU: compare = IR_GT; jump_if = true; break;
+        case AST_EQU: compare = IR_JUMPIFNEQ; break;
+        case AST_NOT_EQU: compare = IR_JUMPIFEQ; break;
+        default:
+            return false;
+    }
+
+    ThreeAddressOperand left, right;
+    lower_operands(node, 0, &left, &right);
+    if (compare == IR_JUMPIFEQ || compare == IR_JUMPIFNEQ) {
+        instruction(compare);
+        operand_label(prefix, number);
+        append_operand(left);
+        append_operand(right);
+        return true;
+    }
+
+    // Result of the comparison replaces the operands in the first register
+    const char* var = register_var(0);
+    instruction(compare);
+    operand_var(var);
+    append_operand(left);
+    append_operand(right);
+    instruction(IR_JUMPIFEQ);
+    operand_label(prefix, number);
+    operand_var(var);
+    operand_bool(jump_if);
+    return true;
 }
 
 /**
@@ -238,34 +564,16 @@ void generate_code_in_node(ASTNode* node){
         case AST_PROGRAM:
             // Code generation for the entire program
             for (int i = 0; i < node->Program.decl_count; ++i) {
-                if (strcmp(node->Program.declarations[i]->FnDecl.fn_name, "main") == 0) {
-                    label("main");
-                    gen_create_frame();
-                    gen_push_frame();
-                    generate_code_in_node(node->Program.declarations[i]);  // generating `main` function body
-                    gen_pop_frame();
-                    printf("EXIT int@0\n");
-                    print_new_line();
-                }
-                else {
-                    label(node->Program.declarations[i]->FnDecl.fn_name);
-                    gen_create_frame();
-                    gen_push_frame();
-                    generate_code_in_node(node->Program.declarations[i]);  // generating other functions body
-                    gen_pop_frame();
-                    return_f();
-                    print_new_line();
-                    clear_local_frame();
-                }
+                generate_function(ast_child(node->Program.declarations, i));
             }
             break;
 
         case AST_FN_DECL:
             // Code generation for function declarations
             for (int i = 0; i < node->FnDecl.param_count; ++i) {
-                def_var(node->FnDecl.params[i]->Param.identifier);
-                add_to_local(node->FnDecl.params[i]->Param.identifier);
-                pops(node->FnDecl.params[i]->Param.identifier);
+                def_var(ast_child(node->FnDecl.params, i)->Param.identifier);
+                add_to_local(ast_child(node->FnDecl.params, i)->Param.identifier);
+                pops(ast_child(node->FnDecl.params, i)->Param.identifier);
             }
             generate_code_in_node(node->FnDecl.block);
             break;
@@ -286,40 +594,42 @@ void generate_code_in_node(ASTNode* node){
             // Check if the variable has an initialization expression.
             if (node->ConstDecl.expression) {
                 // Handle different types of initialization expressions.
-                if (node->VarDecl.expression->type == AST_INT) {
-                    printf("MOVE %s%s int@%d\n", frame_prefix(node->VarDecl.var_name), node->VarDecl.var_name,
-                           node->VarDecl.expression->Integer.number);
-                    break;
-                } else if (node->VarDecl.expression->type == AST_FLOAT) {
-                    printf("MOVE %s%s float@%a\n", frame_prefix(node->VarDecl.var_name), node->VarDecl.var_name,
-                           node->VarDecl.expression->Float.number);
+                if (node->VarDecl.expression->type == AST_INT || node->VarDecl.expression->type == AST_FLOAT) {
+                    // Literal is stored in the declared type
+                    instruction(IR_MOVE);
+                    operand_var(node->VarDecl.var_name);
+                    print_number(node->VarDecl.expression, node->VarDecl.data_type);
                     break;
                 } else if (node->VarDecl.expression->type == AST_STRING) {
-                    char *escape_string_string = escape_string(node->VarDecl.expression->String.string);
-                    printf("MOVE %s%s string@%s\n", frame_prefix(node->VarDecl.var_name), node->VarDecl.var_name,
-                           escape_string_string);
-                    free(escape_string_string);
+                    instruction(IR_MOVE);
+                    operand_var(node->VarDecl.var_name);
+                    operand_string(node->VarDecl.expression->String.string);
                     break;
                 } else if (node->VarDecl.expression->type == AST_BIN_OP) {
-                    printf("PUSHS int@1\n");
-                    generate_code_in_node(node->VarDecl.expression);
-                    pops(node->VarDecl.var_name);
+                    generate_binary_into(node->VarDecl.expression, node->VarDecl.var_name);
 
                     break;
                 }
                 // Handle function calls and built-in functions.
                 if (strcmp(node->ConstDecl.expression->FnCall.fn_name, "ifj.string") == 0) {
-                    printf("MOVE LF@%s string@%s\n", node->ConstDecl.const_name,
-                           escape_string(node->ConstDecl.expression->FnCall.args[0]->Argument.expression->String.string));
+                    instruction(IR_MOVE);
+                    operand_var(node->ConstDecl.const_name);
+                    operand_string(ast_child(node->ConstDecl.expression->FnCall.args, 0)->Argument.expression->String.string);
 
                 } else if (strcmp(node->ConstDecl.expression->FnCall.fn_name, "ifj.readstr") == 0) {
-                    printf("READ %s%s string\n", frame_prefix(node->VarDecl.var_name), node->VarDecl.var_name);
+                    instruction(IR_READ);
+                    operand_var(node->VarDecl.var_name);
+                    operand_type(IR_TYPE_STRING);
 
                 } else if (strcmp(node->ConstDecl.expression->FnCall.fn_name, "ifj.readi32") == 0) {
-                    printf("READ %s%s int\n", frame_prefix(node->VarDecl.var_name), node->VarDecl.var_name);
+                    instruction(IR_READ);
+                    operand_var(node->VarDecl.var_name);
+                    operand_type(IR_TYPE_INT);
 
                 } else if (strcmp(node->ConstDecl.expression->FnCall.fn_name, "ifj.readf64") == 0) {
-                    printf("READ %s%s float\n", frame_prefix(node->VarDecl.var_name), node->VarDecl.var_name);
+                    instruction(IR_READ);
+                    operand_var(node->VarDecl.var_name);
+                    operand_type(IR_TYPE_FLOAT);
 
                 } else {
                     generate_code_in_node(node->ConstDecl.expression);
@@ -331,7 +641,7 @@ void generate_code_in_node(ASTNode* node){
         case AST_BLOCK:
             // Process a block of statements.
             for (int i = 0; i < node->Block.node_count; ++i) {
-                ASTNode* block_node = node->Block.nodes[i];
+                ASTNode* block_node = ast_child(node->Block.nodes, i);
                 // Special handling for string concatenation
                 if (block_node->type == AST_CONST_DECL || block_node->type == AST_VAR_DECL) {
                     if (block_node->VarDecl.expression &&
@@ -342,8 +652,8 @@ void generate_code_in_node(ASTNode* node){
                                              ? block_node->ConstDecl.const_name
                                              : block_node->VarDecl.var_name;
 
-                        const char* arg1 = block_node->VarDecl.expression->FnCall.args[0]->Argument.expression->Identifier.identifier;
-                        const char* arg2 = block_node->VarDecl.expression->FnCall.args[1]->Argument.expression->Identifier.identifier;
+                        const char* arg1 = ast_child(block_node->VarDecl.expression->FnCall.args, 0)->Argument.expression->Identifier.identifier;
+                        const char* arg2 = ast_child(block_node->VarDecl.expression->FnCall.args, 1)->Argument.expression->Identifier.identifier;
 
                         if (!(is_it_local(result))) {
                             def_var(result);
@@ -364,16 +674,18 @@ void generate_code_in_node(ASTNode* node){
                                              ? block_node->ConstDecl.const_name
                                              : block_node->VarDecl.var_name;
 
-                        const char* arg1 = block_node->VarDecl.expression->FnCall.args[0]->Argument.expression->Identifier.identifier;
+                        const char* arg1 = ast_child(block_node->VarDecl.expression->FnCall.args, 0)->Argument.expression->Identifier.identifier;
 
                         if (!(is_it_local(result))) {
                             def_var(result);
                             add_to_local(result);
                         }
-                        if(block_node->VarDecl.expression->FnCall.args[0]->type == AST_ARG){
+                        if(ast_child(block_node->VarDecl.expression->FnCall.args, 0)->type == AST_ARG){
 
                         }
-                        printf("STRLEN %s%s %s%s\n", frame_prefix(result), result, frame_prefix(arg1), arg1);
+                        instruction(IR_STRLEN);
+                        operand_var(result);
+                        operand_var(arg1);
                         generate_code_in_node(block_node);
                         continue;
                     }
@@ -386,200 +698,116 @@ void generate_code_in_node(ASTNode* node){
             const char *fn_name = node->FnCall.fn_name;
             // Handle built-in functions
             if (strcmp(fn_name, "ifj.length") == 0) {
-                generate_code_in_node(node->FnCall.args[0]->Argument.expression);
-                char temp_var[32];
-                snprintf(temp_var, sizeof(temp_var), "tmp_length_%d", tmp_counter++);
+                generate_code_in_node(ast_child(node->FnCall.args, 0)->Argument.expression);
+                const char* temp_var = temp_name("tmp_length_", tmp_counter++);
                 def_var(temp_var);
-                printf("STRLEN LF@%s %s%s\n", temp_var,
-                       frame_prefix(node->FnCall.args[0]->Argument.expression->Identifier.identifier),
-                       node->FnCall.args[0]->Argument.expression->Identifier.identifier);
-                printf("PUSHS LF@%s\n", temp_var);
+                instruction(IR_STRLEN);
+                operand_var(temp_var);
+                operand_var(ast_child(node->FnCall.args, 0)->Argument.expression->Identifier.identifier);
+                pushs(temp_var);
                 break;
             }
             if (strcmp(fn_name, "ifj.substring") == 0) {
-                // Generate code for the arguments
-                generate_code_in_node(node->FnCall.args[0]->Argument.expression); // s
-                generate_code_in_node(node->FnCall.args[1]->Argument.expression); // i
-                generate_code_in_node(node->FnCall.args[2]->Argument.expression); // j
-
-                // Create temporary variables for the arguments
-                char temp_s[32], temp_i[32], temp_j[32], temp_result[32], temp_char[32];
-                snprintf(temp_s, sizeof(temp_s), "tmp_s_%d", tmp_counter);
-                snprintf(temp_i, sizeof(temp_i), "tmp_i_%d", tmp_counter);
-                snprintf(temp_j, sizeof(temp_j), "tmp_j_%d", tmp_counter);
-                snprintf(temp_char, sizeof(temp_char), "tmp_char_%d", tmp_counter);
-                snprintf(temp_result, sizeof(temp_result), "tmp_result_%d", tmp_counter);
-
-                def_var(temp_s);
-                def_var(temp_i);
-                def_var(temp_j);
-                def_var(temp_char);
-                def_var(temp_result);
-
-
-                // Pop arguments from the stack
-                printf("POPS LF@%s\n", temp_j);
-                printf("POPS LF@%s\n", temp_i);
-                printf("POPS LF@%s\n", temp_s);
-
-                printf("MOVE LF@%s string@\n", temp_result);
-
-                // Check if the arguments are valid
-                printf("LABEL substring_loop_start_%i\n", while_counter);
-                printf("PUSHS LF@%s\n", temp_i);
-                printf("PUSHS LF@%s\n", temp_j);
-                printf("LTS\n");
-                printf("PUSHS bool@false\n");
-                printf("JUMPIFEQS substring_loop_end_%i\n", while_counter);
-
-                printf("GETCHAR LF@%s LF@%s LF@%s\n", temp_char, temp_s, temp_i); // Získanie znaku na indexe `i`
-                printf("CONCAT LF@%s LF@%s LF@%s\n", temp_result, temp_result, temp_char); // Pridanie znaku do výsledku
-                printf("ADD LF@%s LF@%s int@1\n", temp_i, temp_i); // Zvýšenie `i`
-                printf("JUMP substring_loop_start_%i\n", while_counter);
-
-                printf("LABEL substring_loop_end_%i\n", while_counter);
-                printf("PUSHS LF@%s\n", temp_result); // Push výsledný substring na zásobník
-
-
-                while_counter++;
+                // Arguments s, i and j are passed to the shared helper on the stack, it pushes the substring
+                generate_code_in_node(ast_child(node->FnCall.args, 2)->Argument.expression); // j
+                generate_code_in_node(ast_child(node->FnCall.args, 1)->Argument.expression); // i
+                generate_code_in_node(ast_child(node->FnCall.args, 0)->Argument.expression); // s
+                call(SUBSTRING_HELPER);
+                substring_used = true;
                 break;
             }
             if (strcmp(fn_name, "ifj.strcmp") == 0) {
-                // Generate code for both string arguments
-                generate_code_in_node(node->FnCall.args[0]->Argument.expression);
-                generate_code_in_node(node->FnCall.args[1]->Argument.expression);
-
-                // Create a temporary variable for comparison result
-                char temp_var[32];
-                snprintf(temp_var, sizeof(temp_var), "tmp_cmp_%d", tmp_counter);
-                def_var(temp_var);
-                char temp_label_equal[32], temp_label_greater[32], temp_label_end[32];
-                snprintf(temp_label_equal, sizeof(temp_label_equal), "strcmp_equal_%d", tmp_counter);
-                snprintf(temp_label_greater, sizeof(temp_label_greater), "strcmp_greater_%d", tmp_counter);
-                snprintf(temp_label_end, sizeof(temp_label_end), "strcmp_end_%d", tmp_counter);
-                tmp_counter++;
-
-
-                // Compare the strings
-                printf("JUMPIFEQS %s\n", temp_label_equal);
-
-                // If s1 < s2
-                printf("LT LF@%s %s%s %s%s\n", temp_var,
-                       frame_prefix(node->FnCall.args[0]->Argument.expression->Identifier.identifier),
-                       node->FnCall.args[0]->Argument.expression->Identifier.identifier,
-                       frame_prefix(node->FnCall.args[1]->Argument.expression->Identifier.identifier),
-                       node->FnCall.args[1]->Argument.expression->Identifier.identifier);
-                printf("PUSHS LF@%s\n", temp_var);
-                printf("PUSHS bool@true\n");
-                printf("JUMPIFNEQS %s\n", temp_label_greater);
-
-                // Set temp_var to -1 (s1 < s2)
-                printf("MOVE LF@%s int@-1\n", temp_var);
-                printf("JUMP %s\n", temp_label_end);
-
-                // If s1 == s2
-                printf("LABEL %s\n", temp_label_equal);
-                printf("MOVE LF@%s int@0\n", temp_var);
-                printf("JUMP %s\n", temp_label_end);
-
-                // If s1 > s2
-                printf("LABEL %s\n", temp_label_greater);
-                printf("MOVE LF@%s int@1\n", temp_var);
-
-                // End label
-                printf("LABEL %s\n", temp_label_end);
-
-                // Push the result
-                printf("PUSHS LF@%s\n", temp_var);
+                // Both strings are passed to the shared helper on the stack, it pushes -1, 0 or 1
+                generate_code_in_node(ast_child(node->FnCall.args, 1)->Argument.expression);
+                generate_code_in_node(ast_child(node->FnCall.args, 0)->Argument.expression);
+                call(STRCMP_HELPER);
+                strcmp_used = true;
                 break;
             }
             if (strcmp(fn_name, "ifj.ord") == 0) {
                 // Generate code for string and index
-                generate_code_in_node(node->FnCall.args[0]->Argument.expression);
-                generate_code_in_node(node->FnCall.args[1]->Argument.expression);
+                generate_code_in_node(ast_child(node->FnCall.args, 0)->Argument.expression);
+                generate_code_in_node(ast_child(node->FnCall.args, 1)->Argument.expression);
 
                 // Create a temporary variable for the result
-                char temp_var[32];
-                snprintf(temp_var, sizeof(temp_var), "tmp_ord_%d", tmp_counter++);
+                const char* temp_var = temp_name("tmp_ord_", tmp_counter++);
                 def_var(temp_var);
 
                 // Get the character and convert to ASCII
-                printf("STRI2INT LF@%s %s%s %s%s\n", temp_var,
-                       frame_prefix(node->FnCall.args[0]->Argument.expression->Identifier.identifier),
-                       node->FnCall.args[0]->Argument.expression->Identifier.identifier,
-                       frame_prefix(node->FnCall.args[1]->Argument.expression->Identifier.identifier),
-                       node->FnCall.args[1]->Argument.expression->Identifier.identifier);
+                instruction(IR_STRI2INT);
+                operand_var(temp_var);
+                operand_var(ast_child(node->FnCall.args, 0)->Argument.expression->Identifier.identifier);
+                operand_var(ast_child(node->FnCall.args, 1)->Argument.expression->Identifier.identifier);
 
                 // Push the result
-                printf("PUSHS LF@%s\n", temp_var);
+                pushs(temp_var);
                 break;
             }
             if (strcmp(fn_name, "ifj.chr") == 0) {
                 // Generate code for the ASCII value
-                generate_code_in_node(node->FnCall.args[0]->Argument.expression);
+                generate_code_in_node(ast_child(node->FnCall.args, 0)->Argument.expression);
 
                 // Create a temporary variable for the result
-                char temp_var[32];
-                snprintf(temp_var, sizeof(temp_var), "tmp_chr_%d", tmp_counter++);
+                const char* temp_var = temp_name("tmp_chr_", tmp_counter++);
                 def_var(temp_var);
 
                 // Convert ASCII to character
-                printf("INT2CHAR LF@%s %s%s\n", temp_var,
-                       frame_prefix(node->FnCall.args[0]->Argument.expression->Identifier.identifier),
-                       node->FnCall.args[0]->Argument.expression->Identifier.identifier);
+                instruction(IR_INT2CHAR);
+                operand_var(temp_var);
+                operand_var(ast_child(node->FnCall.args, 0)->Argument.expression->Identifier.identifier);
 
                 // Push the result
-                printf("PUSHS LF@%s\n", temp_var);
+                pushs(temp_var);
                 break;
             }
 
             // built-in function ifj.print, for changing int to float
             if (strcmp(fn_name, "ifj.i2f") == 0) {
-                generate_code_in_node(node->FnCall.args[0]->Argument.expression);
-                printf("INT2FLOATS\n");
+                generate_code_in_node(ast_child(node->FnCall.args, 0)->Argument.expression);
+                instruction(IR_INT2FLOATS);
                 break;
             }
             // built-in function ifj.f2i, for changing float to int
             if (strcmp(fn_name, "ifj.f2i") == 0) {
-                generate_code_in_node(node->FnCall.args[0]->Argument.expression);
-                printf("FLOAT2INTS\n");
+                generate_code_in_node(ast_child(node->FnCall.args, 0)->Argument.expression);
+                instruction(IR_FLOAT2INTS);
                 break;
             }
             // built-in function ifj.length
 
             if (strcmp(fn_name, "ifj.length") == 0) {
-                generate_code_in_node(node->FnCall.args[0]->Argument.expression);
+                generate_code_in_node(ast_child(node->FnCall.args, 0)->Argument.expression);
             }
             // built-in function ifj.write, ifj.writef64
             if ((strcmp(fn_name, "ifj.write") == 0) || (strcmp(fn_name, "ifj.writef64") == 0)) {
                 // If the argument is a string, integer or float literal, write it directly
-                ASTNode *expression = node->FnCall.args[0]->Argument.expression;
+                ASTNode *expression = ast_child(node->FnCall.args, 0)->Argument.expression;
                 switch (expression->type) {
-                    case AST_STRING: {
-                        char *escaped_string = escape_string(expression->String.string);
-                        printf("WRITE string@%s\n", escaped_string);
-                        free(escaped_string);
+                    case AST_STRING:
+                        instruction(IR_WRITE);
+                        operand_string(expression->String.string);
                         break;
-                    }
                     case AST_INT:
-                        printf("WRITE int@%d\n", expression->Integer.number);
+                        instruction(IR_WRITE);
+                        operand_int(expression->Integer.number);
                         break;
                     case AST_FLOAT:
-                        printf("WRITE float@%f\n", expression->Float.number);
+                        instruction(IR_WRITE);
+                        operand_float(expression->Float.number);
                         break;
                     case AST_IDENTIFIER:
-                        printf("WRITE %s%s\n", frame_prefix(expression->Identifier.identifier),
-                               expression->Identifier.identifier);
+                        instruction(IR_WRITE);
+                        operand_var(expression->Identifier.identifier);
                         break;
                         // If the argument is a binary operation or a function call, evaluate it first
                     case AST_BIN_OP:
                     case AST_FN_CALL: {
                         generate_code_in_node(expression);
-                        char temp_var[32];
-                        snprintf(temp_var, sizeof(temp_var), "tm_write%d", tmp_counter);
-                        def_var(temp_var);//printf("DEFVAR LF@tm_write%i\n", tmp_counter);
-                        printf("POPS LF@tm_write%i\n", tmp_counter);
-                        printf("WRITE LF@tm_write%i\n", tmp_counter);
+                        const char* temp_var = temp_name("tm_write", tmp_counter);
+                        def_var(temp_var);
+                        pops(temp_var);
+                        instruction(IR_WRITE);
+                        operand_var(temp_var);
                         tmp_counter++;
                         break;
                     }
@@ -589,7 +817,7 @@ void generate_code_in_node(ASTNode* node){
             } else {
                 // Generate code for function arguments
                 for (int i = node->FnCall.arg_count; i > 0; --i) {
-                    generate_code_in_node(node->FnCall.args[i - 1]);
+                    generate_code_in_node(ast_child(node->FnCall.args, i - 1));
 
                 }
                 call(fn_name);
@@ -600,24 +828,20 @@ void generate_code_in_node(ASTNode* node){
             // Generate code for an assignment.
             // If the expression is an integer, float or string literal, move it directly to the variable
             if (node->Assignment.expression) {
-                if(node->Assignment.expression->type == AST_INT){
-                    printf("MOVE %s%s int@%d\n", frame_prefix(node->Assignment.identifier), node->Assignment.identifier, node->Assignment.expression->Integer.number);
-                    break;
-                }
-                else if(node->Assignment.expression->type == AST_FLOAT){
-                    printf("MOVE %s%s float@%a\n", frame_prefix(node->Assignment.identifier), node->Assignment.identifier, node->Assignment.expression->Float.number);
+                if(node->Assignment.expression->type == AST_INT || node->Assignment.expression->type == AST_FLOAT){
+                    // Literal is stored in the type of the variable
+                    instruction(IR_MOVE);
+                    operand_var(node->Assignment.identifier);
+                    print_number(node->Assignment.expression, node->Assignment.data_type);
                     break;
                 }
                 else if(node->Assignment.expression->type == AST_STRING){
-                    char* escape_string_string = escape_string(node->Assignment.expression->String.string);
-                    printf("MOVE %s%s string@%s\n", frame_prefix(node->Assignment.identifier), node->Assignment.identifier,
-                           escape_string_string);
-                    free(escape_string_string);
+                    instruction(IR_MOVE);
+                    operand_var(node->Assignment.identifier);
+                    operand_string(node->Assignment.expression->String.string);
                     break;
                 } else if(node->Assignment.expression->type == AST_BIN_OP){
-                    printf("PUSHS int@1\n");
-                    generate_code_in_node(node->Assignment.expression);
-                    pops(node->Assignment.identifier);
+                    generate_binary_into(node->Assignment.expression, node->Assignment.identifier);
 
                     break;
                 }
@@ -625,24 +849,28 @@ void generate_code_in_node(ASTNode* node){
                 if (node->Assignment.expression->type == AST_FN_CALL) {
                     // If the function call is a built-in function, handle it separately
                     if (strcmp(node->Assignment.expression->FnCall.fn_name, "ifj.string") == 0) {
-                        printf("MOVE LF@%s string@%s\n", node->Assignment.identifier,
-                               escape_string(node->Assignment.expression->FnCall.args[0]->Argument.expression->String.string));
+                        instruction(IR_MOVE);
+                        operand_var(node->Assignment.identifier);
+                        operand_string(ast_child(node->Assignment.expression->FnCall.args, 0)->Argument.expression->String.string);
                     } else if (strcmp(node->Assignment.expression->FnCall.fn_name, "ifj.readstr") == 0) {
-                        printf("READ %s%s string\n", frame_prefix(node->Assignment.identifier),
-                               node->Assignment.identifier);
+                        instruction(IR_READ);
+                        operand_var(node->Assignment.identifier);
+                        operand_type(IR_TYPE_STRING);
 
                     } else if (strcmp(node->Assignment.expression->FnCall.fn_name, "ifj.readi32") == 0) {
-                        printf("READ %s%s int\n", frame_prefix(node->Assignment.identifier),
-                               node->Assignment.identifier);
+                        instruction(IR_READ);
+                        operand_var(node->Assignment.identifier);
+                        operand_type(IR_TYPE_INT);
 
                     } else if (strcmp(node->Assignment.expression->FnCall.fn_name, "ifj.readf64") == 0) {
-                        printf("READ %s%s float\n", frame_prefix(node->Assignment.identifier),
-                               node->Assignment.identifier);
+                        instruction(IR_READ);
+                        operand_var(node->Assignment.identifier);
+                        operand_type(IR_TYPE_FLOAT);
 
                     } else if (strcmp(node->Assignment.expression->FnCall.fn_name, "ifj.concat") == 0) {
                         const char *result = node->Assignment.identifier;
-                        const char *arg1 = node->Assignment.expression->FnCall.args[0]->Argument.expression->Identifier.identifier;
-                        const char *arg2 = node->Assignment.expression->FnCall.args[1]->Argument.expression->Identifier.identifier;
+                        const char *arg1 = ast_child(node->Assignment.expression->FnCall.args, 0)->Argument.expression->Identifier.identifier;
+                        const char *arg2 = ast_child(node->Assignment.expression->FnCall.args, 1)->Argument.expression->Identifier.identifier;
                         concat(result, arg1, arg2);
                         break;
                     }
@@ -668,53 +896,63 @@ void generate_code_in_node(ASTNode* node){
                 }
             }
 
-            // generate code for the expression
-            generate_code_in_node(node->IfElse.expression);
+            // comparison of simple operands jumps to the else block without the data stack
+            if (!generate_false_jump(node->IfElse.expression, "else_block_", current_if)) {
+                // generate code for the expression
+                generate_code_in_node(node->IfElse.expression);
 
-            // depending on the type of the expression, we need to compare it with nil or bool@false
+                // depending on the type of the expression, we need to compare it with nil or bool@false
 
-            // if the expression is an identifier, int, float or string, we need to compare it with nil
-            switch (node->IfElse.expression->type) {
-                case AST_IDENTIFIER:
-                case AST_INT:
-                case AST_FLOAT:
-                case AST_STRING: {
-                    printf("PUSHS nil@nil\n");
-                    printf("JUMPIFEQS else_block_%d\n", current_if);
-                    break;
-                }
-                default: {
-                    // if the expression is a function call, we need to compare it with bool@false
-                    printf("PUSHS bool@false\n");
-                    printf("JUMPIFEQS else_block_%d\n", current_if);
-                    break;
+                // if the expression is an identifier, int, float or string, we need to compare it with nil
+                switch (node->IfElse.expression->type) {
+                    case AST_IDENTIFIER:
+                    case AST_INT:
+                    case AST_FLOAT:
+                    case AST_STRING: {
+                        instruction(IR_PUSHS);
+                        operand_nil();
+                        instruction(IR_JUMPIFEQS);
+                        operand_label("else_block_", current_if);
+                        break;
+                    }
+                    default: {
+                        // if the expression is a function call, we need to compare it with bool@false
+                        instruction(IR_PUSHS);
+                        operand_bool(false);
+                        instruction(IR_JUMPIFEQS);
+                        operand_label("else_block_", current_if);
+                        break;
+                    }
                 }
             }
 
             //  if there is an element bind, move the value of the expression to the element bind
             if (node->IfElse.element_bind != NULL) {
-                printf("MOVE LF@%s %s%s\n", node->IfElse.element_bind,
-                       frame_prefix(node->IfElse.expression->Identifier.identifier),
-                       node->IfElse.expression->Identifier.identifier);
+                instruction(IR_MOVE);
+                operand_var(node->IfElse.element_bind);
+                operand_var(node->IfElse.expression->Identifier.identifier);
             }
 
             // generate code for the if block
             generate_code_in_node(node->IfElse.if_block);
-            printf("JUMP end_block_%d\n", current_if);
+            instruction(IR_JUMP);
+            operand_label("end_block_", current_if);
 
             // else block
-            printf("LABEL else_block_%d\n", current_if);
+            instruction(IR_LABEL);
+            operand_label("else_block_", current_if);
             if (node->IfElse.element_bind != NULL) {
-                printf("MOVE LF@%s %s%s\n", node->IfElse.element_bind,
-                       frame_prefix(node->IfElse.expression->Identifier.identifier),
-                       node->IfElse.expression->Identifier.identifier);
+                instruction(IR_MOVE);
+                operand_var(node->IfElse.element_bind);
+                operand_var(node->IfElse.expression->Identifier.identifier);
             }
             if (node->IfElse.else_block) {
                 generate_code_in_node(node->IfElse.else_block);
             }
 
             // end block
-            printf("LABEL end_block_%d\n", current_if);
+            instruction(IR_LABEL);
+            operand_label("end_block_", current_if);
             break;
         }
 
@@ -736,86 +974,47 @@ void generate_code_in_node(ASTNode* node){
             }
             break;
 
-        case AST_BIN_OP:
+        case AST_BIN_OP: {
             // Generate code for a binary operation.
-            // Handle division separately to avoid coliisions with different types (int/float)
-            if(node->BinaryOperator.operator == AST_DIV){
-                generate_code_in_node(node->BinaryOperator.left);
-                generate_code_in_node(node->BinaryOperator.right);
-                char temp_d_2[32], temp_t_2[32], temp_d_1[32], temp_t_1[32], temp_d_4[32], temp_d_3[32], temp_t_3[32];
-                snprintf(temp_d_2, sizeof(temp_d_2), "tmp_div_2_%d", tmp_counter);
-                snprintf(temp_t_2, sizeof(temp_t_2), "tmp_type_2_%d", tmp_counter);
-                snprintf(temp_d_1, sizeof(temp_d_1), "tmp_div_1_%d", tmp_counter);
-                snprintf(temp_t_1, sizeof(temp_t_1), "tmp_type_1_%d", tmp_counter);
-                snprintf(temp_d_4, sizeof(temp_d_4), "tmp_div_4_%d", tmp_counter);
-                snprintf(temp_d_3, sizeof(temp_d_3), "tmp_div_3_%d", tmp_counter);
-                snprintf(temp_t_3, sizeof(temp_t_3), "tmp_type_3_%d", tmp_counter);
-
-                // it checks if the type of the first operand is float
-                def_var(temp_d_2);
-                def_var(temp_t_2);
-                printf("POPS LF@tmp_div_2_%i\n", tmp_counter);
-                printf("TYPE LF@tmp_type_2_%i LF@tmp_div_2_%i\n", tmp_counter, tmp_counter);
-                // it checks if the type of the second operand is float
-                def_var(temp_d_1);
-                def_var(temp_t_1);
-                printf("POPS LF@tmp_div_1_%i\n", tmp_counter);
-                printf("TYPE LF@tmp_type_1_%i LF@tmp_div_1_%i\n", tmp_counter, tmp_counter);
-                printf("PUSHS LF@tmp_div_1_%i\n", tmp_counter);
-                // it converts the first operand to float
-                printf("JUMPIFEQ label_div_1_%i LF@tmp_type_1_%i string@float\n", tmp_counter, tmp_counter);
-                printf("INT2FLOATS\n");
-                printf("LABEL label_div_1_%i\n", tmp_counter);
-                printf("PUSHS LF@tmp_div_2_%i\n", tmp_counter);
-                // it converts the second operand to float
-                printf("JUMPIFEQ label_div_2_%i LF@tmp_type_2_%i string@float\n", tmp_counter, tmp_counter);
-                printf("INT2FLOATS\n");
-                printf("LABEL label_div_2_%i\n", tmp_counter);
-                printf("DIVS\n");
-                tmp_counter++;
-                // it checks if the result is float
-                def_var(temp_d_4);
-                printf("POPS LF@tmp_div_4_%i\n", tmp_counter - 1 );
-                def_var(temp_d_3);
-                def_var(temp_t_3);
-                printf("POPS LF@tmp_div_3_%i\n", tmp_counter - 1 );
-                printf("TYPE LF@tmp_type_3_%i LF@tmp_div_3_%i\n", tmp_counter - 1, tmp_counter - 1);
-                printf("PUSHS LF@tmp_div_3_%i\n", tmp_counter - 1);
-                printf("PUSHS LF@tmp_div_4_%i\n", tmp_counter - 1);
-                printf("JUMPIFEQ label_div_4_%i LF@tmp_type_3_%i string@float\n", tmp_counter - 1, tmp_counter - 1);
-                printf("FLOAT2INTS\n");
-                printf("LABEL label_div_4_%i\n", tmp_counter - 1);
-
+            // Shallow arithmetic is computed without the data stack, only its result is pushed
+            if (is_three_address(node, THREE_ADDRESS_MAX_DEPTH)) {
+                const char* result = register_var(0);
+                lower_binary(node, result, 0);
+                pushs(result);
                 break;
-
             }
-            generate_code_in_node(node->BinaryOperator.left);
-            generate_code_in_node(node->BinaryOperator.right);
+            // Operand types are known from semantic analysis, integer operand is converted only if the other one is float
+            DataType left_type = expression_type(node->BinaryOperator.left);
+            DataType right_type = expression_type(node->BinaryOperator.right);
+            bool is_float = left_type == AST_F64 || right_type == AST_F64;
+            generate_operand(node->BinaryOperator.left, is_float && left_type == AST_I32);
+            generate_operand(node->BinaryOperator.right, is_float && right_type == AST_I32);
 
             switch (node->BinaryOperator.operator) {
-                case AST_PLUS: printf("ADDS\n"); break;
-                case AST_MINUS: printf("SUBS\n"); break;
-                case AST_MUL: printf("MULS\n"); break;
-                case AST_DIV: printf("DIVS\n"); break;
-                case AST_GREATER: printf("GTS\n"); break;
+                case AST_PLUS: instruction(IR_ADDS); break;
+                case AST_MINUS: instruction(IR_SUBS); break;
+                case AST_MUL: instruction(IR_MULS); break;
+                case AST_DIV: instruction(is_float ? IR_DIVS : IR_IDIVS); break;
+                case AST_GREATER: instruction(IR_GTS); break;
                 case AST_GREATER_EQU:
-                    printf("LTS\n");
-                    printf("NOTS\n");
+                    instruction(IR_LTS);
+                    instruction(IR_NOTS);
                     break;
-                case AST_LESS: printf("LTS\n"); break;
+                case AST_LESS: instruction(IR_LTS); break;
                 case AST_LESS_EQU:
-                    printf("GTS\n");
-                    printf("NOTS\n");
+                    instruction(IR_GTS);
+                    instruction(IR_NOTS);
                     break;
-                case AST_EQU: printf("EQS\n"); break;
+                case AST_EQU: instruction(IR_EQS); break;
                 case AST_NOT_EQU:
-                    printf("EQS\n");
-                    printf("NOTS\n");
+                    instruction(IR_EQS);
+                    instruction(IR_NOTS);
                     break;
                 default:
                     generator_error_handler(12);
             }
             break;
+        }
 
         case AST_WHILE: {
             // Generate code for a while loop.
@@ -832,49 +1031,53 @@ void generate_code_in_node(ASTNode* node){
             }
 
             // label for the start of the while loop
-            char temp_while_cnt[32];
-            snprintf(temp_while_cnt, sizeof(temp_while_cnt), "while_cnt_tmp_%d", current_while);
-            def_var(temp_while_cnt);
-            printf("MOVE LF@%s int@0\n", temp_while_cnt);
             add_while_stack(current_while);
-            printf("LABEL while_start_%d\n", current_while);
-
-            // generate code for the expression
-            generate_code_in_node(node->WhileCycle.expression);
-
-            // decision based on the type of the expression
-            switch (node->WhileCycle.expression->type) {
-                case AST_IDENTIFIER:
-                case AST_INT:
-                case AST_FLOAT:
-                case AST_STRING: {
-                    printf("PUSHS nil@nil\n");
-                    printf("JUMPIFEQS while_end_%d\n", current_while);
-                    break;
-                }
-                default: {
-                    printf("PUSHS bool@false\n");
-                    printf("JUMPIFEQS while_end_%d\n", current_while);
-                    break;
+            instruction(IR_LABEL);
+            operand_label("while_start_", current_while);
+
+            // comparison of simple operands jumps to the end without the data stack
+            if (!generate_false_jump(node->WhileCycle.expression, "while_end_", current_while)) {
+                // generate code for the expression
+                generate_code_in_node(node->WhileCycle.expression);
+
+                // decision based on the type of the expression
+                switch (node->WhileCycle.expression->type) {
+                    case AST_IDENTIFIER:
+                    case AST_INT:
+                    case AST_FLOAT:
+                    case AST_STRING: {
+                        instruction(IR_PUSHS);
+                        operand_nil();
+                        instruction(IR_JUMPIFEQS);
+                        operand_label("while_end_", current_while);
+                        break;
+                    }
+                    default: {
+                        instruction(IR_PUSHS);
+                        operand_bool(false);
+                        instruction(IR_JUMPIFEQS);
+                        operand_label("while_end_", current_while);
+                        break;
+                    }
                 }
             }
 
             // if element_bind is defined, set its value
             if (node->WhileCycle.element_bind != NULL) {
-                printf("MOVE LF@%s %s%s\n", node->WhileCycle.element_bind,
-                       frame_prefix(node->WhileCycle.expression->Identifier.identifier),
-                       node->WhileCycle.expression->Identifier.identifier);
+                instruction(IR_MOVE);
+                operand_var(node->WhileCycle.element_bind);
+                operand_var(node->WhileCycle.expression->Identifier.identifier);
             }
 
             // generate code for the block
             generate_code_in_node(node->WhileCycle.block);
 
-            // increment the counter
-            printf("ADD LF@%s LF@%s int@1\n", temp_while_cnt, temp_while_cnt);
-            printf("JUMP while_start_%d\n", current_while);
+            instruction(IR_JUMP);
+            operand_label("while_start_", current_while);
 
             // end of the while loop
-            printf("LABEL while_end_%d\n", current_while);
+            instruction(IR_LABEL);
+            operand_label("while_end_", current_while);
 
             remove_while_stack();
             break;
@@ -883,25 +1086,25 @@ void generate_code_in_node(ASTNode* node){
 
         case AST_INT:
             // Push an integer value onto the stack.
-            printf("PUSHS int@%d\n", node->Integer.number);
+            instruction(IR_PUSHS);
+            operand_int(node->Integer.number);
             break;
 
         case AST_FLOAT:
             // Push a float value onto the stack.
-            printf("PUSHS float@%a\n", node->Float.number);
+            instruction(IR_PUSHS);
+            operand_float(node->Float.number);
             break;
 
-        case AST_STRING: {
+        case AST_STRING:
             // Push a string value onto the stack.
-            char* escaped_string = escape_string(node->String.string);
-            printf("PUSHS string@%s\n", escaped_string);
-            free(escaped_string);
+            instruction(IR_PUSHS);
+            operand_string(node->String.string);
             break;
-        }
 
         case AST_IDENTIFIER:
             // Push an identifier's value onto the stack.
-            printf("PUSHS %s%s\n", frame_prefix(node->Identifier.identifier), node->Identifier.identifier);
+            pushs(node->Identifier.identifier);
             break;
 
         default:
@@ -910,6 +1113,125 @@ void generate_code_in_node(ASTNode* node){
     }
 }
 
+/**
+ * @brief Get an interned name of a variable of a helper routine.
+ * @param name Name of the variable.
+ * @return Interned name.
+ */
+static const char* helper_var(const char* name) {
+    return intern(name, strlen(name));
+}
+
+/**
+ * @brief Start a helper routine, its arguments are popped from the stack into new local variables.
+ *
+ * Helpers use the calling convention of user functions: arguments are pushed from the last
+ * one and popped in declaration order, the result is pushed back and the routine returns
+ * to the caller with its frame restored.
+ * @param helper Label of the routine.
+ * @param vars Local variables, the first arg_count of them are the arguments.
+ * @param var_count Number of local variables.
+ * @param arg_count Number of arguments.
+ */
+static void begin_helper(const char* helper, const char* const vars[], int var_count, int arg_count) {
+    label(helper);
+    gen_create_frame();
+    gen_push_frame();
+    for (int i = 0; i < var_count; ++i) {
+        instruction(IR_DEFVAR);
+        operand_var(helper_var(vars[i]));
+    }
+    for (int i = 0; i < arg_count; ++i) {
+        pops(helper_var(vars[i]));
+    }
+}
+
+/**
+ * @brief End a helper routine, its result is pushed and the frame of the caller restored.
+ * @param result Variable with the result.
+ */
+static void end_helper(const char* result) {
+    pushs(helper_var(result));
+    gen_pop_frame();
+    return_f();
+    print_new_line();
+}
+
+/**
+ * @brief Generate the shared routine of ifj.substring(s, i, j), characters from i to j are concatenated.
+ */
+static void generate_substring_helper() {
+    static const char* const vars[] = {"s", "i", "j", "char", "result", "in_range"};
+    begin_helper(SUBSTRING_HELPER, vars, 6, 3);
+
+    instruction(IR_MOVE);
+    operand_var(helper_var("result"));
+    operand_string("");
+
+    label(SUBSTRING_HELPER "$loop");
+    instruction(IR_LT); // Cyklus pokračuje, kým `i < j`
+    operand_var(helper_var("in_range"));
+    operand_var(helper_var("i"));
+    operand_var(helper_var("j"));
+    instruction(IR_JUMPIFEQ);
+    operand_name(SUBSTRING_HELPER "$end");
+    operand_var(helper_var("in_range"));
+    operand_bool(false);
+
+    instruction(IR_GETCHAR); // Získanie znaku na indexe `i`
+    operand_var(helper_var("char"));
+    operand_var(helper_var("s"));
+    operand_var(helper_var("i"));
+    concat(helper_var("result"), helper_var("result"), helper_var("char")); // Pridanie znaku do výsledku
+    instruction(IR_ADD); // Zvýšenie `i`
+    operand_var(helper_var("i"));
+    operand_var(helper_var("i"));
+    operand_int(1);
+    instruction(IR_JUMP);
+    operand_name(SUBSTRING_HELPER "$loop");
+
+    label(SUBSTRING_HELPER "$end");
+    end_helper("result");
+}
+
+/**
+ * @brief Generate the shared routine of ifj.strcmp(s1, s2), the result is -1, 0 or 1.
+ */
+static void generate_strcmp_helper() {
+    static const char* const vars[] = {"s1", "s2", "less", "result"};
+    begin_helper(STRCMP_HELPER, vars, 4, 2);
+
+    // If s1 == s2
+    instruction(IR_MOVE);
+    operand_var(helper_var("result"));
+    operand_int(0);
+    instruction(IR_JUMPIFEQ);
+    operand_name(STRCMP_HELPER "$end");
+    operand_var(helper_var("s1"));
+    operand_var(helper_var("s2"));
+
+    // If s1 > s2
+    instruction(IR_MOVE);
+    operand_var(helper_var("result"));
+    operand_int(1);
+    instruction(IR_LT);
+    operand_var(helper_var("less"));
+    operand_var(helper_var("s1"));
+    operand_var(helper_var("s2"));
+    instruction(IR_JUMPIFEQ);
+    operand_name(STRCMP_HELPER "$end");
+    operand_var(helper_var("less"));
+    operand_bool(false);
+
+    // If s1 < s2
+    instruction(IR_MOVE);
+    operand_var(helper_var("result"));
+    operand_int(-1);
+
+    label(STRCMP_HELPER "$end");
+    end_helper("result");
+}
+
 /**
  * @brief Generate code for the given AST root node.
  * @param root Pointer to the root node of the AST.
@@ -921,18 +1243,36 @@ int generate_code(ASTNode* root){
         // This code executes if longjmp is called
         free_local_frame();
         free_while_stack();
+        free_ir();
         return err_code;
     }
 
     if (root == NULL) generator_error_handler(99); // Internal error - root is NULL
     init_local_frame();
+    init_ir();
+    substring_used = false;
+    strcmp_used = false;
 
-    printf(".IFJcode24\n");  printf("JUMP main\n");   print_new_line();
+    instruction(IR_HEADER);
+    instruction(IR_JUMP);
+    operand_name("main");
+    print_new_line();
 
     generate_code_in_node(root);
 
+    // builtin helpers are emitted once, after all functions that call them
+    if (substring_used) {
+        generate_substring_helper();
+    }
+    if (strcmp_used) {
+        generate_strcmp_helper();
+    }
+    peephole_ir();
+    write_ir();
+
     free_local_frame();
     free_while_stack();
+    free_ir();
     return 0;
 
 }
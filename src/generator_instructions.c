@@ -6,79 +6,133 @@
 
 #include "generator_instructions.h"
 #include "generator.h"
+#include "intern.h"
+#include "ir.h"
 
 /**
- * @brief Escapes special characters in a string for use in IFJcode24.
- * @param input The input string to escape.
- * @return A dynamically allocated escaped string. The caller must free the memory.
+ * @brief Appends an instruction to the instruction list, operands follow.
+ * @param opcode Opcode of the instruction.
  */
-char* escape_string(const char* input) {
-    if (input == NULL) return NULL;
+void instruction(IROpcode opcode) {
+    ir_instruction(opcode);
+}
 
-    size_t length = strlen(input);
-    size_t buffer_size = length * 4 + 1; // Maximum size after escaping.
-    char* output = malloc(buffer_size);
-    if (output == NULL) {
-        generator_error_handler(99);
-    }
+/**
+ * @brief Appends a variable operand, all variables are in the local frame.
+ * @param var The interned variable name.
+ */
+void operand_var(const char* var) {
+    ir_operand(IR_OPERAND_VAR, ir_name(var));
+}
 
-    size_t j = 0;
-    for (size_t i = 0; i < length; i++) {
-        if (input[i] == '\n') {
-            // Replace newline character with "\010".
-            strcpy(&output[j], "\\010");
-            j += 4;
-        } else if (input[i] == '\\' && input[i + 1] == 'n') {
-            // Replace "\n" with "\010".
-            strcpy(&output[j], "\\010");
-            j += 4;
-            i++; // Skip the next character.
-        } else {
-            switch (input[i]) {
-                // Escape special characters.
-                case ' ':
-                    strcpy(&output[j], "\\032");
-                    j += 4;
-                    break;
-                case '\\':
-                    strcpy(&output[j], "\\092");
-                    j += 4;
-                    break;
-                case '#':
-                    strcpy(&output[j], "\\035");
-                    j += 4;
-                    break;
-                default:
-                    output[j++] = input[i];
-            }
-        }
-    }
-    output[j] = '\0'; // Null-terminate the string.
-    return output;
+/**
+ * @brief Appends an integer constant operand.
+ * @param value The value of the constant.
+ */
+void operand_int(long long value) {
+    ir_operand(IR_OPERAND_INT, (int32_t)value);
 }
 
 /**
- * @brief Returns the prefix used for variables in the local frame.
- * @param var The variable name.
- * @return The frame prefix string (always "LF@" in this implementation).
+ * @brief Appends a float constant operand, it is written in hexadecimal notation.
+ * @param value The value of the constant.
+ */
+void operand_float(double value) {
+    ir_operand(IR_OPERAND_FLOAT, ir_float(value));
+}
+
+/**
+ * @brief Appends a string constant operand, special characters are escaped when the code is written.
+ * @param string The string without escapes of IFJcode24, it must live until the code is written.
+ */
+void operand_string(const char* string) {
+    ir_operand(IR_OPERAND_STRING, ir_string(string));
+}
+
+/**
+ * @brief Appends a bool constant operand.
+ * @param value The value of the constant.
+ */
+void operand_bool(bool value) {
+    ir_operand(IR_OPERAND_BOOL, value);
+}
+
+/**
+ * @brief Appends the nil@nil operand.
  */
-const char* frame_prefix(const char* var) {
-    return "LF@";
+void operand_nil() {
+    ir_operand(IR_OPERAND_NIL, 0);
 }
 
 /**
- * @brief Prints text with indentation for better readability.
+ * @brief Appends a type operand of READ.
+ * @param type The type.
+ */
+void operand_type(IRType type) {
+    ir_operand(IR_OPERAND_TYPE, type);
+}
+
+/**
+ * @brief Appends a label or function name operand.
+ * @param name The name of the label.
+ */
+void operand_name(const char* name) {
+    ir_operand(IR_OPERAND_LABEL, ir_name(intern(name, strlen(name))));
+}
+
+/**
+ * @brief Appends a numbered label operand.
+ * @param prefix Name of the label without the number, it is not copied.
+ * @param number Unique number of the label.
+ */
+void operand_label(const char* prefix, int number) {
+    ir_operand(IR_OPERAND_NUMBERED_LABEL, ir_label(prefix, number));
+}
+
+/**
+ * @brief Builds a numbered name of a temporary variable.
+ * @param prefix Name of the variable without the number.
+ * @param number Unique number of the variable.
+ * @return Interned name of the variable.
+ */
+const char* temp_name(const char* prefix, int number) {
+    char name[64];
+    size_t length = strlen(prefix);
+    if (length > sizeof(name) - 12) {
+        generator_error_handler(99);
+    }
+    memcpy(name, prefix, length);
+
+    char digits[12];
+    int count = 0;
+    unsigned magnitude = number < 0 ? 0u - (unsigned)number : (unsigned)number;
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (number < 0) {
+        name[length++] = '-';
+    }
+    while (count > 0) {
+        name[length++] = digits[--count];
+    }
+    return intern(name, length);
+}
+
+/**
+ * @brief Appends text with indentation for better readability.
  * @param text The text to print.
  */
 void print_with_indent(const char* text) {
-    printf("    %s\n", text);  // four spaces before text
+    instruction(IR_TEXT);
+    operand_string(text);
 }
 
 /**
- * @brief Prints a new line for better readability.
+ * @brief Appends an empty line for better readability.
  */
 void print_new_line() {
-    printf("\n");
+    instruction(IR_BLANK);
 }
 
 /**
@@ -86,55 +140,38 @@ void print_new_line() {
  * @param label_name The name of the label.
  */
 void label(const char* label_name){
-    printf("LABEL %s\n", label_name);
+    instruction(IR_LABEL);
+    operand_name(label_name);
 }
 
 /**
  * @brief Generates a CREATEFRAME instruction.
  */
 void gen_create_frame(){
-    printf("CREATEFRAME\n");
+    instruction(IR_CREATEFRAME);
 }
 
 /**
  * @brief Generates a PUSHFRAME instruction.
  */
 void gen_push_frame(){
-    printf("PUSHFRAME\n");
+    instruction(IR_PUSHFRAME);
 }
 
 /**
  * @brief Generates a POPFRAME instruction.
  */
 void gen_pop_frame(){
-    printf("POPFRAME\n");
+    instruction(IR_POPFRAME);
 }
 
 /**
- * @brief Defines a variable in the local frame. Handles special cases for variables in while loops.
+ * @brief Declares a variable in the local frame of the current function.
+ * DEFVAR is not emitted here, all variables of the function are defined once at its entry.
  * @param var_name The name of the variable.
  */
 void def_var(const char* var_name) {
-    // check if the declaration is inside a while loop
-    if (while_stack.top != NULL) {
-        int unique_tmp = tmp_counter++; // Unique temporary variable for the while loop
-        int stack_size = while_stack_size();
-
-        // Check all nested while loops for unique variable declarations.
-        for (int i = 0; i < stack_size; i++) {
-            int current_while = get_while_at_index(i);
-            printf("JUMPIFNEQ while_end_declaration_%d_%d LF@while_cnt_tmp_%d int@0\n",
-                   actual_while(), unique_tmp, current_while);
-        }
-
-        printf("DEFVAR LF@%s\n", var_name);
-
-        // label for the end of the declaration
-        printf("LABEL while_end_declaration_%d_%d\n", actual_while(), unique_tmp);
-    } else {
-        // No while loop, just declare the variable
-        printf("DEFVAR LF@%s\n", var_name);
-    }
+    add_to_local(intern(var_name, strlen(var_name)));
 }
 
 /**
@@ -142,14 +179,15 @@ void def_var(const char* var_name) {
  * @param func The function name to call.
  */
 void call(const char* func){
-    printf("CALL %s\n", func);
+    instruction(IR_CALL);
+    operand_name(func);
 }
 
 /**
  * @brief Generates a RETURN instruction.
  */
 void return_f(){
-    printf("RETURN\n");
+    instruction(IR_RETURN);
 }
 
 /**
@@ -157,7 +195,8 @@ void return_f(){
  * @param var The variable name.
  */
 void pushs(const char* var) {
-    printf("PUSHS %s%s\n", frame_prefix(var), var);
+    instruction(IR_PUSHS);
+    operand_var(var);
 }
 
 /**
@@ -165,7 +204,8 @@ void pushs(const char* var) {
  * @param var The variable name.
  */
 void pops(const char* var) {
-    printf("POPS %s%s\n", frame_prefix(var), var);
+    instruction(IR_POPS);
+    operand_var(var);
 }
 
 /**
@@ -175,7 +215,10 @@ void pops(const char* var) {
  * @param symb2 The second operand.
  */
 void and(const char* var, const char* symb1, const char* symb2) {
-    printf("AND %s%s %s %s\n", frame_prefix(var), var, symb1, symb2);
+    instruction(IR_AND);
+    operand_var(var);
+    operand_var(symb1);
+    operand_var(symb2);
 }
 
 /**
@@ -185,7 +228,10 @@ void and(const char* var, const char* symb1, const char* symb2) {
  * @param symb2 The second operand.
  */
 void or(const char* var, const char* symb1, const char* symb2) {
-    printf("OR %s%s %s %s\n", frame_prefix(var), var, symb1, symb2);
+    instruction(IR_OR);
+    operand_var(var);
+    operand_var(symb1);
+    operand_var(symb2);
 }
 
 /**
@@ -194,7 +240,9 @@ void or(const char* var, const char* symb1, const char* symb2) {
  * @param symb The operand.
  */
 void not(const char* var, const char* symb) {
-    printf("NOT %s%s %s\n", frame_prefix(var), var, symb);
+    instruction(IR_NOT);
+    operand_var(var);
+    operand_var(symb);
 }
 
 /**
@@ -204,10 +252,10 @@ void not(const char* var, const char* symb) {
  * @param symb2 The second string operand.
  */
 void concat(const char* var, const char* symb1, const char* symb2) {
-    printf("CONCAT %s%s %s%s %s%s\n",
-           frame_prefix(var), var,
-           frame_prefix(symb1), symb1,
-           frame_prefix(symb2), symb2);
+    instruction(IR_CONCAT);
+    operand_var(var);
+    operand_var(symb1);
+    operand_var(symb2);
 }
 
 /**
@@ -216,5 +264,7 @@ void concat(const char* var, const char* symb1, const char* symb2) {
  * @param symb The symbol whose type is determined.
  */
 void type(const char* var, const char* symb){
-    printf("TYPE LF@%s %s\n", var, symb);
+    instruction(IR_TYPE);
+    operand_var(var);
+    operand_var(symb);
 }
\ No newline at end of file
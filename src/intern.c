@@ -0,0 +1,101 @@
+/**
+ * @file intern.c
+ * @brief Contains implementation of the string intern pool
+ * @authors Michal Repcik (xrepcim00)
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "intern.h"
+#include "arena.h"
+#include "error.h"
+
+#define INTERN_INITIAL_CAPACITY 256 ///< Initial number of slots, always power of two.
+
+/**
+ * @struct InternPool
+ * @brief Open addressing hash set of interned strings.
+*/
+typedef struct {
+    Arena arena;            ///< Memory of headers and strings.
+    const char** slots;     ///< Interned strings, NULL for empty slot.
+    size_t capacity;        ///< Number of slots.
+    size_t count;           ///< Number of interned strings.
+} InternPool;
+
+static InternPool pool = {0};
+
+// FNV-1a hash of len characters of str
+static uint32_t hash_string(const char* str, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ (unsigned char)str[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void intern_fail(void) {
+    set_error(INTERNAL_ERROR);
+    fprintf(stderr, "Memory allocation for interned string failed\n");
+    exit(INTERNAL_ERROR);
+}
+
+// Doubles number of slots (or allocates initial slots) and reinserts all strings
+static void grow_pool(void) {
+    size_t capacity = pool.capacity ? pool.capacity * 2 : INTERN_INITIAL_CAPACITY;
+    const char** slots = calloc(capacity, sizeof(const char*));
+    if (slots == NULL) {
+        intern_fail();
+    }
+
+    for (size_t i = 0; i < pool.capacity; i++) {
+        if (pool.slots[i] != NULL) {
+            size_t idx = intern_hash(pool.slots[i]) & (capacity - 1);
+            while (slots[idx] != NULL) {
+                idx = (idx + 1) & (capacity - 1);
+            }
+            slots[idx] = pool.slots[i];
+        }
+    }
+    free(pool.slots);
+    pool.slots = slots;
+    pool.capacity = capacity;
+}
+
+const char* intern(const char* str, size_t len) {
+    if (pool.count * 2 >= pool.capacity) { // Keep load factor under 0.5
+        grow_pool();
+    }
+
+    uint32_t hash = hash_string(str, len);
+    size_t idx = hash & (pool.capacity - 1);
+    for (const char* name = pool.slots[idx]; name != NULL; name = pool.slots[idx]) {
+        if (intern_hash(name) == hash && intern_length(name) == len && memcmp(name, str, len) == 0) {
+            return name;
+        }
+        idx = (idx + 1) & (pool.capacity - 1);
+    }
+
+    InternHeader* header = arena_alloc(&pool.arena, sizeof(InternHeader) + len + 1);
+    if (header == NULL) {
+        intern_fail();
+    }
+    header->hash = hash;
+    header->length = (uint32_t)len;
+    char* name = (char*)(header + 1);
+    memcpy(name, str, len);
+    name[len] = '\0';
+
+    pool.slots[idx] = name;
+    pool.count++;
+    return name;
+}
+
+void free_interns(void) {
+    destroy_arena(&pool.arena);
+    free(pool.slots);
+    pool.slots = NULL;
+    pool.capacity = 0;
+    pool.count = 0;
+}
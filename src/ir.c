@@ -0,0 +1,247 @@
+/**
+ * @file ir.c
+ * @brief Contains implementation of the in-memory IFJcode24 instruction list
+ * @authors Michal Repcik (xrepcim00)
+*/
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ir.h"
+#include "intern.h"
+#include "writer.h"
+#include "error.h"
+
+#define IR_INITIAL_CAPACITY 1024 ///< Initial capacity of all arrays, always power of two.
+
+/**
+ * @brief Text of every opcode, indexed by IROpcode.
+*/
+static const char* const opcode_names[IR_OPCODE_COUNT] = {
+    [IR_HEADER] = ".IFJcode24", [IR_BLANK] = "", [IR_TEXT] = "    ",
+    [IR_MOVE] = "MOVE", [IR_CREATEFRAME] = "CREATEFRAME", [IR_PUSHFRAME] = "PUSHFRAME",
+    [IR_POPFRAME] = "POPFRAME", [IR_DEFVAR] = "DEFVAR", [IR_CALL] = "CALL", [IR_RETURN] = "RETURN",
+    [IR_PUSHS] = "PUSHS", [IR_POPS] = "POPS", [IR_CLEARS] = "CLEARS",
+    [IR_ADD] = "ADD", [IR_SUB] = "SUB", [IR_MUL] = "MUL", [IR_DIV] = "DIV", [IR_IDIV] = "IDIV",
+    [IR_ADDS] = "ADDS", [IR_SUBS] = "SUBS", [IR_MULS] = "MULS", [IR_DIVS] = "DIVS", [IR_IDIVS] = "IDIVS",
+    [IR_LT] = "LT", [IR_GT] = "GT", [IR_EQ] = "EQ", [IR_LTS] = "LTS", [IR_GTS] = "GTS", [IR_EQS] = "EQS",
+    [IR_AND] = "AND", [IR_OR] = "OR", [IR_NOT] = "NOT", [IR_ANDS] = "ANDS", [IR_ORS] = "ORS", [IR_NOTS] = "NOTS",
+    [IR_INT2FLOAT] = "INT2FLOAT", [IR_FLOAT2INT] = "FLOAT2INT", [IR_INT2CHAR] = "INT2CHAR",
+    [IR_STRI2INT] = "STRI2INT", [IR_INT2FLOATS] = "INT2FLOATS", [IR_FLOAT2INTS] = "FLOAT2INTS",
+    [IR_INT2CHARS] = "INT2CHARS", [IR_STRI2INTS] = "STRI2INTS",
+    [IR_READ] = "READ", [IR_WRITE] = "WRITE", [IR_CONCAT] = "CONCAT", [IR_STRLEN] = "STRLEN",
+    [IR_GETCHAR] = "GETCHAR", [IR_SETCHAR] = "SETCHAR", [IR_TYPE] = "TYPE",
+    [IR_LABEL] = "LABEL", [IR_JUMP] = "JUMP", [IR_JUMPIFEQ] = "JUMPIFEQ", [IR_JUMPIFNEQ] = "JUMPIFNEQ",
+    [IR_JUMPIFEQS] = "JUMPIFEQS", [IR_JUMPIFNEQS] = "JUMPIFNEQS",
+    [IR_EXIT] = "EXIT", [IR_BREAK] = "BREAK", [IR_DPRINT] = "DPRINT"
+};
+
+/**
+ * @brief Text of type operands, indexed by IRType.
+*/
+static const char* const type_names[] = {"int", "float", "string", "bool"};
+
+IRProgram ir = {0};
+
+static void ir_fail(void) {
+    set_error(INTERNAL_ERROR);
+    fprintf(stderr, "Memory allocation for generated code failed\n");
+    exit(INTERNAL_ERROR);
+}
+
+// Doubles capacity of array with elements of given size
+static void* grow_array(void* array, int* capacity, size_t size) {
+    int new_capacity = *capacity ? *capacity * 2 : IR_INITIAL_CAPACITY;
+    array = realloc(array, new_capacity * size);
+    if (array == NULL) {
+        ir_fail();
+    }
+    *capacity = new_capacity;
+    return array;
+}
+
+// Doubles number of name slots and reinserts all names
+static void grow_name_slots(void) {
+    int capacity = ir.slot_capacity ? ir.slot_capacity * 2 : IR_INITIAL_CAPACITY;
+    int* slots = calloc(capacity, sizeof(int));
+    if (slots == NULL) {
+        ir_fail();
+    }
+    for (int i = 0; i < ir.name_count; i++) {
+        int idx = intern_hash(ir.names[i]) & (capacity - 1);
+        while (slots[idx] != 0) {
+            idx = (idx + 1) & (capacity - 1);
+        }
+        slots[idx] = i + 1;
+    }
+    free(ir.name_slots);
+    ir.name_slots = slots;
+    ir.slot_capacity = capacity;
+}
+
+void init_ir(void) {
+    free_ir();
+}
+
+void free_ir(void) {
+    free(ir.code);
+    free(ir.names);
+    free(ir.name_slots);
+    free(ir.floats);
+    free(ir.strings);
+    free(ir.labels);
+    destroy_arena(&ir.arena);
+    ir = (IRProgram){0};
+}
+
+void ir_instruction(IROpcode opcode) {
+    if (ir.count == ir.capacity) {
+        size_t capacity = ir.capacity ? ir.capacity * 2 : IR_INITIAL_CAPACITY;
+        IRInstruction* code = realloc(ir.code, capacity * sizeof(IRInstruction));
+        if (code == NULL) {
+            ir_fail();
+        }
+        ir.code = code;
+        ir.capacity = capacity;
+    }
+    ir.code[ir.count++] = (IRInstruction){.opcode = (uint8_t)opcode};
+}
+
+void ir_operand(IROperandKind kind, int32_t value) {
+    IRInstruction* instruction = &ir.code[ir.count - 1];
+    int i = instruction->operand_count++;
+    instruction->kinds |= (uint16_t)(kind << (4 * i));
+    instruction->values[i] = value;
+}
+
+int32_t ir_name(const char* name) {
+    if ((ir.name_count + 1) * 2 > ir.slot_capacity) { // Keep load factor under 0.5
+        grow_name_slots();
+    }
+
+    int idx = intern_hash(name) & (ir.slot_capacity - 1);
+    while (ir.name_slots[idx] != 0) {
+        if (ir.names[ir.name_slots[idx] - 1] == name) {
+            return ir.name_slots[idx] - 1;
+        }
+        idx = (idx + 1) & (ir.slot_capacity - 1);
+    }
+
+    if (ir.name_count == ir.name_capacity) {
+        ir.names = grow_array(ir.names, &ir.name_capacity, sizeof(const char*));
+    }
+    ir.names[ir.name_count] = name;
+    ir.name_slots[idx] = ++ir.name_count;
+    return ir.name_count - 1;
+}
+
+int32_t ir_float(double value) {
+    if (ir.float_count == ir.float_capacity) {
+        ir.floats = grow_array(ir.floats, &ir.float_capacity, sizeof(double));
+    }
+    ir.floats[ir.float_count] = value;
+    return ir.float_count++;
+}
+
+int32_t ir_string(const char* string) {
+    if (ir.string_count == ir.string_capacity) {
+        ir.strings = grow_array(ir.strings, &ir.string_capacity, sizeof(const char*));
+    }
+    ir.strings[ir.string_count] = string;
+    return ir.string_count++;
+}
+
+char* ir_string_buffer(size_t length) {
+    char* string = arena_alloc(&ir.arena, length + 1);
+    if (string == NULL) {
+        ir_fail();
+    }
+    return string;
+}
+
+int32_t ir_label(const char* prefix, int32_t number) {
+    if (ir.label_count == ir.label_capacity) {
+        ir.labels = grow_array(ir.labels, &ir.label_capacity, sizeof(IRLabel));
+    }
+    ir.labels[ir.label_count] = (IRLabel){prefix, number};
+    return ir.label_count++;
+}
+
+// Writes string constant, newline (or the two characters of its escape sequence), space, backslash and '#' are escaped
+static void write_escaped(const char* string) {
+    for (size_t i = 0; string[i] != '\0'; i++) {
+        switch (string[i]) {
+            case '\n':
+                write_chars("\\010", 4);
+                break;
+            case ' ':
+                write_chars("\\032", 4);
+                break;
+            case '#':
+                write_chars("\\035", 4);
+                break;
+            case '\\':
+                if (string[i + 1] == 'n') {
+                    write_chars("\\010", 4);
+                    i++; // Skip the next character
+                } else {
+                    write_chars("\\092", 4);
+                }
+                break;
+            default:
+                write_char(string[i]);
+        }
+    }
+}
+
+static void write_operand(IROperandKind kind, int32_t value) {
+    write_char(' ');
+    switch (kind) {
+        case IR_OPERAND_VAR:
+            write_chars("LF@", 3);
+            write_str(ir.names[value]);
+            break;
+        case IR_OPERAND_LABEL:
+            write_str(ir.names[value]);
+            break;
+        case IR_OPERAND_NUMBERED_LABEL:
+            write_str(ir.labels[value].prefix);
+            write_int(ir.labels[value].number);
+            break;
+        case IR_OPERAND_INT:
+            write_chars("int@", 4);
+            write_int(value);
+            break;
+        case IR_OPERAND_FLOAT:
+            write_chars("float@", 6);
+            write_float(ir.floats[value]);
+            break;
+        case IR_OPERAND_STRING:
+            write_chars("string@", 7);
+            write_escaped(ir.strings[value]);
+            break;
+        case IR_OPERAND_BOOL:
+            write_str(value ? "bool@true" : "bool@false");
+            break;
+        case IR_OPERAND_NIL:
+            write_chars("nil@nil", 7);
+            break;
+        case IR_OPERAND_TYPE:
+            write_str(type_names[value]);
+            break;
+    }
+}
+
+void write_ir(void) {
+    for (size_t i = 0; i < ir.count; i++) {
+        const IRInstruction* instruction = &ir.code[i];
+        write_str(opcode_names[instruction->opcode]);
+        if (instruction->opcode == IR_TEXT) { // Verbatim text is not an operand
+            write_str(ir.strings[instruction->values[0]]);
+        } else {
+            for (int j = 0; j < instruction->operand_count; j++) {
+                write_operand(ir_kind(instruction, j), instruction->values[j]);
+            }
+        }
+        write_char('\n');
+    }
+}
@@ -5,11 +5,14 @@
 */
 #include <ctype.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "lexer.h"
 #include "ascii_lookup.h"
 #include "keyword_htab.h"
+#include "lexer_scan.h"
 #include "error.h"
+#include "intern.h"
 
 #define BUFFER_LENGTH 128
 
@@ -28,39 +31,56 @@ static inline int isescseq(int c) {
     return (c == 'n' || c == 't' || c == 'r' || c == '"' || c == '\\');
 }
 
-// Appneds character to a buffer, increments index and resizes buffer if needed 
-static inline void append(Lexer* lexer, int* idx, int c) {
-    if (*idx >= lexer->buff_len - 1) { // If buffer is too small double its length
-        lexer->buff_len *= 2;
+// Skips run of whitespace characters following the current one and counts lines in it
+static inline void skip_space(Lexer* lexer) {
+    SourceBuffer* src = &lexer->src;
+    size_t newlines = 0;
+    size_t line_start = 0;
+    size_t len = scan_space(src->data + src->pos, src->len - src->pos, &newlines, &line_start);
+    if (newlines) {
+        lexer->line += newlines;
+        lexer->line_start = src->pos + line_start;
+    }
+    src->pos += len;
+}
+
+// Makes sure buffer can hold at least len characters and null terminator
+static inline void reserve(Lexer* lexer, size_t len) {
+    if (len + 1 > (size_t)lexer->buff_len) { // If buffer is too small double its length
+        while (len + 1 > (size_t)lexer->buff_len) {
+            lexer->buff_len *= 2;
+        }
         lexer->buff = realloc(lexer->buff, lexer->buff_len);
         if (lexer->buff == NULL) {
             fprintf(stderr, "Failed to reallocate memory for buffer in lexer");
             exit(INTERNAL_ERROR);
         }
     }
-
-    lexer->buff[*idx] = (char)c; // Append c
-    (*idx)++; // Increment index
-    lexer->buff[*idx] = '\0'; // Null terminate the string
-
 }
 
 int init_lexer(Lexer* lexer, FILE* fp) {
     if (lexer == NULL) {
         return -1;
     }
-    // Allocate memory for buffer used in get_token function
+    // Allocate memory for buffer used in token_text function
     lexer->buff = malloc(BUFFER_LENGTH * sizeof(char));
     if (lexer->buff == NULL) {
         return -1;
     }
 
     lexer->buff_len = BUFFER_LENGTH; // Set length of buffer
-    lexer->src = fp; // Initialize file/stdin pointer
+    if (init_source(&lexer->src, fp) != 0 || lexer->src.len > UINT32_MAX) { // Map or read whole file/stdin
+        destroy_source(&lexer->src);
+        free(lexer->buff);
+        lexer->buff = NULL;
+        return -1;
+    }
     init_lookup_table(lexer->ascii_l_table); // Initialize lookup table
-    lexer->keyword_htab = create_keyword_htab(OPTIMAL_SIZE); // Allocate memory for hash table
-    init_keyword_htab(lexer->keyword_htab); // Fill hash table with keywords
     lexer->state = START; // Set state to start
+    lexer->line = 1;
+    lexer->line_start = lexer->src.pos;
+    lexer->tokens = (TokenStream){0}; // Empty until tokenize is called
+    lexer->token_pos = 0;
 
     return 0;
 }
@@ -75,36 +95,104 @@ void destroy_lexer(Lexer* lexer) {
         lexer->buff = NULL;
     }
 
-    if (lexer->src != NULL) {
-        fclose(lexer->src);
-        lexer->src = NULL;
+    destroy_token_stream(&lexer->tokens);
+    destroy_source(&lexer->src);
+}
+
+int tokenize(Lexer* lexer) {
+    ErrorType error = error_tracker;
+    // Rough estimate of one token per 6 bytes of source saves most reallocations
+    if (init_token_stream(&lexer->tokens, lexer->src.len / 6 + 16) != 0) {
+        return -1;
+    }
+    lexer->token_pos = 0;
+
+    Token token;
+    do {
+        token = get_token(lexer);
+        if (push_token(&lexer->tokens, &token) != 0) {
+            destroy_token_stream(&lexer->tokens);
+            return -1;
+        }
+    } while (token.token_type != TOKEN_EOF && token.token_type != INVALID);
+
+    error_tracker = error; // Lexical error is reported by the parser
+    return 0;
+}
+
+const char* token_text(Lexer* lexer, const Token* token) {
+    const char* value = (const char*)lexer->src.data + token->offset;
+    size_t len = token->length;
+    size_t idx = 0;
+
+    reserve(lexer, len);
+    if (!(token->flags & TOKEN_FLAG_MULTILINE)) {
+        memcpy(lexer->buff, value, len);
+        lexer->buff[len] = '\0';
+        return lexer->buff;
+    }
+
+    // Multi line string, strip indentation and '\\' from the start of each line
+    for (size_t i = 0; i < len; i++) {
+        lexer->buff[idx++] = value[i];
+        if (value[i] == '\n' && i + 1 < len) {
+            while (value[i + 1] == ' ' || value[i + 1] == '\t') {
+                i++;
+            }
+            i += 2; // Skip '\\'
+        }
     }
+    lexer->buff[idx] = '\0';
+    return lexer->buff;
+}
 
-    if (lexer->keyword_htab != NULL) {
-        destroy_keyword_htab(lexer->keyword_htab);
-        lexer->keyword_htab = NULL;
+const char* token_intern(Lexer* lexer, const Token* token) {
+    if (token->flags & TOKEN_FLAG_MULTILINE) {
+        const char* value = token_text(lexer, token);
+        return intern(value, strlen(value));
     }
+    return intern((const char*)lexer->src.data + token->offset, token->length);
 }
 
-Token* get_token(Lexer* lexer) {
+#ifndef LEXER_DFA // Table driven implementation is in lexer_dfa.c
+Token get_token(Lexer* lexer) {
+    SourceBuffer* src = &lexer->src;
+    const unsigned char* data = src->data;
     int c;
     int hex_cnt = 0; // Counts how many hexadecimal numbers are in '\xdd' esc sequence
     int exp_flag = 0; // Flag for exponent value to prevent empty exponents
-    int idx = 0; // Index for indexing buffer for token values
+    size_t start = src->pos; // Start of the current token in source
+    size_t ml_start = 0; // Start of the multi line string value
+    size_t ml_end = 0; // End of the multi line string value (after last '\n')
+    uint32_t line = lexer->line; // Line of the current token
+    size_t line_start = lexer->line_start; // Start of the line of the current token
 
-    while ((c = fgetc(lexer->src)) != EOF) {
+// Returns token with value in <s, e) and position of the current token
+#define TOKEN(type, s, e) create_token((type), (s), (e), line, start - line_start + 1)
+// Returns invalid token and sets lexical error
+#define LEX_ERROR() do { set_error(LEXICAL_ERROR); return TOKEN(INVALID, start, src->pos); } while (0)
+
+    while ((c = src_next(src)) != EOF) {
         switch (lexer->state) {
             case START:
+                start = src->pos - 1;
+                line = lexer->line;
+                line_start = lexer->line_start;
                 switch (c) {
+                    case '\n':
+                        lexer->line++;
+                        lexer->line_start = src->pos;
+                        // fall through
                     case ' ':
                     case '\t':
-                    case '\n':
+                        skip_space(lexer); // Skip the rest of whitespace at once
                         break; // Continue in START state
                     case '/':
                         lexer->state = FWD_SLASH;
                         break;
                     case '\\':
                         lexer->state = BCK_SLASH;
+                        ml_start = src->pos + 1; // Value starts after second '\'
                         break;
                     case '@':
                         lexer->state = IMPORT;
@@ -114,15 +202,13 @@ Token* get_token(Lexer* lexer) {
                         break;
                     case '0':
                         lexer->state = ZERO;
-                        append(lexer, &idx, c);
                         break;
                     case '?':
                         lexer->state = Q_MARK;
-                        return create_token(TOKEN_Q_MARK, 0, NULL);
+                        return TOKEN(TOKEN_Q_MARK, start, src->pos);
                         break;
                     case '_':
                         lexer->state = UNDERSCORE;
-                        append(lexer, &idx, c);
                         break;
                     case '[':
                         lexer->state = L_SQ_BRACKET;
@@ -132,24 +218,20 @@ Token* get_token(Lexer* lexer) {
                     case '=':
                     case '!':
                         lexer->state = MULTI_OP;
-                        append(lexer, &idx, c);
                         break;
                     default:
                         if (isalpha(c)) {
                             lexer->state = ID_OR_KEY;
-                            append(lexer, &idx, c);
                         }
                         else if (c > '0' && c <= '9') {
                             lexer->state = INTEGER;
-                            append(lexer, &idx, c);
                         }
                         else if (isvalid(c, lexer->ascii_l_table)) {
                             // precreate tokens for single characters
-                            return create_token(lexer->ascii_l_table[c], 0, NULL);
+                            return TOKEN(lexer->ascii_l_table[c], start, src->pos);
                         }
                         else {
-                            set_error(LEXICAL_ERROR);
-                            return NULL; // Invalid character
+                            LEX_ERROR(); // Invalid character
                         }
                         break;
                 }
@@ -159,17 +241,18 @@ Token* get_token(Lexer* lexer) {
                     lexer->state = MULTI_STRING;
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL;
+                    LEX_ERROR();
                 }
                 break;
-            case MULTI_STRING: 
+            case MULTI_STRING:
                 if (c == '\n') {
-                    append(lexer, &idx, c);
+                    lexer->line++;
+                    lexer->line_start = src->pos;
+                    ml_end = src->pos;
                     lexer->state = EO_ML_STRING;
                 }
                 else {
-                    append(lexer, &idx, c);
+                    src->pos += scan_line(data + src->pos, src->len - src->pos); // Rest of the line
                 }
                 break;
             case EO_ML_STRING:
@@ -182,231 +265,193 @@ Token* get_token(Lexer* lexer) {
                 }
                 else {
                     lexer->state = START;
-                    ungetc(c, lexer->src);
-                    return create_token(TOKEN_STRING, idx, lexer->buff);
+                    src_unget(src);
+                    Token token = TOKEN(TOKEN_STRING, ml_start, ml_end);
+                    token.flags |= TOKEN_FLAG_MULTILINE;
+                    return token;
                 }
             case IMPORT:
-                if (idx < 5) {
-                    append(lexer, &idx, c);
+                if (src->pos - start < 7) {
                     break; // Continue in import state
                 }
-                else if (idx == 5) { 
-                    append(lexer, &idx, c);
-                    if (strcmp(lexer->buff, "import") == 0) {
-                        lexer->state = START;
-                        return create_token(TOKEN_IMPORT, 0, NULL);
-                    }
-                    else {
-                        set_error(LEXICAL_ERROR);
-                        return NULL;
-                    }
+                else if (memcmp(data + start + 1, "import", 6) == 0) {
+                    lexer->state = START;
+                    return TOKEN(TOKEN_IMPORT, start, src->pos);
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL;
+                    LEX_ERROR();
                 }
                 break;
             case MULTI_OP:
                 if (c == '=') {
                     lexer->state = START;
-                    switch ((int)lexer->buff[0]) {
+                    switch ((int)data[start]) {
                         case '<' :
-                            return create_token(TOKEN_LESS_EQU, 0, NULL);
+                            return TOKEN(TOKEN_LESS_EQU, start, src->pos);
                         case '>':
-                            return create_token(TOKEN_GREATER_EQU, 0, NULL);
+                            return TOKEN(TOKEN_GREATER_EQU, start, src->pos);
                         case '!':
-                            return create_token(TOKEN_NOT_EQU, 0, NULL);
+                            return TOKEN(TOKEN_NOT_EQU, start, src->pos);
                         case '=':
-                            return create_token(TOKEN_EQU, 0, NULL);
+                            return TOKEN(TOKEN_EQU, start, src->pos);
                         default:
                             break;
                     }
                 }
                 else {
                     lexer->state = START;
-                    ungetc(c, lexer->src);
-                    return create_token(lexer->ascii_l_table[(int)lexer->buff[0]], 0, NULL);
+                    src_unget(src);
+                    return TOKEN(lexer->ascii_l_table[data[start]], start, src->pos);
                 }
                 break;
             case ID_OR_KEY:
                 if (isalnum(c) || c == '_') {
-                    append(lexer, &idx, c);
+                    src->pos += scan_ident(data + src->pos, src->len - src->pos); // Rest of the identifier
                     break; // Continue in ID_OR_KEY state
                 }
                 else if (isspace(c) || isvalid(c, lexer->ascii_l_table)) {
-                    ungetc(c, lexer->src); // Put c back to stream
+                    src_unget(src); // Put c back to stream
                     lexer->state = START;
                     // find token in hash table
-                    TokenType token = find_keyword(lexer->keyword_htab, lexer->buff);
-                    if (token == TOKEN_IDENTIFIER) {
-                        return create_token(token, idx, lexer->buff); // create token for identifier
-                    }
-                    else {
-                        return create_token(token, 0, NULL); // create token for specific keyword
-                    }
+                    TokenType token = find_keyword((const char*)data + start, src->pos - start);
+                    return TOKEN(token, start, src->pos);
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL; // Invalid identifier
+                    LEX_ERROR(); // Invalid identifier
                 }
                 break;
             case STRING:
                 if (c == '"') {
                     lexer->state = START;
-                    return create_token(TOKEN_STRING, idx, lexer->buff);
+                    return TOKEN(TOKEN_STRING, start + 1, src->pos - 1);
                 }
                 if (c == '\\') {
                     lexer->state = ESC_SEQ;
-                    append(lexer, &idx, c);
                 }
                 else if (c == '\n') {
-                    set_error(LEXICAL_ERROR);
-                    return NULL; // Invalid string character
+                    LEX_ERROR(); // Invalid string character
                 }
                 else {
-                    append(lexer, &idx, c);
+                    src->pos += scan_string(data + src->pos, src->len - src->pos); // Rest of the plain characters
                     break; // Continue in STRING state
                 }
                 break;
             case ESC_SEQ:
                 if (isescseq(c)) {
                     lexer->state = STRING;
-                    append(lexer, &idx, c);
                 }
                 else if (c == 'x') {
                     lexer->state = HEX_NUM;
-                    append(lexer, &idx, c);
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL; // Invalid escape sequence
+                    LEX_ERROR(); // Invalid escape sequence
                 }
                 break;
             case HEX_NUM:
                 if (ishexnum(c) && hex_cnt < 2) {
                     hex_cnt++;
-                    append(lexer, &idx, c);
                     if (hex_cnt == 2) {
                         lexer->state = STRING;
                     }
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL;
+                    LEX_ERROR();
                 }
                 break;
             case UNDERSCORE:
                 if (isalnum(c) || c == '_') {
                     lexer->state = ID_OR_KEY;
-                    append(lexer, &idx, c);
                 }
                 else if (isspace(c) || isvalid(c, lexer->ascii_l_table)) {
                     lexer->state = START;
-                    ungetc(c, lexer->src);
-                    return create_token(TOKEN_UNDERSCORE, 0, NULL);
+                    src_unget(src);
+                    return TOKEN(TOKEN_UNDERSCORE, start, src->pos);
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL;
+                    LEX_ERROR();
                 }
                 break;
             case ZERO:
                 if (c == '.') {
                     lexer->state = FLOAT;
-                    append(lexer, &idx, c);
                 }
                 else if (isspace(c) || isvalid(c, lexer->ascii_l_table)) { // is dot valid?
                     lexer->state = START;
-                    ungetc(c, lexer->src); // Put c back to stream
-                    return create_token(TOKEN_INTEGER, 1, "0");
+                    src_unget(src); // Put c back to stream
+                    return TOKEN(TOKEN_INTEGER, start, src->pos);
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL; // Invalid number
+                    LEX_ERROR(); // Invalid number
                 }
                 break;
             case INTEGER:
                 if (c == '.') {
                     lexer->state = FLOAT;
-                    append(lexer, &idx, c);
                 }
                 else if (c == 'e' || c == 'E') {
                     lexer->state = EXPONENT;
-                    append(lexer, &idx, c);
                 }
                 else if (c >= '0' && c <= '9') {
-                    append(lexer, &idx, c);
                     break; // Continue in INTEGER state 
                 }
                 else if (isspace(c) || isvalid(c, lexer->ascii_l_table)) { // is dot valid?
                     lexer->state = START;
-                    ungetc(c, lexer->src); // Put c back to stream
-                    return create_token(TOKEN_INTEGER, idx, lexer->buff);
+                    src_unget(src); // Put c back to stream
+                    return TOKEN(TOKEN_INTEGER, start, src->pos);
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL; // Invalid integer
+                    LEX_ERROR(); // Invalid integer
                 }
                 break;
             case FLOAT:
                 if (c >= '0' && c <= '9') {
-                    append(lexer, &idx, c);
                     break; // Continue in FLOAT state
                 }
                 else if (c == 'e' || c == 'E') {
                     lexer->state = EXPONENT;
-                    append(lexer, &idx, c);
                 }
                 else if (isspace(c) || isvalid(c, lexer->ascii_l_table)) { // is dot valid?
                     lexer->state = START;
-                    ungetc(c, lexer->src);
-                    return create_token(TOKEN_FLOAT, idx, lexer->buff); // TODO
+                    src_unget(src);
+                    return TOKEN(TOKEN_FLOAT, start, src->pos);
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL; // Invalid float
+                    LEX_ERROR(); // Invalid float
                 }
                 break;
             case EXPONENT:
                 if (c == '+' || c == '-') {
                     lexer->state = SIGN;
-                    append(lexer, &idx, c);
                 }
                 else if (c >= '0' && c <= '9') {
                     exp_flag = 1;
                     lexer->state = EXPONENT_NUM;
-                    append(lexer, &idx, c);
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL;
+                    LEX_ERROR();
                 }
                 break;
             case SIGN:
                 if (c >= '0' && c <= '9') {
                     exp_flag = 1; // Set exponent flag
                     lexer->state = EXPONENT_NUM;
-                    append(lexer, &idx, c);
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL;
+                    LEX_ERROR();
                 }
                 break;
             case EXPONENT_NUM:
                 if (c >= '0' && c <= '9') {
                     exp_flag = 1; // Set exponent flag
-                    append(lexer, &idx, c);
                     break; // Continue in EXPONENT_NUM state
                 }
                 else if ((isspace(c) || isvalid(c, lexer->ascii_l_table)) && exp_flag) {
                     lexer->state = START;
-                    ungetc(c, lexer->src);
-                    return create_token(TOKEN_FLOAT, idx, lexer->buff);
+                    src_unget(src);
+                    return TOKEN(TOKEN_FLOAT, start, src->pos);
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL;
+                    LEX_ERROR();
                 }
                 break;
             case FWD_SLASH:
@@ -415,18 +460,22 @@ Token* get_token(Lexer* lexer) {
                 }
                 else if (isspace(c) || isvalid(c, lexer->ascii_l_table) || isalnum(c)) {
                     lexer->state = START;
-                    ungetc(c, lexer->src);
-                    return create_token(TOKEN_DIV, 0, NULL);
+                    src_unget(src);
+                    return TOKEN(TOKEN_DIV, start, src->pos);
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL;
+                    LEX_ERROR();
                 }
                 break;
             case COMMENT:
                 if (c == '\n') {
+                    lexer->line++;
+                    lexer->line_start = src->pos;
                     lexer->state = START;
                 }
+                else {
+                    src->pos += scan_line(data + src->pos, src->len - src->pos); // Rest of the comment
+                }
                 break; // Continue in COMMENT state
             case Q_MARK:
                 if (c == '[') {
@@ -434,52 +483,52 @@ Token* get_token(Lexer* lexer) {
                 }
                 else if (isalpha(c)) {
                     lexer->state = KEYWORD;
-                    append(lexer, &idx, c);
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL;
+                    LEX_ERROR();
                 }
                 break;
             case KEYWORD:
                 if (isalnum(c)) {
-                    append(lexer, &idx, c);
                     break; // Continue in KEYWORD state
                 }
                 else if (isspace(c) || isvalid(c, lexer->ascii_l_table)) {
                     lexer->state = START;
-                    ungetc(c, lexer->src);
+                    src_unget(src);
                     // return corresponding token stored in hash table
-                    TokenType token = find_keyword(lexer->keyword_htab, lexer->buff);
-                    return create_token(token, 0, NULL);
+                    TokenType token = find_keyword((const char*)data + start, src->pos - start);
+                    return TOKEN(token, start, src->pos);
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL;
+                    LEX_ERROR();
                 }
                 break;
             case L_SQ_BRACKET:
                 if (c == ']') {
                     lexer->state = R_SQ_BRACKET;
-                    return create_token(TOKEN_SLICE, 0, NULL);
+                    return TOKEN(TOKEN_SLICE, start, src->pos);
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL;
+                    LEX_ERROR();
                 }
                 break;
             case R_SQ_BRACKET:
                 if (isalpha(c)) {
                     lexer->state = KEYWORD;
-                    append(lexer, &idx, c);
                 }
                 else {
-                    set_error(LEXICAL_ERROR);
-                    return NULL;
+                    LEX_ERROR();
                 }
                 break;
         }
     }
 
-    return create_token(TOKEN_EOF, 0, NULL);
+    start = src->pos;
+    line = lexer->line;
+    line_start = lexer->line_start;
+    return TOKEN(TOKEN_EOF, start, start);
+
+#undef TOKEN
+#undef LEX_ERROR
 }
+#endif // LEXER_DFA
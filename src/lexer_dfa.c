@@ -0,0 +1,158 @@
+/**
+ * @file lexer_dfa.c
+ * @brief Contains table driven implementation of get_token() (built with LEXER=dfa)
+ * @authors Michal Repcik (xrepcim00)
+ *
+ * Inner loop performs one table load per character, work is done only
+ * on transitions with an action (token boundaries and new lines).
+*/
+#ifdef LEXER_DFA
+#include <string.h>
+
+#include "lexer.h"
+#include "lexer_dfa.h"
+#include "error.h"
+#include "lexer_dfa_table.h" // Generated by tools/gen_lexer_dfa.c
+
+Token get_token(Lexer* lexer) {
+    SourceBuffer* src = &lexer->src;
+    const unsigned char* data = src->data;
+    size_t pos = src->pos;
+    size_t len = src->len;
+    unsigned state = lexer->state;
+    size_t start = pos; // Start of the current token in source
+    size_t ml_start = 0; // Start of the multi line string value
+    size_t ml_end = 0; // End of the multi line string value (after last '\n')
+    uint32_t line = lexer->line; // Line of the current token
+    size_t line_start = lexer->line_start; // Start of the line of the current token
+    Token token;
+
+// Returns token with value in <s, e) and position of the current token
+#define TOKEN(type, s, e) create_token((type), (s), (e), line, start - line_start + 1)
+
+    while (pos < len) {
+        unsigned entry = dfa_table[state][dfa_class[data[pos++]]];
+        state = entry & DFA_STATE_MASK;
+        if ((entry >> DFA_STATE_BITS) == ACT_NONE) {
+            continue;
+        }
+
+        switch ((DfaAction)(entry >> DFA_STATE_BITS)) {
+            case ACT_NONE:
+                continue;
+            case ACT_NEWLINE:
+                lexer->line++;
+                lexer->line_start = pos;
+                continue;
+            case ACT_ML_NEWLINE:
+                lexer->line++;
+                lexer->line_start = pos;
+                ml_end = pos;
+                continue;
+            case ACT_MARK_ML:
+                ml_start = pos + 1; // Value starts after second '\'
+                // fall through
+            case ACT_MARK:
+                start = pos - 1;
+                line = lexer->line;
+                line_start = lexer->line_start;
+                continue;
+            case ACT_EMIT_CHAR:
+                start = pos - 1;
+                line = lexer->line;
+                line_start = lexer->line_start;
+                token = TOKEN(lexer->ascii_l_table[data[start]], start, pos);
+                break;
+            case ACT_EMIT_Q_MARK:
+                start = pos - 1;
+                line = lexer->line;
+                line_start = lexer->line_start;
+                token = TOKEN(TOKEN_Q_MARK, start, pos);
+                break;
+            case ACT_EMIT_ML_STRING:
+                pos--; // Put character back
+                token = TOKEN(TOKEN_STRING, ml_start, ml_end);
+                token.flags |= TOKEN_FLAG_MULTILINE;
+                break;
+            case ACT_EMIT_IMPORT:
+                if (memcmp(data + start + 1, "import", 6) != 0) {
+                    state = IMPORT;
+                    set_error(LEXICAL_ERROR);
+                    token = TOKEN(INVALID, start, pos);
+                    break;
+                }
+                token = TOKEN(TOKEN_IMPORT, start, pos);
+                break;
+            case ACT_EMIT_MULTI_EQ:
+                switch (data[start]) {
+                    case '<':
+                        token = TOKEN(TOKEN_LESS_EQU, start, pos);
+                        break;
+                    case '>':
+                        token = TOKEN(TOKEN_GREATER_EQU, start, pos);
+                        break;
+                    case '!':
+                        token = TOKEN(TOKEN_NOT_EQU, start, pos);
+                        break;
+                    default:
+                        token = TOKEN(TOKEN_EQU, start, pos);
+                        break;
+                }
+                break;
+            case ACT_EMIT_MULTI_OP:
+                pos--; // Put character back
+                token = TOKEN(lexer->ascii_l_table[data[start]], start, pos);
+                break;
+            case ACT_EMIT_ID:
+                pos--; // Put character back
+                token = TOKEN(find_keyword((const char*)data + start, pos - start), start, pos);
+                break;
+            case ACT_EMIT_STRING:
+                token = TOKEN(TOKEN_STRING, start + 1, pos - 1);
+                break;
+            case ACT_EMIT_UNDERSCORE:
+                pos--; // Put character back
+                token = TOKEN(TOKEN_UNDERSCORE, start, pos);
+                break;
+            case ACT_EMIT_INTEGER:
+                pos--; // Put character back
+                token = TOKEN(TOKEN_INTEGER, start, pos);
+                break;
+            case ACT_EMIT_FLOAT:
+                pos--; // Put character back
+                token = TOKEN(TOKEN_FLOAT, start, pos);
+                break;
+            case ACT_EMIT_DIV:
+                pos--; // Put character back
+                token = TOKEN(TOKEN_DIV, start, pos);
+                break;
+            case ACT_EMIT_SLICE:
+                token = TOKEN(TOKEN_SLICE, start, pos);
+                break;
+            case ACT_MARK_ERROR:
+                start = pos - 1;
+                line = lexer->line;
+                line_start = lexer->line_start;
+                // fall through
+            case ACT_ERROR:
+                set_error(LEXICAL_ERROR);
+                token = TOKEN(INVALID, start, pos);
+                break;
+        }
+
+        src->pos = pos;
+        lexer->state = (LexerState)state;
+        return token;
+    }
+
+    src->pos = pos;
+    lexer->state = (LexerState)state;
+    start = pos;
+    line = lexer->line;
+    line_start = lexer->line_start;
+    return TOKEN(TOKEN_EOF, start, start);
+
+#undef TOKEN
+}
+
+#endif // LEXER_DFA
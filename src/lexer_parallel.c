@@ -0,0 +1,205 @@
+/**
+ * @file lexer_parallel.c
+ * @brief Contains parallel implementation of the tokenize() pre-pass
+ * @authors Michal Repcik (xrepcim00)
+ *
+ * Source is split after new lines into one chunk per thread. Chunks are
+ * tokenized concurrently by independent lexers sharing the source data and
+ * their token streams are stitched in order with lines shifted. Chunk that
+ * does not end in START state (it was split inside multi line string or
+ * '@import') is lexed again together with the next chunk, so the result
+ * is always identical to the sequential tokenize().
+*/
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lexer.h"
+
+#ifndef LEXER_MIN_CHUNK
+#define LEXER_MIN_CHUNK (1 << 20) // Sources are not split into chunks smaller than this
+#endif
+
+/**
+ * @struct Chunk
+ * @brief Part of the source lexed by one thread.
+*/
+typedef struct {
+    Lexer lexer;        ///< Lexer over <begin, end) sharing source data with the main lexer.
+    size_t begin;       ///< Offset of the first character of the chunk.
+    size_t end;         ///< Offset after the last character of the chunk.
+    int ret;            ///< Return value of tokenize().
+} Chunk;
+
+// Sets up chunk lexer over <begin, end), first chunk continues from the state of the main lexer
+static void init_chunk(Chunk* chunk, const Lexer* lexer, size_t begin, size_t end) {
+    chunk->lexer = *lexer;
+    chunk->lexer.src.pos = begin;
+    chunk->lexer.src.len = end;
+    chunk->lexer.src.map = NULL; // Source is owned by the main lexer
+    chunk->lexer.src.map_len = 0;
+    chunk->lexer.src.fp = NULL;
+    chunk->lexer.buff = NULL;
+    chunk->lexer.buff_len = 0;
+    chunk->lexer.tokens = (TokenStream){0};
+    chunk->lexer.token_pos = 0;
+    if (begin != lexer->src.pos) {
+        chunk->lexer.state = START; // Chunks start right after new line
+        chunk->lexer.line = 1;
+        chunk->lexer.line_start = begin;
+    }
+    chunk->begin = begin;
+    chunk->end = end;
+    chunk->ret = 0;
+}
+
+static void* lex_chunk(void* arg) {
+    Chunk* chunk = arg;
+    chunk->ret = tokenize(&chunk->lexer);
+    return NULL;
+}
+
+// Returns 1 if the next chunk can start where this one ended (or does not have to be lexed at all)
+static int is_chunk_complete(const Chunk* chunk) {
+    const TokenStream* tokens = &chunk->lexer.tokens;
+    if (tokens->types[tokens->count - 1] == INVALID) {
+        return 1; // Stream ends here, errors never depend on characters after the chunk
+    }
+    return chunk->lexer.state == START;
+}
+
+// Returns 1 if line <begin, end) may be a part of multi line string (contains '\\')
+static int is_ml_string_line(const unsigned char* data, size_t begin, size_t end) {
+    for (size_t i = begin; i + 1 < end; i++) {
+        if (data[i] == '\\' && data[i + 1] == '\\') {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Returns offset after the first new line at or after pos that is not inside multi line string
+static size_t find_split(const unsigned char* data, size_t begin, size_t pos, size_t end) {
+    size_t line_begin = pos;
+    while (line_begin > begin && data[line_begin - 1] != '\n') {
+        line_begin--;
+    }
+    while (pos < end) {
+        const unsigned char* nl = memchr(data + pos, '\n', end - pos);
+        if (nl == NULL) {
+            return end;
+        }
+        size_t next = (size_t)(nl - data) + 1;
+        size_t i = next;
+        while (i < end && (data[i] == ' ' || data[i] == '\t')) {
+            i++;
+        }
+        // Next line does not continue multi line string and this line does not end one
+        if ((i >= end || data[i] != '\\') && !is_ml_string_line(data, line_begin, next)) {
+            return next;
+        }
+        line_begin = next;
+        pos = next;
+    }
+    return end;
+}
+
+int tokenize_parallel(Lexer* lexer, int threads) {
+    SourceBuffer* src = &lexer->src;
+    size_t len = src->len - src->pos;
+    if ((size_t)threads > len / LEXER_MIN_CHUNK) {
+        threads = (int)(len / LEXER_MIN_CHUNK);
+    }
+    if (threads <= 1) {
+        return tokenize(lexer);
+    }
+
+    Chunk* chunks = malloc(threads * sizeof(Chunk));
+    pthread_t* workers = malloc(threads * sizeof(pthread_t));
+    int* started = calloc(threads, sizeof(int));
+    if (chunks == NULL || workers == NULL || started == NULL) {
+        free(chunks);
+        free(workers);
+        free(started);
+        return -1;
+    }
+
+    // Split source into chunks, first one is lexed by this thread
+    const Lexer initial = *lexer; // Chunks are set up from the state before tokenization
+    int count = 0;
+    size_t begin = src->pos;
+    while (count < threads && begin < src->len) {
+        size_t end = src->len;
+        if (count + 1 < threads) {
+            size_t target = src->pos + len / threads * (count + 1);
+            end = find_split(src->data, begin, target > begin ? target : begin, src->len);
+        }
+        init_chunk(&chunks[count], &initial, begin, end);
+        if (count > 0) {
+            started[count] = pthread_create(&workers[count], NULL, lex_chunk, &chunks[count]) == 0;
+        }
+        begin = end;
+        count++;
+    }
+    lex_chunk(&chunks[0]);
+    for (int i = 1; i < count; i++) {
+        if (started[i]) {
+            pthread_join(workers[i], NULL);
+        }
+        else {
+            lex_chunk(&chunks[i]); // Thread could not be created, lex it here
+        }
+    }
+
+    // Stitch token streams, first line of every chunk is 1 (except the first chunk)
+    size_t total = 0;
+    for (int i = 0; i < count; i++) {
+        total += chunks[i].lexer.tokens.count;
+    }
+    int ret = init_token_stream(&lexer->tokens, total);
+    lexer->token_pos = 0;
+    uint32_t line_offset = 0;
+    for (int i = 0; ret == 0 && i < count;) {
+        Chunk* chunk = &chunks[i];
+        int next = i + 1;
+        // Chunk was split inside a token, lex it again together with the next one
+        while (chunk->ret == 0 && next < count && !is_chunk_complete(chunk)) {
+            destroy_token_stream(&chunk->lexer.tokens);
+            destroy_token_stream(&chunks[next].lexer.tokens);
+            init_chunk(chunk, &initial, chunk->begin, chunks[next].end);
+            lex_chunk(chunk);
+            next++;
+        }
+        if (chunk->ret != 0) {
+            ret = -1;
+            break;
+        }
+
+        TokenStream* tokens = &chunk->lexer.tokens;
+        int last = next == count || tokens->types[tokens->count - 1] == INVALID;
+        // Inner chunks end with EOF token, only the last one is kept
+        ret = append_tokens(&lexer->tokens, tokens, last ? tokens->count : tokens->count - 1, line_offset);
+
+        // Leave the main lexer at the end of the chunk like sequential tokenize() would
+        src->pos = chunk->lexer.src.pos;
+        lexer->state = chunk->lexer.state;
+        lexer->line = chunk->lexer.line + line_offset;
+        lexer->line_start = chunk->lexer.line_start;
+        line_offset = lexer->line - 1;
+        if (last) {
+            break;
+        }
+        i = next;
+    }
+
+    for (int i = 0; i < count; i++) {
+        destroy_token_stream(&chunks[i].lexer.tokens);
+    }
+    if (ret != 0) {
+        destroy_token_stream(&lexer->tokens);
+    }
+    free(chunks);
+    free(workers);
+    free(started);
+    return ret;
+}
@@ -3,8 +3,10 @@
  * @brief Main program
  * @authors Michal Repcik (xrepcim00)
 */
+#define _POSIX_C_SOURCE 200809L // Used for getopt()
 #include <stdlib.h>
 #include <time.h>
+#include <unistd.h>
 
 #include "lexer.h"
 #include "parser.h"
@@ -12,16 +14,70 @@
 #include "semantic_analysis.h"
 #include "symtable.h"
 #include "stack.h"
+#include "name_resolution.h"
+#include "optimizer.h"
 #include "generator.h"
+#include "writer.h"
+#include "intern.h"
+
+/**
+ * @struct Options
+ * @brief Command line options.
+*/
+typedef struct {
+    int threads;                ///< Number of lexer threads (-j).
+    const char* output;         ///< Output file (-o), NULL for stdout.
+    bool background_flush;      ///< Flag if output is written by a flush thread (-b).
+} Options;
+
+// Parses options (-j <threads>, -o <output>, -b)
+Options process_options(int argc, char** argv) {
+    Options options = {.threads = 1, .output = NULL, .background_flush = false};
+    int opt;
+    while ((opt = getopt(argc, argv, "j:o:b")) != -1) {
+        switch (opt) {
+            case 'j':
+                options.threads = atoi(optarg);
+                if (options.threads < 1) {
+                    fprintf(stderr, "Invalid number of threads\n");
+                    exit(INTERNAL_ERROR);
+                }
+                break;
+            case 'o':
+                options.output = optarg;
+                break;
+            case 'b':
+                options.background_flush = true;
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-j threads] [-o output] [-b] [file]\n", argv[0]);
+                exit(INTERNAL_ERROR);
+        }
+    }
+    return options;
+}
+
+// Opens output file, stdout if no file is given
+FILE* open_output(const char* output) {
+    if (output == NULL) {
+        return stdout;
+    }
+    FILE* out = fopen(output, "w");
+    if (out == NULL) {
+        fprintf(stderr, "Failed to open the output file\n");
+        exit(INTERNAL_ERROR);
+    }
+    return out;
+}
 
 FILE* process_file(int argc, char**  argv) {
     FILE *fp = NULL;
-    if (argc > 2) {
+    if (argc - optind > 1) {
         fprintf(stderr, "Only one argument suppported\n");
         exit(INTERNAL_ERROR);
     }
-    else if (argc == 2) {
-        fp = fopen(argv[1], "r");
+    else if (argc - optind == 1) {
+        fp = fopen(argv[optind], "r");
         if (fp == NULL) {
             fprintf(stderr, "Failed to read from the file\n");
             exit(INTERNAL_ERROR);
@@ -37,35 +93,65 @@ FILE* process_file(int argc, char**  argv) {
 int main(int argc, char** argv) {
     Lexer lexer;
     FILE* fp;
+    Options options = process_options(argc, argv);
     fp = process_file(argc, argv); 
 
     if (init_lexer(&lexer, fp) != 0) {
         exit(INTERNAL_ERROR);
     }
+    // Scan whole source up front (in parallel with -j), parser then walks the token stream
+    if (tokenize_parallel(&lexer, options.threads) != 0) {
+        destroy_lexer(&lexer);
+        exit(INTERNAL_ERROR);
+    }
 
     ASTNode* root = parse_tokens(&lexer);
     if (root == NULL) {
+        free_ast(); // Nodes created before syntax error
+        free_interns();
         destroy_lexer(&lexer);
         exit(error_tracker);
     }
 
 
+    resolve_names(root);                             // Annotate identifiers with local symbol ids
+
     SymbolTable *global_table = init_symbol_table(); // Initialize global table
-    ScopeStack *local_stack = NULL;                  // No local scope initially
+    ScopeStack *local_stack = init_scope_stack();    // Scopes of all functions
 
     semantic_analysis(root, global_table, local_stack);
+    free_scope_stack(local_stack);
     free_symbol_table(global_table);
 
-    // Generate code from the AST, if generation fails, free the AST and
-    // lexer and exit with an error code.
-    if(generate_code(root) != 0){
-        free_ast_node(root);
+    fold_constants(root);                            // Fold constant expressions and branches
+    eliminate_dead_code(root);                       // Drop unreachable and unused code
+
+    // Output is opened only for a valid program, so no file is left behind on errors
+    FILE* out = open_output(options.output);
+    if (init_writer(out, options.background_flush) != 0) {
+        free_ast();
+        free_interns();
+        destroy_lexer(&lexer);
+        exit(INTERNAL_ERROR);
+    }
+
+    // Generate code from the AST, if generation or writing of the output
+    // fails, free the AST and lexer and exit with an error code.
+    int generated = generate_code(root);
+    int written = destroy_writer();
+    if (out != stdout) {
+        written |= fclose(out) != 0;
+    }
+    if(generated != 0 || written != 0){
+        free_ast();
+        free_interns();
         destroy_lexer(&lexer);
         exit(INTERNAL_ERROR);
     }
 
     destroy_lexer(&lexer);
-    free_ast_node(root);
+    free_ast();
+    free_interns();
 
     return NO_ERROR; 
 }
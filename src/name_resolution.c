@@ -0,0 +1,275 @@
+/**
+ * @file name_resolution.c
+ * @brief Contains implementation of the name resolution pass
+ * @authors Michal Repcik (xrepcim00)
+*/
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "name_resolution.h"
+#include "intern.h"
+#include "error.h"
+
+#define RESOLVER_INITIAL_CAPACITY 64 ///< Initial capacity of all arrays, always power of two.
+
+/**
+ * @struct NameBinding
+ * @brief Declaration visible in one of the open scopes.
+*/
+typedef struct {
+    const char* name;       ///< Interned name.
+    int symbol;             ///< Local symbol id.
+    int shadowed;           ///< Index of older binding of the same name, -1 if there is none.
+} NameBinding;
+
+/**
+ * @struct Resolver
+ * @brief Scoped environment of the function that is being resolved.
+ *
+ * Bindings are kept in declaration order, scopes only remember index of their
+ * first binding. Names map to their newest binding, names are never removed
+ * from the map, only unbound.
+*/
+typedef struct {
+    NameBinding* bindings;  ///< Bindings of all open scopes.
+    int binding_count;      ///< Number of bindings.
+    int binding_capacity;   ///< Capacity of bindings.
+    int* scopes;            ///< Index of the first binding of every open scope.
+    int scope_count;        ///< Number of open scopes.
+    int scope_capacity;     ///< Capacity of scopes.
+    const char** names;     ///< Open addressing set of names, NULL for empty slot.
+    int* heads;             ///< Index of the newest binding of name in the same slot, -1 if unbound.
+    int name_count;         ///< Number of names.
+    int name_capacity;      ///< Number of name slots.
+    int symbol_count;       ///< Number of symbols of the current function.
+    const char* discard;    ///< Interned "_", never declared.
+} Resolver;
+
+static Resolver resolver = {0};
+
+static void resolver_fail(void) {
+    set_error(INTERNAL_ERROR);
+    fprintf(stderr, "Memory allocation for name resolution failed\n");
+    exit(INTERNAL_ERROR);
+}
+
+// Doubles capacity of array with elements of given size
+static void* grow_array(void* array, int* capacity, size_t size) {
+    int new_capacity = *capacity ? *capacity * 2 : RESOLVER_INITIAL_CAPACITY;
+    array = realloc(array, new_capacity * size);
+    if (array == NULL) {
+        resolver_fail();
+    }
+    *capacity = new_capacity;
+    return array;
+}
+
+// Doubles number of name slots and reinserts all names
+static void grow_names(void) {
+    int capacity = resolver.name_capacity ? resolver.name_capacity * 2 : RESOLVER_INITIAL_CAPACITY;
+    const char** names = calloc(capacity, sizeof(const char*));
+    int* heads = malloc(capacity * sizeof(int));
+    if (names == NULL || heads == NULL) {
+        resolver_fail();
+    }
+
+    for (int i = 0; i < resolver.name_capacity; i++) {
+        if (resolver.names[i] != NULL) {
+            int idx = intern_hash(resolver.names[i]) & (capacity - 1);
+            while (names[idx] != NULL) {
+                idx = (idx + 1) & (capacity - 1);
+            }
+            names[idx] = resolver.names[i];
+            heads[idx] = resolver.heads[i];
+        }
+    }
+    free(resolver.names);
+    free(resolver.heads);
+    resolver.names = names;
+    resolver.heads = heads;
+    resolver.name_capacity = capacity;
+}
+
+// Returns slot of the name, inserts it (unbound) when it is not in the set yet
+static int name_slot(const char* name) {
+    if ((resolver.name_count + 1) * 2 > resolver.name_capacity) { // Keep load factor under 0.5
+        grow_names();
+    }
+
+    int idx = intern_hash(name) & (resolver.name_capacity - 1);
+    while (resolver.names[idx] != NULL) {
+        if (resolver.names[idx] == name) {
+            return idx;
+        }
+        idx = (idx + 1) & (resolver.name_capacity - 1);
+    }
+    resolver.names[idx] = name;
+    resolver.heads[idx] = -1;
+    resolver.name_count++;
+    return idx;
+}
+
+// Returns symbol id of the visible declaration of name, -1 if there is none
+static int lookup(const char* name) {
+    int slot = name_slot(name); // Can grow the set, heads must be read afterwards
+    int head = resolver.heads[slot];
+    return head < 0 ? -1 : resolver.bindings[head].symbol;
+}
+
+// Declares name in the top scope and returns its new symbol id, redeclared is set if the name was visible
+static int declare(const char* name, bool* redeclared) {
+    int slot = name_slot(name);
+    if (redeclared != NULL) {
+        *redeclared = resolver.heads[slot] >= 0;
+    }
+
+    if (resolver.binding_count == resolver.binding_capacity) {
+        resolver.bindings = grow_array(resolver.bindings, &resolver.binding_capacity, sizeof(NameBinding));
+    }
+    NameBinding* binding = &resolver.bindings[resolver.binding_count];
+    binding->name = name;
+    binding->symbol = resolver.symbol_count++;
+    binding->shadowed = resolver.heads[slot];
+    resolver.heads[slot] = resolver.binding_count++;
+    return binding->symbol;
+}
+
+static void push_scope(void) {
+    if (resolver.scope_count == resolver.scope_capacity) {
+        resolver.scopes = grow_array(resolver.scopes, &resolver.scope_capacity, sizeof(int));
+    }
+    resolver.scopes[resolver.scope_count++] = resolver.binding_count;
+}
+
+// Removes bindings of the top scope, shadowed bindings become visible again
+static void pop_scope(void) {
+    int first = resolver.scopes[--resolver.scope_count];
+    while (resolver.binding_count > first) {
+        NameBinding* binding = &resolver.bindings[--resolver.binding_count];
+        int slot = name_slot(binding->name);
+        resolver.heads[slot] = binding->shadowed;
+    }
+}
+
+// Declares variable or constant, discard is not declared
+static int declare_variable(const char* name) {
+    return name == resolver.discard ? -1 : declare(name, NULL);
+}
+
+// Resolves node and all its children, scopes mirror the ones of semantic analysis
+static void resolve_node(ASTNode* node) {
+    if (node == NULL) {
+        return;
+    }
+
+    switch (node->type) {
+        case AST_PROGRAM:
+            for (int i = 0; i < node->Program.decl_count; i++) {
+                resolve_node(ast_child(node->Program.declarations, i));
+            }
+            break;
+
+        case AST_FN_DECL:
+            resolver.symbol_count = 0;
+            push_scope(); // Parameters
+            for (int i = 0; i < node->FnDecl.param_count; i++) {
+                resolve_node(ast_child(node->FnDecl.params, i));
+            }
+            push_scope(); // Function body
+            resolve_node(node->FnDecl.block);
+            pop_scope();
+            pop_scope();
+            node->FnDecl.local_count = resolver.symbol_count;
+            break;
+
+        case AST_PARAM:
+            node->Param.symbol = declare(node->Param.identifier, &node->Param.redeclared);
+            break;
+
+        case AST_VAR_DECL:
+            // Name is checked before the expression, but declared after it
+            node->VarDecl.redeclared = node->VarDecl.var_name != resolver.discard && lookup(node->VarDecl.var_name) >= 0;
+            resolve_node(node->VarDecl.expression);
+            node->VarDecl.symbol = declare_variable(node->VarDecl.var_name);
+            break;
+
+        case AST_CONST_DECL:
+            node->ConstDecl.redeclared = node->ConstDecl.const_name != resolver.discard && lookup(node->ConstDecl.const_name) >= 0;
+            resolve_node(node->ConstDecl.expression);
+            node->ConstDecl.symbol = declare_variable(node->ConstDecl.const_name);
+            break;
+
+        case AST_BLOCK:
+            push_scope();
+            for (int i = 0; i < node->Block.node_count; i++) {
+                resolve_node(ast_child(node->Block.nodes, i));
+            }
+            pop_scope();
+            break;
+
+        case AST_FN_CALL:
+            for (int i = 0; i < node->FnCall.arg_count; i++) {
+                resolve_node(ast_child(node->FnCall.args, i));
+            }
+            break;
+
+        case AST_ARG:
+            resolve_node(node->Argument.expression);
+            break;
+
+        case AST_WHILE:
+            push_scope(); // Condition and element bind
+            resolve_node(node->WhileCycle.expression);
+            if (node->WhileCycle.element_bind != NULL) {
+                node->WhileCycle.bind_symbol = declare(node->WhileCycle.element_bind, NULL);
+            }
+            resolve_node(node->WhileCycle.block);
+            pop_scope();
+            break;
+
+        case AST_IF_ELSE:
+            push_scope(); // Condition and element bind, bind is not visible in else block
+            resolve_node(node->IfElse.expression);
+            if (node->IfElse.element_bind != NULL) {
+                node->IfElse.bind_symbol = declare(node->IfElse.element_bind, NULL);
+            }
+            resolve_node(node->IfElse.if_block);
+            pop_scope();
+            push_scope();
+            resolve_node(node->IfElse.else_block);
+            pop_scope();
+            break;
+
+        case AST_BIN_OP:
+            resolve_node(node->BinaryOperator.left);
+            resolve_node(node->BinaryOperator.right);
+            break;
+
+        case AST_IDENTIFIER:
+            node->Identifier.symbol = lookup(node->Identifier.identifier);
+            break;
+
+        case AST_ASSIGNMENT:
+            node->Assignment.symbol = lookup(node->Assignment.identifier);
+            resolve_node(node->Assignment.expression);
+            break;
+
+        case AST_RETURN:
+            resolve_node(node->Return.expression);
+            break;
+
+        default: // Literals and null
+            break;
+    }
+}
+
+void resolve_names(ASTNode* root) {
+    resolver.discard = intern("_", 1);
+    resolve_node(root);
+
+    free(resolver.bindings);
+    free(resolver.scopes);
+    free(resolver.names);
+    free(resolver.heads);
+    resolver = (Resolver){0};
+}
@@ -0,0 +1,656 @@
+/**
+ * @file optimizer.c
+ * @brief Contains implementation of the AST optimization pass
+ * @authors Michal Repcik (xrepcim00)
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "optimizer.h"
+#include "intern.h"
+#include "error.h"
+
+/**
+ * @brief Builtins that read their arguments as variables during code generation.
+*/
+static const char* const variable_arg_builtins[] = {
+    "ifj.length", "ifj.concat", "ifj.ord", "ifj.chr"
+};
+
+/**
+ * @brief Builtins without side effects that cannot fail at run time.
+*/
+static const char* const pure_builtins[] = {
+    "ifj.i2f", "ifj.length", "ifj.concat", "ifj.strcmp", "ifj.string", "ifj.substring"
+};
+
+/**
+ * @struct Optimizer
+ * @brief State of the function that is being optimized.
+*/
+typedef struct {
+    ASTNode** constants;    ///< Literal initializing the constant, indexed by local symbol id, NULL if unknown.
+    int constant_count;     ///< Number of local symbols of the current function.
+    int* reads;             ///< Number of identifiers reading the symbol, indexed by local symbol id.
+    int* writes;            ///< Number of assignments to the symbol, indexed by local symbol id.
+    int symbol_count;       ///< Number of local symbols of the current function.
+    const char* discard;    ///< Interned "_".
+    ASTNode** functions;    ///< Open addressing map of function declarations by interned name, NULL for empty slot.
+    int function_capacity;  ///< Number of function slots, always power of two.
+} Optimizer;
+
+static Optimizer optimizer = {0};
+
+static void fold_node(ASTNode* node);
+
+static void optimizer_fail(void) {
+    set_error(INTERNAL_ERROR);
+    fprintf(stderr, "Memory allocation for optimization failed\n");
+    exit(INTERNAL_ERROR);
+}
+
+static bool is_number(ASTNode* node) {
+    return node != NULL && (node->type == AST_INT || node->type == AST_FLOAT);
+}
+
+static double number_value(ASTNode* node) {
+    return node->type == AST_INT ? node->Integer.number : node->Float.number;
+}
+
+// Rewrites node in place to integer literal, every expression node is at least as large as literal
+static void make_int(ASTNode* node, int value) {
+    node->type = AST_INT;
+    node->Integer.number = value;
+    node->expr = (ExpressionInfo){.data_type = AST_I32, .nullable = false, .constant = true, .evaluated = true};
+}
+
+// Rewrites node in place to float literal, value must be exact in float
+static void make_float(ASTNode* node, double value) {
+    node->type = AST_FLOAT;
+    node->Float.number = (float)value;
+    node->expr = (ExpressionInfo){.data_type = AST_F64, .nullable = false, .constant = true, .evaluated = true};
+}
+
+// Float literals hold only float, folded values that would be rounded stay in the code
+static bool fits_float(double value) {
+    return isfinite(value) && (double)(float)value == value;
+}
+
+// Rewrites node to number converted to the given type, returns false if it is not representable
+static bool make_number(ASTNode* node, double value, bool is_float) {
+    if (is_float) {
+        if (!fits_float(value)) {
+            return false;
+        }
+        make_float(node, value);
+    } else {
+        if (value < INT32_MIN || value > INT32_MAX) {
+            return false;
+        }
+        make_int(node, (int)value);
+    }
+    return true;
+}
+
+// Replaces identifier of a constant by its literal, converted to the type of the constant
+static void propagate_identifier(ASTNode* node) {
+    int symbol = node->Identifier.symbol;
+    if (symbol < 0 || symbol >= optimizer.constant_count || optimizer.constants[symbol] == NULL) {
+        return;
+    }
+    ASTNode* literal = optimizer.constants[symbol];
+    switch (node->expr.data_type) {
+        case AST_I32:
+            make_number(node, literal->type == AST_INT ? literal->Integer.number : (int)literal->Float.number, false);
+            break;
+        case AST_F64:
+            make_number(node, number_value(literal), true);
+            break;
+        default: // Type is not known, constant is left as it is
+            break;
+    }
+}
+
+// Folds arithmetic operation of two numeric literals, comparisons are left for conditions
+static void fold_binary_operator(ASTNode* node) {
+    ASTNode* left = node->BinaryOperator.left;
+    ASTNode* right = node->BinaryOperator.right;
+    if (!is_number(left) || !is_number(right)) {
+        return;
+    }
+
+    // Integer operand is converted when the other one is float, like in the generated code
+    if (left->type == AST_FLOAT || right->type == AST_FLOAT) {
+        double a = number_value(left);
+        double b = number_value(right);
+        switch (node->BinaryOperator.operator) {
+            case AST_PLUS: make_number(node, a + b, true); break;
+            case AST_MINUS: make_number(node, a - b, true); break;
+            case AST_MUL: make_number(node, a * b, true); break;
+            case AST_DIV:
+                if (b != 0) { // Division by zero is a run time error
+                    make_number(node, a / b, true);
+                }
+                break;
+            default:
+                break;
+        }
+        return;
+    }
+
+    int64_t a = left->Integer.number;
+    int64_t b = right->Integer.number;
+    switch (node->BinaryOperator.operator) {
+        case AST_PLUS: make_number(node, (double)(a + b), false); break;
+        case AST_MINUS: make_number(node, (double)(a - b), false); break;
+        case AST_MUL: make_number(node, (double)(a * b), false); break;
+        case AST_DIV:
+            if (b != 0) { // Truncates towards zero like IDIV, INT32_MIN / -1 overflows and is not folded
+                make_number(node, (double)(a / b), false);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Returns 1 or 0 if the condition is comparison of numeric literals, -1 otherwise
+static int constant_condition(ASTNode* node) {
+    if (node == NULL || node->type != AST_BIN_OP ||
+        !is_number(node->BinaryOperator.left) || !is_number(node->BinaryOperator.right)) {
+        return -1;
+    }
+
+    double a = number_value(node->BinaryOperator.left);
+    double b = number_value(node->BinaryOperator.right);
+    switch (node->BinaryOperator.operator) {
+        case AST_GREATER: return a > b;
+        case AST_GREATER_EQU: return a >= b;
+        case AST_LESS: return a < b;
+        case AST_LESS_EQU: return a <= b;
+        case AST_EQU: return a == b;
+        case AST_NOT_EQU: return a != b;
+        default: return -1;
+    }
+}
+
+// Rewrites node in place to block with nodes of the given block, empty block if it is NULL
+static void replace_by_block(ASTNode* node, ASTNode* block) {
+    int node_count = block != NULL ? block->Block.node_count : 0;
+    uint32_t nodes = block != NULL ? block->Block.nodes : 0;
+    node->type = AST_BLOCK;
+    node->Block.node_count = node_count;
+    node->Block.nodes = nodes;
+}
+
+static bool in_list(const char* fn_name, const char* const* list, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(fn_name, list[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool has_variable_args(const char* fn_name) {
+    return in_list(fn_name, variable_arg_builtins, sizeof(variable_arg_builtins) / sizeof(variable_arg_builtins[0]));
+}
+
+// Remembers literal of constant that can be propagated to its identifiers
+static void record_constant(ASTNode* node) {
+    int symbol = node->ConstDecl.symbol;
+    if (symbol >= 0 && symbol < optimizer.constant_count && !node->ConstDecl.nullable &&
+        is_number(node->ConstDecl.expression)) {
+        optimizer.constants[symbol] = node->ConstDecl.expression;
+    }
+}
+
+// Optimizes node and all its children
+static void fold_node(ASTNode* node) {
+    if (node == NULL) {
+        return;
+    }
+
+    switch (node->type) {
+        case AST_PROGRAM:
+            for (int i = 0; i < node->Program.decl_count; i++) {
+                fold_node(ast_child(node->Program.declarations, i));
+            }
+            break;
+
+        case AST_FN_DECL:
+            optimizer.constant_count = node->FnDecl.local_count;
+            optimizer.constants = calloc(optimizer.constant_count > 0 ? optimizer.constant_count : 1, sizeof(ASTNode*));
+            if (optimizer.constants == NULL) {
+                optimizer_fail();
+            }
+            fold_node(node->FnDecl.block);
+            free(optimizer.constants);
+            optimizer.constants = NULL;
+            optimizer.constant_count = 0;
+            break;
+
+        case AST_BLOCK:
+            for (int i = 0; i < node->Block.node_count; i++) {
+                fold_node(ast_child(node->Block.nodes, i));
+            }
+            break;
+
+        case AST_VAR_DECL:
+            fold_node(node->VarDecl.expression);
+            break;
+
+        case AST_CONST_DECL:
+            fold_node(node->ConstDecl.expression);
+            record_constant(node);
+            break;
+
+        case AST_ASSIGNMENT:
+            fold_node(node->Assignment.expression);
+            break;
+
+        case AST_RETURN:
+            fold_node(node->Return.expression);
+            break;
+
+        case AST_FN_CALL:
+            if (node->FnCall.is_builtin && has_variable_args(node->FnCall.fn_name)) {
+                break;
+            }
+            for (int i = 0; i < node->FnCall.arg_count; i++) {
+                fold_node(ast_child(node->FnCall.args, i));
+            }
+            break;
+
+        case AST_ARG:
+            fold_node(node->Argument.expression);
+            break;
+
+        case AST_WHILE:
+            if (node->WhileCycle.element_bind == NULL) { // Bind condition must stay variable
+                fold_node(node->WhileCycle.expression);
+                if (constant_condition(node->WhileCycle.expression) == 0) {
+                    replace_by_block(node, NULL);
+                    break;
+                }
+            }
+            fold_node(node->WhileCycle.block);
+            break;
+
+        case AST_IF_ELSE: {
+            if (node->IfElse.element_bind == NULL) {
+                fold_node(node->IfElse.expression);
+                int condition = constant_condition(node->IfElse.expression);
+                if (condition >= 0) {
+                    replace_by_block(node, condition ? node->IfElse.if_block : node->IfElse.else_block);
+                    fold_node(node);
+                    break;
+                }
+            }
+            fold_node(node->IfElse.if_block);
+            fold_node(node->IfElse.else_block);
+            break;
+        }
+
+        case AST_BIN_OP:
+            fold_node(node->BinaryOperator.left);
+            fold_node(node->BinaryOperator.right);
+            fold_binary_operator(node);
+            break;
+
+        case AST_IDENTIFIER:
+            propagate_identifier(node);
+            break;
+
+        default: // Literals and null
+            break;
+    }
+}
+
+void fold_constants(ASTNode* root) {
+    fold_node(root);
+    optimizer = (Optimizer){0};
+}
+
+// Returns true if control never continues after the statement (return or if with both branches returning)
+static bool terminates(ASTNode* node) {
+    if (node == NULL) {
+        return false;
+    }
+    switch (node->type) {
+        case AST_RETURN:
+            return true;
+        case AST_BLOCK:
+            return node->Block.node_count > 0 && terminates(ast_child(node->Block.nodes, node->Block.node_count - 1));
+        case AST_IF_ELSE:
+            return terminates(node->IfElse.if_block) && terminates(node->IfElse.else_block);
+        default:
+            return false;
+    }
+}
+
+// Drops statements following a terminating statement in every block of node
+static void remove_unreachable(ASTNode* node) {
+    if (node == NULL) {
+        return;
+    }
+    switch (node->type) {
+        case AST_FN_DECL:
+            remove_unreachable(node->FnDecl.block);
+            break;
+        case AST_BLOCK:
+            for (int i = 0; i < node->Block.node_count; i++) {
+                ASTNode* child = ast_child(node->Block.nodes, i);
+                remove_unreachable(child);
+                if (terminates(child)) {
+                    node->Block.node_count = i + 1;
+                }
+            }
+            break;
+        case AST_WHILE:
+            remove_unreachable(node->WhileCycle.block);
+            break;
+        case AST_IF_ELSE:
+            remove_unreachable(node->IfElse.if_block);
+            remove_unreachable(node->IfElse.else_block);
+            break;
+        default: // Other statements contain no blocks
+            break;
+    }
+}
+
+// Returns slot of the function with the given interned name, empty slot if there is none
+static int function_slot(const char* name) {
+    int idx = intern_hash(name) & (optimizer.function_capacity - 1);
+    while (optimizer.functions[idx] != NULL && optimizer.functions[idx]->FnDecl.fn_name != name) {
+        idx = (idx + 1) & (optimizer.function_capacity - 1);
+    }
+    return idx;
+}
+
+// Marks function as reachable and pushes it to the worklist, if it was not reached yet
+static void reach_function(const char* name, bool* reached, ASTNode** worklist, int* worklist_count) {
+    int slot = function_slot(name);
+    if (optimizer.functions[slot] != NULL && !reached[slot]) {
+        reached[slot] = true;
+        worklist[(*worklist_count)++] = optimizer.functions[slot];
+    }
+}
+
+// Reaches every user function called in node
+static void reach_calls(ASTNode* node, bool* reached, ASTNode** worklist, int* worklist_count) {
+    if (node == NULL) {
+        return;
+    }
+    switch (node->type) {
+        case AST_FN_DECL:
+            reach_calls(node->FnDecl.block, reached, worklist, worklist_count);
+            break;
+        case AST_BLOCK:
+            for (int i = 0; i < node->Block.node_count; i++) {
+                reach_calls(ast_child(node->Block.nodes, i), reached, worklist, worklist_count);
+            }
+            break;
+        case AST_VAR_DECL:
+        case AST_CONST_DECL:
+            reach_calls(node->VarDecl.expression, reached, worklist, worklist_count);
+            break;
+        case AST_ASSIGNMENT:
+            reach_calls(node->Assignment.expression, reached, worklist, worklist_count);
+            break;
+        case AST_RETURN:
+            reach_calls(node->Return.expression, reached, worklist, worklist_count);
+            break;
+        case AST_FN_CALL:
+            if (!node->FnCall.is_builtin) {
+                reach_function(node->FnCall.fn_name, reached, worklist, worklist_count);
+            }
+            for (int i = 0; i < node->FnCall.arg_count; i++) {
+                reach_calls(ast_child(node->FnCall.args, i), reached, worklist, worklist_count);
+            }
+            break;
+        case AST_ARG:
+            reach_calls(node->Argument.expression, reached, worklist, worklist_count);
+            break;
+        case AST_WHILE:
+            reach_calls(node->WhileCycle.expression, reached, worklist, worklist_count);
+            reach_calls(node->WhileCycle.block, reached, worklist, worklist_count);
+            break;
+        case AST_IF_ELSE:
+            reach_calls(node->IfElse.expression, reached, worklist, worklist_count);
+            reach_calls(node->IfElse.if_block, reached, worklist, worklist_count);
+            reach_calls(node->IfElse.else_block, reached, worklist, worklist_count);
+            break;
+        case AST_BIN_OP:
+            reach_calls(node->BinaryOperator.left, reached, worklist, worklist_count);
+            reach_calls(node->BinaryOperator.right, reached, worklist, worklist_count);
+            break;
+        default: // Literals, null and identifiers
+            break;
+    }
+}
+
+// Removes functions that are not reachable from main, keeps all of them if there is no main
+static void remove_unreachable_functions(ASTNode* root) {
+    int count = root->Program.decl_count;
+    optimizer.function_capacity = 1;
+    while (optimizer.function_capacity < count * 2) {
+        optimizer.function_capacity *= 2;
+    }
+    optimizer.functions = calloc(optimizer.function_capacity, sizeof(ASTNode*));
+    bool* reached = calloc(optimizer.function_capacity, sizeof(bool));
+    ASTNode** worklist = malloc((count > 0 ? count : 1) * sizeof(ASTNode*));
+    if (optimizer.functions == NULL || reached == NULL || worklist == NULL) {
+        optimizer_fail();
+    }
+
+    for (int i = 0; i < count; i++) {
+        ASTNode* decl = ast_child(root->Program.declarations, i);
+        if (decl->type == AST_FN_DECL) {
+            optimizer.functions[function_slot(decl->FnDecl.fn_name)] = decl;
+        }
+    }
+
+    int main_slot = function_slot(intern("main", 4));
+    if (optimizer.functions[main_slot] != NULL) {
+        int worklist_count = 0;
+        reach_function(intern("main", 4), reached, worklist, &worklist_count);
+        while (worklist_count > 0) {
+            reach_calls(worklist[--worklist_count], reached, worklist, &worklist_count);
+        }
+
+        // Reachable declarations are moved to the front of the program list, order is kept
+        int kept = 0;
+        for (int i = 0; i < count; i++) {
+            ASTNode* decl = ast_child(root->Program.declarations, i);
+            if (decl->type != AST_FN_DECL || reached[function_slot(decl->FnDecl.fn_name)]) {
+                ast_children.nodes[root->Program.declarations + kept++] = decl;
+            }
+        }
+        root->Program.decl_count = kept;
+    }
+
+    free(worklist);
+    free(reached);
+    free(optimizer.functions);
+    optimizer.functions = NULL;
+    optimizer.function_capacity = 0;
+}
+
+// Returns true if evaluation of the expression has no side effects and cannot fail
+static bool is_pure(ASTNode* node) {
+    if (node == NULL) {
+        return true;
+    }
+    switch (node->type) {
+        case AST_INT:
+        case AST_FLOAT:
+        case AST_STRING:
+        case AST_NULL:
+        case AST_IDENTIFIER:
+            return true;
+        case AST_BIN_OP:
+            if (node->BinaryOperator.operator == AST_DIV && // Division by zero is a run time error
+                (!is_number(node->BinaryOperator.right) || number_value(node->BinaryOperator.right) == 0)) {
+                return false;
+            }
+            return is_pure(node->BinaryOperator.left) && is_pure(node->BinaryOperator.right);
+        case AST_FN_CALL:
+            if (!node->FnCall.is_builtin ||
+                !in_list(node->FnCall.fn_name, pure_builtins, sizeof(pure_builtins) / sizeof(pure_builtins[0]))) {
+                return false;
+            }
+            for (int i = 0; i < node->FnCall.arg_count; i++) {
+                if (!is_pure(ast_child(node->FnCall.args, i)->Argument.expression)) {
+                    return false;
+                }
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Adds delta to use counts of all symbols read and assigned in node
+static void count_uses(ASTNode* node, int delta) {
+    if (node == NULL) {
+        return;
+    }
+    switch (node->type) {
+        case AST_BLOCK:
+            for (int i = 0; i < node->Block.node_count; i++) {
+                count_uses(ast_child(node->Block.nodes, i), delta);
+            }
+            break;
+        case AST_VAR_DECL:
+        case AST_CONST_DECL:
+            count_uses(node->VarDecl.expression, delta);
+            break;
+        case AST_ASSIGNMENT:
+            if (node->Assignment.symbol >= 0) {
+                optimizer.writes[node->Assignment.symbol] += delta;
+            }
+            count_uses(node->Assignment.expression, delta);
+            break;
+        case AST_RETURN:
+            count_uses(node->Return.expression, delta);
+            break;
+        case AST_FN_CALL:
+            for (int i = 0; i < node->FnCall.arg_count; i++) {
+                count_uses(ast_child(node->FnCall.args, i), delta);
+            }
+            break;
+        case AST_ARG:
+            count_uses(node->Argument.expression, delta);
+            break;
+        case AST_WHILE:
+            count_uses(node->WhileCycle.expression, delta);
+            count_uses(node->WhileCycle.block, delta);
+            break;
+        case AST_IF_ELSE:
+            count_uses(node->IfElse.expression, delta);
+            count_uses(node->IfElse.if_block, delta);
+            count_uses(node->IfElse.else_block, delta);
+            break;
+        case AST_BIN_OP:
+            count_uses(node->BinaryOperator.left, delta);
+            count_uses(node->BinaryOperator.right, delta);
+            break;
+        case AST_IDENTIFIER:
+            if (node->Identifier.symbol >= 0) {
+                optimizer.reads[node->Identifier.symbol] += delta;
+            }
+            break;
+        default: // Literals and null
+            break;
+    }
+}
+
+// Returns true if the statement only computes a value nobody reads
+static bool is_dead_statement(ASTNode* node) {
+    switch (node->type) {
+        case AST_VAR_DECL:
+        case AST_CONST_DECL: {
+            int symbol = node->VarDecl.symbol;
+            return (symbol < 0 || (optimizer.reads[symbol] == 0 && optimizer.writes[symbol] == 0)) &&
+                   is_pure(node->VarDecl.expression);
+        }
+        case AST_ASSIGNMENT: {
+            int symbol = node->Assignment.symbol;
+            bool unread = symbol >= 0 ? optimizer.reads[symbol] == 0 : node->Assignment.identifier == optimizer.discard;
+            return unread && is_pure(node->Assignment.expression);
+        }
+        default:
+            return false;
+    }
+}
+
+// Removes dead statements, blocks are walked backwards so that uses by removed statements are released first
+static void remove_dead_statements(ASTNode* node) {
+    if (node == NULL) {
+        return;
+    }
+    switch (node->type) {
+        case AST_BLOCK: {
+            bool removed = false;
+            for (int i = node->Block.node_count - 1; i >= 0; i--) {
+                ASTNode* child = ast_child(node->Block.nodes, i);
+                remove_dead_statements(child);
+                if (is_dead_statement(child)) {
+                    count_uses(child, -1);
+                    ast_children.nodes[node->Block.nodes + i] = NULL;
+                    removed = true;
+                }
+            }
+            if (removed) {
+                int kept = 0;
+                for (int i = 0; i < node->Block.node_count; i++) {
+                    ASTNode* child = ast_child(node->Block.nodes, i);
+                    if (child != NULL) {
+                        ast_children.nodes[node->Block.nodes + kept++] = child;
+                    }
+                }
+                node->Block.node_count = kept;
+            }
+            break;
+        }
+        case AST_WHILE:
+            remove_dead_statements(node->WhileCycle.block);
+            break;
+        case AST_IF_ELSE:
+            remove_dead_statements(node->IfElse.else_block);
+            remove_dead_statements(node->IfElse.if_block);
+            break;
+        default: // Other statements contain no blocks
+            break;
+    }
+}
+
+void eliminate_dead_code(ASTNode* root) {
+    optimizer.discard = intern("_", 1);
+    for (int i = 0; i < root->Program.decl_count; i++) {
+        remove_unreachable(ast_child(root->Program.declarations, i));
+    }
+    remove_unreachable_functions(root);
+
+    for (int i = 0; i < root->Program.decl_count; i++) {
+        ASTNode* decl = ast_child(root->Program.declarations, i);
+        if (decl->type != AST_FN_DECL) {
+            continue;
+        }
+        optimizer.symbol_count = decl->FnDecl.local_count;
+        optimizer.reads = calloc(optimizer.symbol_count > 0 ? optimizer.symbol_count : 1, sizeof(int));
+        optimizer.writes = calloc(optimizer.symbol_count > 0 ? optimizer.symbol_count : 1, sizeof(int));
+        if (optimizer.reads == NULL || optimizer.writes == NULL) {
+            optimizer_fail();
+        }
+        count_uses(decl->FnDecl.block, 1);
+        remove_dead_statements(decl->FnDecl.block);
+        free(optimizer.reads);
+        free(optimizer.writes);
+    }
+    optimizer = (Optimizer){0};
+}
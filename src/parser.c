@@ -8,28 +8,41 @@
 #include "parser.h"
 #include "stack_exp.h"
 #include "ast_node_stack.h"
-
-void advance_token(Token** token, Lexer* lexer) {
-    if (token && *token) {
-        free_token(*token);
+#include "intern.h"
+
+void advance_token(Token* token, Lexer* lexer) {
+    TokenStream* tokens = &lexer->tokens;
+    if (tokens->count > 0) {
+        // Walk tokens by index, last token (EOF or INVALID) is repeated
+        *token = token_at(tokens, lexer->token_pos);
+        if (lexer->token_pos + 1 < tokens->count) {
+            lexer->token_pos++;
+        }
+    }
+    else {
+        *token = get_token(lexer);
     }
-    *token = get_token(lexer);
-    if (*token == NULL) {
+    if (token->token_type == INVALID) {
         set_error(LEXICAL_ERROR);
     }
 }
 
-int check_token(Token* token, TokenType expected_type, const char* expected_value) {
+int check_token(Token* token, TokenType expected_type) {
     if (token == NULL) {
         return 0;   // Token is invalid
     }
     if (token->token_type != expected_type) {
         return 0;   // Type is different than expected
     }
-    if (expected_value != NULL) {
-        if (token->value == NULL || strcmp(token->value, expected_value) != 0) {
-            return 0;   // Token value is different from expected value
-        }
+    return 1;   // Return true
+}
+
+int check_token_value(Lexer* lexer, Token* token, TokenType expected_type, const char* expected_value) {
+    if (!check_token(token, expected_type)) {
+        return 0;   // Token is invalid or type is different than expected
+    }
+    if (strcmp(token_text(lexer, token), expected_value) != 0) {
+        return 0;   // Token value is different from expected value
     }
     return 1;   // Return true
 }
@@ -38,9 +51,9 @@ int is_end_of_expression(int paren_counter, Token* token) {
     if (token == NULL) {
         return 1; // Consider NULL token as end of expression
     }
-    return (check_token(token, TOKEN_COMMA, NULL) ||
-            check_token(token, TOKEN_SEMICOLON, NULL) ||
-            (paren_counter == 0 && check_token(token, TOKEN_R_PAREN, NULL)));
+    return (check_token(token, TOKEN_COMMA) ||
+            check_token(token, TOKEN_SEMICOLON) ||
+            (paren_counter == 0 && check_token(token, TOKEN_R_PAREN)));
 }
 
 
@@ -91,91 +104,81 @@ int is_operator_token(Token* token) {
     );
 }
 
-ASTNode* parse_operand(Lexer* lexer, Token** token) {
+ASTNode* parse_operand(Lexer* lexer, Token* token) {
     ASTNode* node = NULL;
 
-    if (check_token(*token, TOKEN_IDENTIFIER, NULL)) {
-        char* identifier = strdup((*token)->value);
-        if (!identifier) {
-            set_error(INTERNAL_ERROR);
-            return NULL;
-        }
+    if (check_token(token, TOKEN_IDENTIFIER)) {
+        const char* identifier = token_intern(lexer, token);
         advance_token(token, lexer);
-        if (*token == NULL || (*token)->token_type == TOKEN_EOF) {
+        if (token->token_type == INVALID || token->token_type == TOKEN_EOF) {
             set_error(LEXICAL_ERROR);
-            free(identifier);
             return NULL;
         }
-        if (check_token(*token, TOKEN_L_PAREN, NULL)) {
+        if (check_token(token, TOKEN_L_PAREN)) {
             node = parse_fn_call(lexer, token, identifier);
         }
-        else if (check_token(*token, TOKEN_DOT, NULL)) {
+        else if (check_token(token, TOKEN_DOT)) {
             node = parse_builtin_fn_call(lexer, token, identifier);
         }
         else {
             node = create_identifier_node(identifier);
         }
-        free(identifier);
         if (!node) {  // If AST node creation failed
             set_error(INTERNAL_ERROR);
             return NULL;
         }
     }
-    else if (check_token(*token, TOKEN_NULL, NULL)) {
+    else if (check_token(token, TOKEN_NULL)) {
         node = create_null_node();
         if (!node) {
             set_error(INTERNAL_ERROR);
             return NULL;
         }
         advance_token(token, lexer);
-        if (*token == NULL || (*token)->token_type == TOKEN_EOF) {
+        if (token->token_type == INVALID || token->token_type == TOKEN_EOF) {
             set_error(LEXICAL_ERROR);
-            free_ast_node(node);
             return NULL;
         }
     }
-    else if (check_token(*token, TOKEN_INTEGER, NULL)) {
-        node = create_i32_node(atoi((*token)->value));
+    else if (check_token(token, TOKEN_INTEGER)) {
+        node = create_i32_node(atoi(token_text(lexer, token)));
         if (!node) {
             set_error(INTERNAL_ERROR);
             return NULL;
         }
         advance_token(token, lexer);
-        if (*token == NULL || (*token)->token_type == TOKEN_EOF) {
-            free_ast_node(node);
+        if (token->token_type == INVALID || token->token_type == TOKEN_EOF) {
             set_error(LEXICAL_ERROR);
             return NULL;
         }
     } 
-    else if (check_token(*token, TOKEN_FLOAT, NULL)) {
-        node = create_f64_node(atof((*token)->value));
+    else if (check_token(token, TOKEN_FLOAT)) {
+        node = create_f64_node(atof(token_text(lexer, token)));
         if (!node) {
             set_error(INTERNAL_ERROR);
             return NULL;
         }
         advance_token(token, lexer);
-        if (*token == NULL || (*token)->token_type == TOKEN_EOF) {
+        if (token->token_type == INVALID || token->token_type == TOKEN_EOF) {
             set_error(LEXICAL_ERROR);
-            free_ast_node(node);
             return NULL;
         }
     } 
-    else if (check_token(*token, TOKEN_STRING, NULL)) {
-        node = create_string_node((*token)->value);
+    else if (check_token(token, TOKEN_STRING)) {
+        node = create_string_node(token_text(lexer, token));
         if (!node) {
             set_error(INTERNAL_ERROR);
             return NULL;
         }
         advance_token(token, lexer);
-        if (*token == NULL || (*token)->token_type == TOKEN_EOF) {
+        if (token->token_type == INVALID || token->token_type == TOKEN_EOF) {
             set_error(LEXICAL_ERROR);
-            free_ast_node(node);
             return NULL;
         }
     }
-    else if (check_token(*token, TOKEN_L_PAREN, NULL)) {
+    else if (check_token(token, TOKEN_L_PAREN)) {
         advance_token(token, lexer);
-        if (*token == NULL || (*token)->token_type == TOKEN_EOF) {
+        if (token->token_type == INVALID || token->token_type == TOKEN_EOF) {
             set_error(LEXICAL_ERROR);
             return NULL;
         }
@@ -184,15 +187,13 @@ ASTNode* parse_operand(Lexer* lexer, Token** token) {
             set_error(INTERNAL_ERROR);
             return NULL;
         }
-        if (!check_token(*token, TOKEN_R_PAREN, NULL)) {
+        if (!check_token(token, TOKEN_R_PAREN)) {
             set_error(SYNTAX_ERROR);
-            free_ast_node(node);
             return NULL;
         }
         advance_token(token, lexer);
-        if (*token == NULL || (*token)->token_type == TOKEN_EOF){
+        if (token->token_type == INVALID || token->token_type == TOKEN_EOF){
             set_error(LEXICAL_ERROR);
-            free_ast_node(node);
             return NULL;
         }
     } 
@@ -203,7 +204,7 @@ ASTNode* parse_operand(Lexer* lexer, Token** token) {
     return node;
 }
 
-ASTNode* parse_expression(Lexer* lexer, Token** token) {
+ASTNode* parse_expression(Lexer* lexer, Token* token) {
     // Initialize operator stack using stack_exp.h
     StackPtr op_stack = init_stack();
     if (!op_stack) {
@@ -221,8 +222,8 @@ ASTNode* parse_expression(Lexer* lexer, Token** token) {
     
     // Begin parsing
     int paren_counter = 0;
-    while (*token != NULL && !check_token(*token, TOKEN_EOF, NULL) && !is_end_of_expression(paren_counter, *token)) {
-        if (is_operand_token(*token)) {
+    while (token->token_type != INVALID && !check_token(token, TOKEN_EOF) && !is_end_of_expression(paren_counter, token)) {
+        if (is_operand_token(token)) {
             // Create ASTNOde for operand and push to operand stack
             ASTNode* operand = parse_operand(lexer, token);
             if (!operand) {
@@ -233,8 +234,8 @@ ASTNode* parse_expression(Lexer* lexer, Token** token) {
             }
             push_ast_node(operand_stack, operand);
         } 
-        else if (is_operator_token(*token)) {
-            int op = (*token)->token_type;
+        else if (is_operator_token(token)) {
+            int op = token->token_type;
 
             while (!is_empty(op_stack->top) &&
                    (get_precedence(op) <= get_precedence(top(op_stack)))) {
@@ -267,18 +268,18 @@ ASTNode* parse_expression(Lexer* lexer, Token** token) {
             // Pushes current operator in the operator stack
             push(op_stack, op);
             advance_token(token, lexer);
-            if (*token == NULL || (*token)->token_type == TOKEN_EOF){
+            if (token->token_type == INVALID || token->token_type == TOKEN_EOF){
                 set_error(LEXICAL_ERROR);
                 free_resources(op_stack);
                 free_ast_node_stack(operand_stack);
                 return NULL;
             }
         } 
-        else if (check_token(*token, TOKEN_L_PAREN, NULL)) {
+        else if (check_token(token, TOKEN_L_PAREN)) {
             paren_counter++;
             push(op_stack, TOKEN_L_PAREN);
             advance_token(token, lexer);
-            if (*token == NULL || (*token)->token_type == TOKEN_EOF) {
+            if (token->token_type == INVALID || token->token_type == TOKEN_EOF) {
                 set_error(LEXICAL_ERROR);
                 free_resources(op_stack);
                 free_ast_node_stack(operand_stack);
@@ -286,7 +287,7 @@ ASTNode* parse_expression(Lexer* lexer, Token** token) {
             }
 
         } 
-        else if (check_token(*token, TOKEN_R_PAREN, NULL)) {
+        else if (check_token(token, TOKEN_R_PAREN)) {
             paren_counter--;
 
             while (!is_empty(op_stack->top) && top(op_stack) != TOKEN_L_PAREN) {
@@ -328,7 +329,7 @@ ASTNode* parse_expression(Lexer* lexer, Token** token) {
             // Pop left parenthesis from the stack
             pop(op_stack);
             advance_token(token, lexer);
-            if (*token == NULL || (*token)->token_type == TOKEN_EOF) {
+            if (token->token_type == INVALID || token->token_type == TOKEN_EOF) {
                 set_error(LEXICAL_ERROR);
                 free_resources(op_stack);
                 free_ast_node_stack(operand_stack);
@@ -344,7 +345,7 @@ ASTNode* parse_expression(Lexer* lexer, Token** token) {
             return NULL;
         }
     }
-    if (*token == NULL) {
+    if (token->token_type == INVALID) {
         set_error(LEXICAL_ERROR);
         free_resources(op_stack);
         free_ast_node_stack(operand_stack);
@@ -373,12 +374,6 @@ ASTNode* parse_expression(Lexer* lexer, Token** token) {
         if (!left || !right) {
             set_error(SYNTAX_ERROR);
 
-            if (right) {
-                free_ast_node(right);
-            }
-            if (left) {
-                free_ast_node(left);
-            }
             free_resources(op_stack);
             free_ast_node_stack(operand_stack);
             return NULL;
@@ -389,9 +384,6 @@ ASTNode* parse_expression(Lexer* lexer, Token** token) {
         if (!op_node) {
             set_error(INTERNAL_ERROR);
 
-            free_ast_node(left);
-            free_ast_node(right);
-
             free_resources(op_stack);
             free_ast_node_stack(operand_stack);
             return NULL;
@@ -414,7 +406,6 @@ ASTNode* parse_expression(Lexer* lexer, Token** token) {
         set_error(SYNTAX_ERROR);
         free_resources(op_stack);
         free_ast_node_stack(operand_stack);
-        free_ast_node(expression_node);
         return NULL;
     }
     // Free the stacks
@@ -424,56 +415,56 @@ ASTNode* parse_expression(Lexer* lexer, Token** token) {
     return expression_node;
 }
 
-int parse_prolog(Lexer* lexer, Token** token) {
-    if (!check_token(*token, TOKEN_CONST, NULL)) {
+int parse_prolog(Lexer* lexer, Token* token) {
+    if (!check_token(token, TOKEN_CONST)) {
         return 0;
     }
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_IDENTIFIER, "ifj")) {
+    if (!check_token_value(lexer, token, TOKEN_IDENTIFIER, "ifj")) {
         return 0;
     }
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_ASSIGN, NULL)) {
+    if (!check_token(token, TOKEN_ASSIGN)) {
         return 0;
     }
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_IMPORT, NULL)) {
+    if (!check_token(token, TOKEN_IMPORT)) {
         return 0;
     }
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_L_PAREN, NULL)) {
+    if (!check_token(token, TOKEN_L_PAREN)) {
         return 0;
     }
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_STRING, "ifj24.zig")) {
+    if (!check_token_value(lexer, token, TOKEN_STRING, "ifj24.zig")) {
         return 0;
     }
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_R_PAREN, NULL)) {
+    if (!check_token(token, TOKEN_R_PAREN)) {
         return 0;
     }
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_SEMICOLON, NULL)) {
+    if (!check_token(token, TOKEN_SEMICOLON)) {
         return 0;
     }
     return 1; // Return true
 }
 
-int parse_element_bind(Lexer* lexer, Token** token, ASTNode* node) {
+int parse_element_bind(Lexer* lexer, Token* token, ASTNode* node) {
     advance_token(token, lexer);
     // Element bind is not there return success
-    if (!check_token(*token, TOKEN_PIPE, NULL)) {
+    if (!check_token(token, TOKEN_PIPE)) {
         return 0;
     }
     advance_token(token, lexer);
     // Incorrect element bind sequence
-    if (!check_token(*token, TOKEN_IDENTIFIER, NULL)) {
+    if (!check_token(token, TOKEN_IDENTIFIER)) {
         return 1;
     }
     // Based on node type assign element bind
     switch (node->type) {
         case AST_WHILE: {
-            node->WhileCycle.element_bind = strdup((*token)->value);
+            node->WhileCycle.element_bind = token_intern(lexer, token);
             if (node->WhileCycle.element_bind == NULL) {
                 set_error(INTERNAL_ERROR);
                 return 1;
@@ -481,7 +472,7 @@ int parse_element_bind(Lexer* lexer, Token** token, ASTNode* node) {
         }
             break;
         case AST_IF_ELSE: {
-            node->IfElse.element_bind = strdup((*token)->value);
+            node->IfElse.element_bind = token_intern(lexer, token);
             if (node->IfElse.element_bind == NULL) {
                 set_error(INTERNAL_ERROR);
                 return 1;
@@ -495,7 +486,7 @@ int parse_element_bind(Lexer* lexer, Token** token, ASTNode* node) {
     }
 
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_PIPE, NULL)) {
+    if (!check_token(token, TOKEN_PIPE)) {
         return 1;
     }
     // Advance token to get next token before checking for block
@@ -504,32 +495,31 @@ int parse_element_bind(Lexer* lexer, Token** token, ASTNode* node) {
     return 0;
 }
 
-ASTNode* parse_const_decl(Lexer* lexer, Token** token) {
+ASTNode* parse_const_decl(Lexer* lexer, Token* token) {
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_IDENTIFIER, NULL)) {
+    if (!check_token(token, TOKEN_IDENTIFIER)) {
         return NULL;
     }
-    ASTNode* const_decl_node = create_const_decl_node(AST_UNSPECIFIED, (*token)->value);
+    ASTNode* const_decl_node = create_const_decl_node(AST_UNSPECIFIED, token_intern(lexer, token));
     if (const_decl_node == NULL) {
         return NULL;
     }
     advance_token(token, lexer);
     // Optional data type
-    if (check_token(*token, TOKEN_COLON, NULL)) {
+    if (check_token(token, TOKEN_COLON)) {
         advance_token(token, lexer);
 
         // Check for question mark (nullable data type)
-        if (check_token(*token, TOKEN_Q_MARK, NULL)) {
+        if (check_token(token, TOKEN_Q_MARK)) {
             const_decl_node->ConstDecl.nullable = true;
             advance_token(token, lexer);
         }
 
-        if (token == NULL || *token == NULL) {
-            free_ast_node(const_decl_node);
+        if (token->token_type == INVALID) {
             return NULL;
         }
         // Based on token type assign data type of const decl node
-        switch ((*token)->token_type) {
+        switch (token->token_type) {
             case TOKEN_I32:
                 const_decl_node->ConstDecl.data_type = AST_I32;
                 break;
@@ -538,69 +528,63 @@ ASTNode* parse_const_decl(Lexer* lexer, Token** token) {
                 break;
             case TOKEN_SLICE:
                 advance_token(token, lexer);
-                if (!check_token(*token, TOKEN_U8, NULL)) {
-                    free_ast_node(const_decl_node);
+                if (!check_token(token, TOKEN_U8)) {
                     return NULL;
                 }
                 const_decl_node->ConstDecl.data_type = AST_SLICE;
                 break;
             default:
-                free_ast_node(const_decl_node);
                 return NULL; // Unexpected token type
                 break;
         }
         advance_token(token, lexer); // Advance for assign check
     }
-    if (!check_token(*token, TOKEN_ASSIGN, NULL)) {
-        free_ast_node(const_decl_node);
+    if (!check_token(token, TOKEN_ASSIGN)) {
         return NULL;
     }
 
     advance_token(token, lexer);
     ASTNode* expression_node = parse_expression(lexer, token);
     if (expression_node == NULL) {
-        free_ast_node(const_decl_node);
         return NULL;
     }
 
     // Connect expression node to const decl node
     const_decl_node->ConstDecl.expression = expression_node;
 
-    if(!check_token(*token, TOKEN_SEMICOLON, NULL)) {
-        free_ast_node(const_decl_node);
+    if(!check_token(token, TOKEN_SEMICOLON)) {
         return NULL;
     }
 
     return const_decl_node;
 }
 
-ASTNode* parse_var_decl(Lexer* lexer, Token** token) {
+ASTNode* parse_var_decl(Lexer* lexer, Token* token) {
     advance_token(token, lexer); // get identifier
-    if (!check_token(*token, TOKEN_IDENTIFIER, NULL)) {
+    if (!check_token(token, TOKEN_IDENTIFIER)) {
         return NULL;
     }
     // Create variable declaration node (mmust be freed when returnin NULL)
-    ASTNode* var_decl_node = create_var_decl_node(AST_UNSPECIFIED, (*token)->value);
+    ASTNode* var_decl_node = create_var_decl_node(AST_UNSPECIFIED, token_intern(lexer, token));
     if (var_decl_node == NULL) {
         return NULL;
     }
     advance_token(token, lexer);
     // Optional data type
-    if (check_token(*token, TOKEN_COLON, NULL)) {
+    if (check_token(token, TOKEN_COLON)) {
         advance_token(token, lexer);
 
         // Check for nullable data type
-        if (check_token(*token, TOKEN_Q_MARK, NULL)) {
+        if (check_token(token, TOKEN_Q_MARK)) {
             var_decl_node->VarDecl.nullable = true;
             advance_token(token, lexer);
         }
 
-        if (token == NULL || *token == NULL) {
-            free_ast_node(var_decl_node);
+        if (token->token_type == INVALID) {
             return NULL;
         }
         // Based on token type assign data type of const decl node
-        switch ((*token)->token_type) {
+        switch (token->token_type) {
             case TOKEN_I32:
                 var_decl_node->ConstDecl.data_type = AST_I32;
                 break;
@@ -609,68 +593,61 @@ ASTNode* parse_var_decl(Lexer* lexer, Token** token) {
                 break;
             case TOKEN_SLICE:
                 advance_token(token, lexer);
-                if (!check_token(*token, TOKEN_U8, NULL)) {
-                    free_ast_node(var_decl_node);
+                if (!check_token(token, TOKEN_U8)) {
                     return NULL;
                 }
                 var_decl_node->ConstDecl.data_type = AST_SLICE;
                 break;
             default:
-                free_ast_node(var_decl_node);
                 return NULL; // Unexpected token type
                 break;
         }
         advance_token(token, lexer); // Advance for assign check
     }
-    if (!check_token(*token, TOKEN_ASSIGN, NULL)) {
-        free_ast_node(var_decl_node);
+    if (!check_token(token, TOKEN_ASSIGN)) {
         return NULL;
     }
 
     advance_token(token, lexer);
     ASTNode* expression_node = parse_expression(lexer, token);
     if (expression_node == NULL) {
-        free_ast_node(var_decl_node);
         return NULL;
     }
 
     var_decl_node->VarDecl.expression = expression_node;
 
-    if (!check_token(*token, TOKEN_SEMICOLON, NULL)) {
-        free_ast_node(var_decl_node);
+    if (!check_token(token, TOKEN_SEMICOLON)) {
         return NULL;
     }
 
     return var_decl_node;
 }
 
-ASTNode* parse_fn_params(Lexer* lexer, Token** token) {
-    if (!check_token(*token, TOKEN_IDENTIFIER, NULL)) {
+ASTNode* parse_fn_params(Lexer* lexer, Token* token) {
+    if (!check_token(token, TOKEN_IDENTIFIER)) {
         return NULL;
     }
-    ASTNode* parameter = create_param_node(AST_UNSPECIFIED, (*token)->value);
+    ASTNode* parameter = create_param_node(AST_UNSPECIFIED, token_intern(lexer, token));
     if (parameter == NULL) {
         return NULL;
     }
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_COLON, NULL)) {
-        free_ast_node(parameter);
+    if (!check_token(token, TOKEN_COLON)) {
         return NULL;
     }
     advance_token(token, lexer);
 
     // Check for nullable fn parameter
-    if (check_token(*token, TOKEN_Q_MARK, NULL)) {
+    if (check_token(token, TOKEN_Q_MARK)) {
         parameter->Param.nullable = true;
         advance_token(token, lexer);
     }
 
     // Check for null pointer before acessing token type
-    if (token == NULL || *token == NULL) {
-        free_ast_node(parameter);
+    if (token->token_type == INVALID) {
         return NULL;
     }
-    switch ((*token)->token_type) {
+    switch (token->token_type) {
         case TOKEN_I32:
             parameter->Param.data_type = AST_I32;
             break;
@@ -679,56 +656,51 @@ ASTNode* parse_fn_params(Lexer* lexer, Token** token) {
             break;
         case TOKEN_SLICE:
             advance_token(token, lexer);
-            if (!check_token(*token, TOKEN_U8, NULL)) {
-                free_ast_node(parameter);
+            if (!check_token(token, TOKEN_U8)) {
                 return NULL;
             }
             parameter->Param.data_type = AST_SLICE;
             break;
         default: // Unexpected token syntax error
-            free_ast_node(parameter);
             return NULL;
             break;
     }
     advance_token(token, lexer);
     // Parenthesis after coma is alowed so we move to next
-    if (check_token(*token, TOKEN_COMMA, NULL)) {
+    if (check_token(token, TOKEN_COMMA)) {
         advance_token(token, lexer);
     }
     // If its not parenthesis or coma return NULL
-    else if (!check_token(*token, TOKEN_R_PAREN, NULL)) {
-        free_ast_node(parameter);
+    else if (!check_token(token, TOKEN_R_PAREN)) {
         return NULL;
     }
 
     return parameter;
 }
 
-ASTNode* parse_if_else(Lexer* lexer, Token** token) {
-    if (!check_token(*token, TOKEN_IF, NULL)) {
+ASTNode* parse_if_else(Lexer* lexer, Token* token) {
+    if (!check_token(token, TOKEN_IF)) {
         return NULL;
     }
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_L_PAREN, NULL)) {
+    if (!check_token(token, TOKEN_L_PAREN)) {
         return NULL;
     }
     advance_token(token, lexer);
     ASTNode* expression_node = NULL;
-    if (!check_token(*token, TOKEN_R_PAREN, NULL)) {
+    if (!check_token(token, TOKEN_R_PAREN)) {
         expression_node = parse_expression(lexer, token);
         if (expression_node == NULL) {
             return NULL;
         }
     }
-    if (!check_token(*token, TOKEN_R_PAREN, NULL)) {
-        free_ast_node(expression_node);
+    if (!check_token(token, TOKEN_R_PAREN)) {
         return NULL;
     }
 
     // Create if else node
     ASTNode* if_else_node = create_if_node();
     if (if_else_node == NULL) {
-        free_ast_node(expression_node);
         return NULL;
     }
     // Assign expression to if else node
@@ -736,14 +708,12 @@ ASTNode* parse_if_else(Lexer* lexer, Token** token) {
 
     // Check element bind 
     if (parse_element_bind(lexer, token, if_else_node) != 0) {
-        free_ast_node(if_else_node);
         return NULL;
     }
 
     // Parse if block
     ASTNode* if_block = parse_block(lexer, token);
     if (if_block == NULL) {
-        free_ast_node(if_else_node);
         return NULL; 
     }
     // Add if block to if else node
@@ -751,12 +721,11 @@ ASTNode* parse_if_else(Lexer* lexer, Token** token) {
 
     // Check for else block
     advance_token(token, lexer);
-    if (check_token(*token, TOKEN_ELSE, NULL)) {
+    if (check_token(token, TOKEN_ELSE)) {
         // Parse else block
         advance_token(token, lexer);
         ASTNode* else_block = parse_block(lexer, token);
         if (else_block == NULL) {
-            free_ast_node(if_else_node);
             return NULL;
         }
         if_else_node->IfElse.else_block = else_block;
@@ -767,41 +736,37 @@ ASTNode* parse_if_else(Lexer* lexer, Token** token) {
     return if_else_node;
 }
 
-ASTNode* parse_while(Lexer* lexer, Token** token) {
+ASTNode* parse_while(Lexer* lexer, Token* token) {
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_L_PAREN, NULL)) {
+    if (!check_token(token, TOKEN_L_PAREN)) {
         return NULL;
     }
     // Parse expression
     advance_token(token, lexer);
     ASTNode* expression_node = NULL;
-    if (!check_token(*token, TOKEN_R_PAREN, NULL)) {
+    if (!check_token(token, TOKEN_R_PAREN)) {
         expression_node = parse_expression(lexer, token);
         if (expression_node == NULL) {
             return NULL;
         }   
     }
-    if (!check_token(*token, TOKEN_R_PAREN, NULL)) {
-        free(expression_node);
+    if (!check_token(token, TOKEN_R_PAREN)) {
         return NULL;
     }
     // Create while node
     ASTNode* while_node = create_while_node();
     if (while_node == NULL) {
-        free(expression_node);
         return NULL;
     }
     // Add expression node to while node
     while_node->WhileCycle.expression = expression_node;
     // Parse element bind
     if (parse_element_bind(lexer, token, while_node) != 0) {
-        free_ast_node(while_node);
         return NULL;
     }
     // Parse block node
     ASTNode* block_node = parse_block(lexer, token);
     if (block_node == NULL) {
-        free_ast_node(while_node);
         return NULL;
     }
     while_node->WhileCycle.block = block_node;
@@ -809,14 +774,13 @@ ASTNode* parse_while(Lexer* lexer, Token** token) {
     return while_node;
 }
 
-ASTNode* parse_fn_arg(Lexer* lexer, Token** token) {
+ASTNode* parse_fn_arg(Lexer* lexer, Token* token) {
     ASTNode* arg_node = create_arg_node();
     if (arg_node == NULL) {
         return NULL;
     }
     ASTNode* expression_node = parse_expression(lexer, token);
     if (expression_node == NULL) {
-        free_ast_node(arg_node);
         return NULL;
     }
     // Add expression to argument node
@@ -824,7 +788,7 @@ ASTNode* parse_fn_arg(Lexer* lexer, Token** token) {
     return arg_node;
 }
 
-ASTNode* parse_fn_call(Lexer* lexer, Token** token, char* identifier) {
+ASTNode* parse_fn_call(Lexer* lexer, Token* token, const char* identifier) {
     // We are at '(' token
     ASTNode* fn_call = create_fn_call_node(identifier);
     if (fn_call == NULL) {
@@ -832,88 +796,84 @@ ASTNode* parse_fn_call(Lexer* lexer, Token** token, char* identifier) {
     }
     // Parse fn args
     advance_token(token, lexer);
-    while (!check_token(*token, TOKEN_R_PAREN, NULL)) {
+    while (!check_token(token, TOKEN_R_PAREN)) {
         ASTNode* fn_arg_node = parse_fn_arg(lexer, token);
         if (fn_arg_node == NULL) {
-            free_ast_node(fn_call);
             return NULL;
         }
         if (append_arg_to_fn(fn_call, fn_arg_node) != 0) {
-            free_ast_node(fn_call);
-            free_ast_node(fn_arg_node);
             return NULL;
         }
-        if (check_token(*token, TOKEN_R_PAREN, NULL)) {
+        if (check_token(token, TOKEN_R_PAREN)) {
             break;
         }
-        if (!check_token(*token, TOKEN_COMMA, NULL)) {
-            free_ast_node(fn_call);
-            free_ast_node(fn_arg_node);
+        if (!check_token(token, TOKEN_COMMA)) {
             return NULL;
         }
         advance_token(token, lexer);
     }
+    if (close_child_list(fn_call) != 0) {
+        return NULL;
+    }
     advance_token(token, lexer);   // Advance token for expr_parser
     return fn_call;
 }
 
-ASTNode* parse_builtin_fn_call(Lexer* lexer, Token** token, char* identifier) {
+ASTNode* parse_builtin_fn_call(Lexer* lexer, Token* token, const char* identifier) {
     if (strcmp(identifier, "ifj") != 0) {
         return NULL;
     }
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_IDENTIFIER, NULL)) {
+    if (!check_token(token, TOKEN_IDENTIFIER)) {
         return NULL;
     }
     // Concat ifj, dot and new id
-    int new_len = 3 + strlen((*token)->value) + 1 + 1; // 'ifj' + '.' + id + null terminator
+    const char* name = token_text(lexer, token);
+    int new_len = 3 + strlen(name) + 1 + 1; // 'ifj' + '.' + id + null terminator
     char* new_id = malloc(new_len*sizeof(char));
     if (new_id == NULL) {
         return NULL;
     }
     strcpy(new_id, identifier);
     strcat(new_id, ".");
-    strcat(new_id, (*token)->value);
+    strcat(new_id, name);
     
-    ASTNode* builtin_fn_call = create_fn_call_node(new_id);
+    ASTNode* builtin_fn_call = create_fn_call_node(intern(new_id, strlen(new_id)));
     free(new_id); // we dont need the new id anymore
     if (builtin_fn_call == NULL) {
         return NULL;
     }
     builtin_fn_call->FnCall.is_builtin = true;
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_L_PAREN, NULL)) {
-        free(builtin_fn_call);
+    if (!check_token(token, TOKEN_L_PAREN)) {
         return NULL;
     }
     advance_token(token, lexer);
     // parse expression
-    while (!check_token(*token, TOKEN_R_PAREN, NULL)) {
+    while (!check_token(token, TOKEN_R_PAREN)) {
         ASTNode* fn_arg_node = parse_fn_arg(lexer, token);
             if (fn_arg_node == NULL) {
-                free_ast_node(builtin_fn_call);
                 return NULL;
             }
             if (append_arg_to_fn(builtin_fn_call, fn_arg_node) != 0) {
-                free_ast_node(builtin_fn_call);
-                free_ast_node(fn_arg_node);
                 return NULL;
             }
-            if (check_token(*token, TOKEN_R_PAREN, NULL)) {
+            if (check_token(token, TOKEN_R_PAREN)) {
                 break;
             }
-            if (!check_token(*token, TOKEN_COMMA, NULL)) {
-                free_ast_node(builtin_fn_call);
-                free_ast_node(fn_arg_node);
+            if (!check_token(token, TOKEN_COMMA)) {
                 return NULL;
             }
             advance_token(token, lexer);
     }
+    if (close_child_list(builtin_fn_call) != 0) {
+        return NULL;
+    }
     advance_token(token, lexer); // advance token for expr_parser
     return builtin_fn_call;
 }
 
-ASTNode* parse_assignment(Lexer* lexer, Token** token, char* identifier) {
+ASTNode* parse_assignment(Lexer* lexer, Token* token, const char* identifier) {
     ASTNode* assignment_node = create_assignment_node(identifier);
     if (assignment_node == NULL) {
         return NULL;
@@ -921,12 +881,9 @@ ASTNode* parse_assignment(Lexer* lexer, Token** token, char* identifier) {
     advance_token(token, lexer);
     ASTNode* expression_node = parse_expression(lexer, token);
     if (expression_node == NULL) {
-        free_ast_node(assignment_node);
         return NULL;
     }
-    if (!check_token(*token, TOKEN_SEMICOLON, NULL)) {
-        free_ast_node(assignment_node);
-        free_ast_node(expression_node);
+    if (!check_token(token, TOKEN_SEMICOLON)) {
         return NULL;
     }
 
@@ -935,8 +892,8 @@ ASTNode* parse_assignment(Lexer* lexer, Token** token, char* identifier) {
     return assignment_node;
 }
 
-ASTNode* parse_block(Lexer* lexer, Token** token) {
-    if (!check_token(*token, TOKEN_L_BRACE, NULL)) {
+ASTNode* parse_block(Lexer* lexer, Token* token) {
+    if (!check_token(token, TOKEN_L_BRACE)) {
         return NULL;
     }
     
@@ -948,22 +905,19 @@ ASTNode* parse_block(Lexer* lexer, Token** token) {
     // Advance token before loop begins
     advance_token(token, lexer);
     // Loop untill right brace is encoutered
-    while (!check_token(*token, TOKEN_R_BRACE, NULL)) {
+    while (!check_token(token, TOKEN_R_BRACE)) {
         // Check for NULL pointer before switch
-        if (*token == NULL) {
+        if (token->token_type == INVALID) {
             return NULL;
         }
-        switch ((*token)->token_type) {
+        switch (token->token_type) {
             case TOKEN_IF: {
                 // Parse if else block and append it to block node
                 ASTNode* if_else_node = parse_if_else(lexer, token);
                 if (if_else_node == NULL) {
-                    free_ast_node(block_node);
                     return NULL;
                 }
                 if (append_node_to_block(block_node, if_else_node) != 0) {
-                    free_ast_node(if_else_node);
-                    free_ast_node(block_node);
                     return NULL;
                 }
             }
@@ -971,12 +925,9 @@ ASTNode* parse_block(Lexer* lexer, Token** token) {
             case TOKEN_WHILE: {
                 ASTNode* while_node = parse_while(lexer, token);
                 if (while_node == NULL) {
-                    free_ast_node(block_node);
                     return NULL;
                 }
                 if (append_node_to_block(block_node, while_node) != 0) {
-                    free_ast_node(while_node);
-                    free_ast_node(block_node);
                     return NULL;
                 }
                 // While parsing ends on '}', we need to advance
@@ -986,12 +937,9 @@ ASTNode* parse_block(Lexer* lexer, Token** token) {
             case TOKEN_CONST: {
                 ASTNode* const_node = parse_const_decl(lexer, token);
                 if (const_node == NULL) {
-                    free_ast_node(block_node);
                     return NULL;
                 }
                 if (append_node_to_block(block_node, const_node) != 0) {
-                    free_ast_node(const_node);
-                    free_ast_node(block_node);
                     return NULL;
                 }
                 // Const parsing ends on ';', we need to advance
@@ -1002,12 +950,9 @@ ASTNode* parse_block(Lexer* lexer, Token** token) {
                 // Dont need to advnace token like in const since its advanced within function
                 ASTNode* var_node = parse_var_decl(lexer, token);
                 if (var_node == NULL) {
-                    free_ast_node(block_node);
                     return NULL;
                 }
                 if (append_node_to_block(block_node, var_node) != 0) {
-                    free_ast_node(var_node);
-                    free_ast_node(block_node);
                     return NULL;
                 }
                 // Var parsing ends on ';', we need to advance
@@ -1016,20 +961,16 @@ ASTNode* parse_block(Lexer* lexer, Token** token) {
                break;
             case TOKEN_UNDERSCORE: {
                 advance_token(token, lexer);
-                if (check_token(*token, TOKEN_ASSIGN, NULL)) { 
-                    ASTNode* assignment_node = parse_assignment(lexer, token, "_");
+                if (check_token(token, TOKEN_ASSIGN)) { 
+                    ASTNode* assignment_node = parse_assignment(lexer, token, intern("_", 1));
                     if (assignment_node == NULL) {
-                        free_ast_node(block_node);
                         return NULL;
                     }
                     if (append_node_to_block(block_node, assignment_node) != 0) {
-                        free_ast_node(assignment_node);
-                        free_ast_node(block_node);
                         return NULL;
                     }
                 }
                 else {
-                    free_ast_node(block_node);
                     return NULL;
                 }
                 advance_token(token, lexer);
@@ -1038,166 +979,136 @@ ASTNode* parse_block(Lexer* lexer, Token** token) {
             case TOKEN_IDENTIFIER: {
                 // Save name of the identifier
                 // What about built in fn?
-                char* identifier = strdup((*token)->value);
+                const char* identifier = token_intern(lexer, token);
                 advance_token(token, lexer);
-                if (check_token(*token, TOKEN_ASSIGN, NULL)) {
+                if (check_token(token, TOKEN_ASSIGN)) {
                     ASTNode* assignment_node = parse_assignment(lexer, token, identifier);
                     if (assignment_node == NULL) {
-                        free(identifier);
-                        free_ast_node(block_node);
                         return NULL;
                     }
                     if (append_node_to_block(block_node, assignment_node) != 0) {
-                        free(identifier);
-                        free_ast_node(assignment_node);
-                        free_ast_node(block_node);
                         return NULL;
                     }
                 }
-                else if (check_token(*token, TOKEN_L_PAREN, NULL)) {
+                else if (check_token(token, TOKEN_L_PAREN)) {
                     ASTNode* fn_call_node = parse_fn_call(lexer, token, identifier);
                     if (fn_call_node == NULL) {
-                        free(identifier);
-                        free_ast_node(block_node);
                         return NULL;
                     }
                     if (append_node_to_block(block_node, fn_call_node) != 0) {
-                        free(identifier);
-                        free_ast_node(fn_call_node);
-                        free_ast_node(block_node);
                         return NULL;
                     }
-                    if (!check_token(*token, TOKEN_SEMICOLON, NULL)) {
-                        free(identifier);
-                        free_ast_node(block_node);
+                    if (!check_token(token, TOKEN_SEMICOLON)) {
                         return NULL;
                     }
                 }
-                else if (check_token(*token, TOKEN_DOT, NULL)) {
+                else if (check_token(token, TOKEN_DOT)) {
                     ASTNode* builtin_fn_call = parse_builtin_fn_call(lexer, token, identifier);
                     if (builtin_fn_call == NULL) {
-                        free(identifier);
-                        free_ast_node(block_node);
                         return NULL;
                     }
                     if (append_node_to_block(block_node, builtin_fn_call) != 0) {
-                        free(identifier);
-                        free_ast_node(builtin_fn_call);
-                        free_ast_node(block_node);
                         return NULL;
                     }
-                    if (!check_token(*token, TOKEN_SEMICOLON, NULL)) {
-                        free(identifier);
-                        free_ast_node(block_node);
+                    if (!check_token(token, TOKEN_SEMICOLON)) {
                         return NULL;
                     }
                 }
                 else {
-                    free(identifier);
-                    free_ast_node(block_node);
                     return NULL;
                 }
-                free(identifier);
                 advance_token(token, lexer); // assignment and fn call end on ';'
             }
                break;
             case TOKEN_RETURN: {
                 ASTNode* return_node = create_return_node();
                 if (return_node == NULL) {
-                    free_ast_node(block_node);
                     return NULL;
                 }
                 advance_token(token, lexer);
-                if (check_token(*token, TOKEN_SEMICOLON, NULL)) {
+                if (check_token(token, TOKEN_SEMICOLON)) {
                     advance_token(token, lexer);
                     if (append_node_to_block(block_node, return_node) != 0) {
-                        free_ast_node(block_node);
-                        free_ast_node(return_node);
                         return NULL;
                     }
                     break;
                 }
                 ASTNode* expression_node = parse_expression(lexer, token);
                 if (expression_node == NULL) {
-                    free_ast_node(block_node);
-                    free_ast_node(return_node);
                     return NULL;
                 }
                 return_node->Return.expression = expression_node;
                 if (append_node_to_block(block_node, return_node) != 0) {
-                    free_ast_node(block_node);
-                    free_ast_node(return_node);
                     return NULL;
                 }
-                if (!check_token(*token, TOKEN_SEMICOLON, NULL)) {
-                    free_ast_node(block_node);
+                if (!check_token(token, TOKEN_SEMICOLON)) {
                     return NULL;
                 }
                 advance_token(token, lexer);
                 break;
             }
             default:
-                free_ast_node(block_node);
                 return NULL;
                 break;
         }
     }
+    if (close_child_list(block_node) != 0) {
+        return NULL;
+    }
 
     return block_node;
 }
 
-ASTNode* parse_fn_decl(Lexer* lexer, Token** token) {
+ASTNode* parse_fn_decl(Lexer* lexer, Token* token) {
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_FN, NULL)) {
+    if (!check_token(token, TOKEN_FN)) {
         return NULL;
     }
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_IDENTIFIER, NULL)) {
+    if (!check_token(token, TOKEN_IDENTIFIER)) {
         return NULL;
     }
     // Create node for function declaration
-    ASTNode* fn_decl_node =  create_fn_decl_node((*token)->value);
+    ASTNode* fn_decl_node =  create_fn_decl_node(token_intern(lexer, token));
     if (fn_decl_node == NULL) {
         return NULL;
     }
     advance_token(token, lexer);
-    if (!check_token(*token, TOKEN_L_PAREN, NULL)) {
-        free_ast_node(fn_decl_node);
+    if (!check_token(token, TOKEN_L_PAREN)) {
         return NULL;
     }
     advance_token(token, lexer);
     // Loop until we encouter right parenthesis or if something goes wrong within the loop
-    while (!check_token(*token, TOKEN_R_PAREN, NULL)) {
+    while (!check_token(token, TOKEN_R_PAREN)) {
         ASTNode* param_node = parse_fn_params(lexer, token);
         if (param_node == NULL) {
-            free_ast_node(fn_decl_node);
             return NULL;
         }
         // Append parameter to function
         if (append_param_to_fn(fn_decl_node, param_node) != 0) {
-            free_ast_node(fn_decl_node);
             return NULL;
         }
     }
+    if (close_child_list(fn_decl_node) != 0) {
+        return NULL;
+    }
     advance_token(token, lexer);
 
     // Check for nullable data type
-    if (check_token(*token, TOKEN_Q_MARK, NULL)) {
+    if (check_token(token, TOKEN_Q_MARK)) {
         fn_decl_node->FnDecl.nullable = true;
         advance_token(token, lexer);
-        if (check_token(*token, TOKEN_VOID, NULL)) {
-            free_ast_node(fn_decl_node);
+        if (check_token(token, TOKEN_VOID)) {
             return NULL;
         }
     }
 
     // check for NULL pointer to prevent SEGFAULT
-    if (token == NULL || *token == NULL) {
-        free_ast_node(fn_decl_node);
+    if (token->token_type == INVALID) {
         return NULL;
     }
     // Check for return type
-    switch ((*token)->token_type) {
+    switch (token->token_type) {
         case TOKEN_VOID:
             fn_decl_node->FnDecl.return_type = AST_VOID;
             break;
@@ -1209,15 +1120,13 @@ ASTNode* parse_fn_decl(Lexer* lexer, Token** token) {
             break;
         case TOKEN_SLICE:
             advance_token(token, lexer);
-            if (!check_token(*token, TOKEN_U8, NULL)) {
-                free_ast_node(fn_decl_node);
+            if (!check_token(token, TOKEN_U8)) {
                 return NULL;
             }
             fn_decl_node->FnDecl.return_type = AST_SLICE;
             break;
         // add more
         default: // Unexpected token syntax error
-            free_ast_node(fn_decl_node);
             return NULL;
             break;
     }
@@ -1226,7 +1135,6 @@ ASTNode* parse_fn_decl(Lexer* lexer, Token** token) {
     advance_token(token, lexer);
     ASTNode* block_node = parse_block(lexer, token);
     if (block_node == NULL) {
-        free_ast_node(fn_decl_node);
         return NULL;
     }
     fn_decl_node->FnDecl.block = block_node;
@@ -1235,23 +1143,23 @@ ASTNode* parse_fn_decl(Lexer* lexer, Token** token) {
 }
 
 ASTNode* parse_tokens(Lexer* lexer) {
-    Token* token = get_token(lexer);
-    if (token == NULL) {
+    Token token;
+    advance_token(&token, lexer);
+    if (token.token_type == INVALID) {
         return NULL; // idk (empty code allowed ?)
     }
     
     // Prolog must be at the start so we check it first?
     if (!parse_prolog(lexer, &token)) {
-        free_token(token);
         set_error(SYNTAX_ERROR);
         return NULL;
     }
     advance_token(&token, lexer);
     ASTNode* program_node = create_program_node();  // Create root (program node)
     // Loop until the token is EOF
-    while (!check_token(token, TOKEN_EOF, NULL)) {
+    while (!check_token(&token, TOKEN_EOF)) {
         // PUB
-        if (check_token(token, TOKEN_PUB, NULL)) {
+        if (check_token(&token, TOKEN_PUB)) {
             ASTNode* fn_decl = parse_fn_decl(lexer, &token);
             if (fn_decl != NULL) {
                 if (append_decl_to_prog(program_node, fn_decl) != 0) {
@@ -1269,15 +1177,15 @@ ASTNode* parse_tokens(Lexer* lexer) {
 
         advance_token(&token, lexer);
     }
+    if (close_child_list(program_node) != 0) {
+        goto error;
+    }
 
-    free_token(token);
     return program_node;
 
     // Error handle for go to
     error:
         // set error ot syntax error if no lexical or internal error was found before
         set_error(SYNTAX_ERROR);
-        free_ast_node(program_node);
-        free_token(token);
         return NULL;
 }
@@ -0,0 +1,209 @@
+/**
+ * @file peephole.c
+ * @brief Contains implementation of the peephole pass over generated instructions
+ * @authors Michal Repcik (xrepcim00)
+*/
+#include <stdio.h>
+#include <string.h>
+
+#include "peephole.h"
+#include "ir.h"
+
+/**
+ * @var size_t count
+ * @brief Number of rewritten instructions, they replace the start of ir.code.
+ *
+ * Rewrites never make the program longer, so the rewritten list never
+ * overtakes the instruction that is being read.
+*/
+static size_t count = 0;
+
+static bool has_opcode(size_t back, IROpcode opcode) {
+    return count >= back && ir.code[count - back].opcode == opcode;
+}
+
+static bool pushes_bool(size_t back, bool value) {
+    if (!has_opcode(back, IR_PUSHS)) {
+        return false;
+    }
+    const IRInstruction* push = &ir.code[count - back];
+    return ir_kind(push, 0) == IR_OPERAND_BOOL && push->values[0] == value;
+}
+
+// Operands with the same value in different pools (floats, strings) are considered different
+static bool same_operand(const IRInstruction* a, int i, const IRInstruction* b, int j) {
+    IROperandKind kind = ir_kind(a, i);
+    if (kind != ir_kind(b, j)) {
+        return false;
+    }
+    if (kind == IR_OPERAND_NUMBERED_LABEL) {
+        const IRLabel* first = &ir.labels[a->values[i]];
+        const IRLabel* second = &ir.labels[b->values[j]];
+        return first->number == second->number &&
+               (first->prefix == second->prefix || strcmp(first->prefix, second->prefix) == 0);
+    }
+    return a->values[i] == b->values[j];
+}
+
+static void copy_operand(IRInstruction* to, int i, const IRInstruction* from, int j) {
+    to->kinds = (uint16_t)((to->kinds & ~(0xf << (4 * i))) | (ir_kind(from, j) << (4 * i)));
+    to->values[i] = from->values[j];
+}
+
+// PUSHS a, POPS b -> MOVE b a
+static bool rewrite_pops(void) {
+    if (!has_opcode(2, IR_PUSHS)) {
+        return false;
+    }
+    const IRInstruction* push = &ir.code[count - 2];
+    const IRInstruction* pop = &ir.code[count - 1];
+    if (same_operand(push, 0, pop, 0)) {
+        count -= 2;
+        return true;
+    }
+
+    IRInstruction move = {.opcode = IR_MOVE, .operand_count = 2};
+    copy_operand(&move, 0, pop, 0);
+    copy_operand(&move, 1, push, 0);
+    ir.code[count - 2] = move;
+    count--;
+    return true;
+}
+
+// Fuses comparison or pushed operands with conditional jump on the stack
+static bool rewrite_conditional_jump(void) {
+    IRInstruction jump = ir.code[count - 1];
+
+    // EQS, PUSHS bool@b, JUMPIFEQS L -> JUMPIFEQS L (b is true) or JUMPIFNEQS L (b is false)
+    if (jump.opcode == IR_JUMPIFEQS && has_opcode(3, IR_EQS) && (pushes_bool(2, false) || pushes_bool(2, true))) {
+        jump.opcode = pushes_bool(2, true) ? IR_JUMPIFEQS : IR_JUMPIFNEQS;
+        count -= 2;
+        ir.code[count - 1] = jump;
+        return true;
+    }
+
+    // NOTS, PUSHS bool@false, JUMPIFEQS L -> PUSHS bool@true, JUMPIFEQS L
+    if (jump.opcode == IR_JUMPIFEQS && has_opcode(3, IR_NOTS) && pushes_bool(2, false)) {
+        ir.code[count - 3] = ir.code[count - 2];
+        ir.code[count - 3].values[0] = true;
+        ir.code[count - 2] = jump;
+        count--;
+        return true;
+    }
+
+    // PUSHS a, PUSHS b, JUMPIF(N)EQS L -> JUMPIF(N)EQ L a b
+    if (has_opcode(2, IR_PUSHS) && has_opcode(3, IR_PUSHS)) {
+        IRInstruction fused = {.opcode = jump.opcode == IR_JUMPIFEQS ? IR_JUMPIFEQ : IR_JUMPIFNEQ, .operand_count = 3};
+        copy_operand(&fused, 0, &jump, 0);
+        copy_operand(&fused, 1, &ir.code[count - 3], 0);
+        copy_operand(&fused, 2, &ir.code[count - 2], 0);
+        count -= 2;
+        ir.code[count - 1] = fused;
+        return true;
+    }
+    return false;
+}
+
+// JUMP L, labels and empty lines, LABEL L -> labels and empty lines, LABEL L
+static bool rewrite_label(void) {
+    const IRInstruction* label = &ir.code[count - 1];
+    size_t first = count - 1;
+    while (first > 0 && (ir.code[first - 1].opcode == IR_LABEL || ir.code[first - 1].opcode == IR_BLANK)) {
+        first--;
+    }
+    if (first == 0 || ir.code[first - 1].opcode != IR_JUMP || !same_operand(&ir.code[first - 1], 0, label, 0)) {
+        return false;
+    }
+    memmove(&ir.code[first - 1], &ir.code[first], (count - first) * sizeof(IRInstruction));
+    count--;
+    return true;
+}
+
+// Rewrites the end of the rewritten list, returns true if anything changed
+static bool rewrite_tail(void) {
+    if (count == 0) {
+        return false;
+    }
+    switch (ir.code[count - 1].opcode) {
+        case IR_POPS:
+            return rewrite_pops();
+        case IR_JUMPIFEQS:
+        case IR_JUMPIFNEQS:
+            return rewrite_conditional_jump();
+        case IR_LABEL:
+            return rewrite_label();
+        default:
+            return false;
+    }
+}
+
+static bool is_literal_write(const IRInstruction* instruction) {
+    return instruction->opcode == IR_WRITE &&
+           (ir_kind(instruction, 0) == IR_OPERAND_STRING || ir_kind(instruction, 0) == IR_OPERAND_INT);
+}
+
+// Returns text written by WRITE of constant, number is buffer for int constants
+static const char* literal_text(const IRInstruction* write, char number[16]) {
+    if (ir_kind(write, 0) == IR_OPERAND_STRING) {
+        return ir.strings[write->values[0]];
+    }
+    snprintf(number, 16, "%d", (int)write->values[0]);
+    return number;
+}
+
+// Returns end of the run of constant writes starting at start
+static size_t literal_run_end(size_t start, size_t end) {
+    char number[16];
+    size_t i = start + 1;
+    while (i < end && is_literal_write(&ir.code[i])) {
+        // Backslash followed by 'n' is escape of newline (see write_ir), it must not appear at the joint
+        const char* previous = literal_text(&ir.code[i - 1], number);
+        size_t length = strlen(previous);
+        if (length > 0 && previous[length - 1] == '\\' && literal_text(&ir.code[i], number)[0] == 'n') {
+            break;
+        }
+        i++;
+    }
+    return i;
+}
+
+// Returns one WRITE of concatenated constants of writes from start to end
+static IRInstruction merge_writes(size_t start, size_t end) {
+    char number[16];
+    size_t length = 0;
+    for (size_t i = start; i < end; i++) {
+        length += strlen(literal_text(&ir.code[i], number));
+    }
+
+    char* text = ir_string_buffer(length);
+    length = 0;
+    for (size_t i = start; i < end; i++) {
+        const char* part = literal_text(&ir.code[i], number);
+        size_t part_length = strlen(part);
+        memcpy(text + length, part, part_length);
+        length += part_length;
+    }
+    text[length] = '\0';
+
+    IRInstruction write = {.opcode = IR_WRITE, .operand_count = 1, .kinds = IR_OPERAND_STRING};
+    write.values[0] = ir_string(text);
+    return write;
+}
+
+void peephole_ir(void) {
+    size_t total = ir.count;
+    count = 0;
+    for (size_t i = 0; i < total; i++) {
+        size_t end = is_literal_write(&ir.code[i]) ? literal_run_end(i, total) : i + 1;
+        if (end > i + 1) {
+            ir.code[count++] = merge_writes(i, end);
+            i = end - 1;
+        } else {
+            ir.code[count++] = ir.code[i];
+        }
+        while (rewrite_tail()) {
+            // Result of a rewrite can match another pattern
+        }
+    }
+    ir.count = count;
+}
@@ -17,11 +17,14 @@
 #include "stack.h"
 #include "error.h"
 #include "semantic_analysis.h"
+#include "intern.h"
 
 void process_declaration(
     SymbolTable *global_table,
     ScopeStack *local_stack,
     const char *name,
+    int symbol,
+    bool redeclared,
     DataType data_type,
     ASTNode *expression,
     bool is_constant,
@@ -71,7 +74,7 @@ bool isRelationalOperator(OperatorType op) {
 unsigned int unused_vars_funcs_frame(SymbolTable *current_table) {
 
     for (int j = 0; j < current_table->capacity; j++) {
-        Symbol *symbol = current_table->symbols[j];
+        Symbol *symbol = symbol_at(current_table, j);
 
         // We skip symbol which has not been assigned a value (null)
         if (!symbol) {
@@ -94,22 +97,19 @@ unsigned int unused_vars_funcs_frame(SymbolTable *current_table) {
     return 0;
 }
 
-void process_binding(ASTNode *expression, SymbolTable *global_table, ScopeStack *local_stack, Frame *current_frame, const char *bind_name, DataType condition_type, bool has_literal) {
-    OperatorType operator = expression->BinaryOperator.operator;
-
-    // No operator present in the expression should result in error
-    if (!operator) {
+void process_binding(ASTNode *expression, SymbolTable *global_table, ScopeStack *local_stack, const char *bind_name, int bind_symbol, DataType condition_type, bool has_literal) {
+    // Null can't be bound and no operator present in the expression should result in error
+    // (operator is read only from binary operator nodes, other nodes are smaller)
+    if (expression->type == AST_NULL || (expression->type == AST_BIN_OP && !expression->BinaryOperator.operator)) {
         exit(SEMANTIC_ERROR_TYPE_COMPAT);
     }
 
-    // Perform semantic analysis on the identifier / function call
-    semantic_analysis(expression, global_table, local_stack);
+    // Identifier / function call was already analyzed when the caller evaluated type of the condition
 
     if (expression->type == AST_IDENTIFIER) {
 
-        // Look up the symbol in the scope
-        const char *name = expression->Identifier.identifier;
-        Symbol *identifier = lookup_symbol_in_scope(local_stack, name, current_frame);
+        // Symbol was resolved before the analysis
+        Symbol *identifier = local_symbol(local_stack, expression->Identifier.symbol);
 
         // Identifiers which are not nullable can't be used in binding
         if (!identifier->var.is_nullable) {
@@ -118,7 +118,7 @@ void process_binding(ASTNode *expression, SymbolTable *global_table, ScopeStack
 
         // Identifier is added to the appropriate symbol table with temporary variable which behaves as
         // constant declaration and inherits has_literal, value, nullability and type attributes from the binding variable
-        add_variable_symbol(current_frame->symbol_table, bind_name, condition_type, true, false, has_literal, identifier->var.value);
+        add_scope_variable(local_stack, bind_symbol, bind_name, condition_type, true, false, has_literal, identifier->var.value);
         return;
 
     } else if (expression->type == AST_FN_CALL) {
@@ -134,13 +134,13 @@ void process_binding(ASTNode *expression, SymbolTable *global_table, ScopeStack
 
         // Function call is added to the appropriate symbol table with temporary variable which behaves as constant declaration 
         // constant declaration and doesnt inherit value, because there is none, inherits just function type and and constant declaration behaviour
-        add_variable_symbol(current_frame->symbol_table, bind_name, fn_symbol->func.type, true, false, false, 0);
+        add_scope_variable(local_stack, bind_symbol, bind_name, fn_symbol->func.type, true, false, false, 0);
         return;
 
     } else if (expression->type == AST_NULL) {
 
         // Even null can be used as binding operator so we add it too according to the function parameters
-        add_variable_symbol(current_frame->symbol_table, bind_name, condition_type, true, false, has_literal, 0);
+        add_scope_variable(local_stack, bind_symbol, bind_name, condition_type, true, false, has_literal, 0);
         return;
         
     }
@@ -148,8 +148,8 @@ void process_binding(ASTNode *expression, SymbolTable *global_table, ScopeStack
     exit(SEMANTIC_ERROR_TYPE_COMPAT);
 }
 
-DataType evaluate_condition(ASTNode *expression, SymbolTable *global_table, ScopeStack *local_stack, Frame *current_frame) {
-    DataType condition_type = evaluate_expression_type(expression, global_table, local_stack, current_frame);
+DataType evaluate_condition(ASTNode *expression, SymbolTable *global_table, ScopeStack *local_stack) {
+    DataType condition_type = evaluate_expression_type(expression, global_table, local_stack);
 
     // Ensures the condition is a boolean-compatible type
     if (condition_type != AST_I32) { 
@@ -163,7 +163,7 @@ DataType evaluate_condition(ASTNode *expression, SymbolTable *global_table, Scop
 void check_main_function(SymbolTable *global_table) {
 
     // Lookup the main() function in the global symbol table
-    Symbol *main_symbol = lookup_symbol(global_table, "main");
+    Symbol *main_symbol = lookup_symbol(global_table, intern("main", 4));
 
     // Main function must be present in the code so we check if the main function has been declared
     if (main_symbol == NULL || main_symbol->type != SYMBOL_FUNC) {
@@ -175,10 +175,8 @@ void check_main_function(SymbolTable *global_table) {
         exit(SEMANTIC_ERROR_PARAMS);
     }
 
-    ScopeStack *main_scope_stack = main_symbol->func.scope_stack;
-
     // Check if the main function has zero parameters, as it should according to the assignment
-    if (main_scope_stack == NULL || main_scope_stack->frames[0]->symbol_table->count > 0) {
+    if (main_symbol->func.fn_node->FnDecl.param_count > 0) {
         
         exit(SEMANTIC_ERROR_PARAMS);
     }
@@ -197,36 +195,15 @@ DataType deduce_builtin_function_type(const char *fn_name) {
     exit(SEMANTIC_ERROR_UNDEFINED);
 }
 
-bool evaluate_nullable_operand(SymbolTable *global_table, ASTNode *node, ScopeStack *local_stack, Frame *local_frame) {
-        
-    // No other node than identifier or function call can get here so we dont check for anything else
-    bool is_nullable = false;
-    if (node->type == AST_IDENTIFIER) {
-        Symbol *symbol = lookup_symbol_in_scope(local_stack, node->Identifier.identifier, local_frame);
+bool builtin_is_nullable(const char *fn_name) {
 
-        // Setting flag for nullability which is used in evaluate_operator_type function to set flags when the operand is nullable
-        is_nullable = symbol->var.is_nullable;
-
-    } else {
-        Symbol *symbol = lookup_symbol(global_table, node->FnCall.fn_name);
-        const char *fn_name = node->FnCall.fn_name;
-        if (!symbol) {
-            for (size_t j = 0; j < sizeof(built_in_functions) / sizeof(built_in_functions[0]); j++) {
-                if (strcmp(fn_name, built_in_functions[j].name) == 0 && built_in_functions[j].is_nullable) {
-
-                    // When we couldnt find function in global table, it has to be built-in so we iterate over built-in
-                    // functions and if we find match with name and nullability of the return type we set the nullability flag
-                    is_nullable = true;
-                }
-            }
-        } else {
-
-            // Function found and nullability retrieved from the symbol can be of false or true
-            is_nullable = symbol->func.is_nullable;
+    size_t built_in_count = sizeof(built_in_functions) / sizeof(built_in_functions[0]);
+    for (size_t i = 0; i < built_in_count; i++) {
+        if (strcmp(fn_name, built_in_functions[i].name) == 0) {
+            return built_in_functions[i].is_nullable;
         }
     }
-
-    return is_nullable;
+    return false;
 }
 
 bool is_literal(ASTNode *operation_element) {
@@ -234,21 +211,15 @@ bool is_literal(ASTNode *operation_element) {
     return operation_element->type == AST_INT || operation_element->type == AST_FLOAT;
 }
 
-DataType evaluate_operator_type(ASTNode *node, SymbolTable *global_table, ScopeStack *local_stack, Frame *local_frame) {
+DataType evaluate_operator_type(ASTNode *node, SymbolTable *global_table, ScopeStack *local_stack) {
 
-    bool left_is_nullable = false;
-    bool right_is_nullable = false;
-
-    // Evaluate the left and right operand types
-    DataType left_type = evaluate_expression_type(node->BinaryOperator.left, global_table, local_stack, local_frame);
-    if (node->BinaryOperator.left->type == AST_IDENTIFIER || node->BinaryOperator.left->type == AST_FN_CALL) {
-        left_is_nullable = evaluate_nullable_operand(global_table, node->BinaryOperator.left, local_stack, local_frame);
-    }
+    // Evaluate the left and right operand types, their nullability is recorded on the operands
+    DataType left_type = evaluate_expression_type(node->BinaryOperator.left, global_table, local_stack);
+    DataType right_type = evaluate_expression_type(node->BinaryOperator.right, global_table, local_stack);
 
-    DataType right_type = evaluate_expression_type(node->BinaryOperator.right, global_table, local_stack, local_frame);
-    if (node->BinaryOperator.right->type == AST_IDENTIFIER || node->BinaryOperator.right->type == AST_FN_CALL) {
-        right_is_nullable = evaluate_nullable_operand(global_table, node->BinaryOperator.right, local_stack, local_frame);
-    }
+    // Only identifiers and function calls can be nullable operands (null literal is checked by its type)
+    bool left_is_nullable = node->BinaryOperator.left->type != AST_NULL && node->BinaryOperator.left->expr.nullable;
+    bool right_is_nullable = node->BinaryOperator.right->type != AST_NULL && node->BinaryOperator.right->expr.nullable;
 
     // Determine the operator type
     OperatorType operator = node->BinaryOperator.operator;
@@ -281,8 +252,8 @@ DataType evaluate_operator_type(ASTNode *node, SymbolTable *global_table, ScopeS
 
                     ASTNode *bin_operator_with_binary_operation = node->BinaryOperator.left->type == AST_BIN_OP ?  
                                                                   node->BinaryOperator.left : node->BinaryOperator.right;
-                    DataType bin_operation_type = evaluate_operator_type(bin_operator_with_binary_operation, 
-                                                                        global_table, local_stack, local_frame);
+                    DataType bin_operation_type = evaluate_expression_type(bin_operator_with_binary_operation, 
+                                                                          global_table, local_stack);
                     return bin_operation_type;
 
                 } else {
@@ -327,11 +298,11 @@ DataType evaluate_operator_type(ASTNode *node, SymbolTable *global_table, ScopeS
 
             } else if (left_type == AST_BIN_OP) {
                 // Evaluate left operand recursively
-                return evaluate_operator_type(node->BinaryOperator.left, global_table, local_stack, local_frame);
+                return evaluate_expression_type(node->BinaryOperator.left, global_table, local_stack);
 
             } else if (right_type == AST_BIN_OP) {
                 // Evaluate right operand recursively
-                return evaluate_operator_type(node->BinaryOperator.right, global_table, local_stack, local_frame);
+                return evaluate_expression_type(node->BinaryOperator.right, global_table, local_stack);
 
             } else {
                 // If no cases matched, it's a semantic error
@@ -369,7 +340,7 @@ DataType evaluate_operator_type(ASTNode *node, SymbolTable *global_table, ScopeS
     }
 }
 
-DataType evaluate_expression_type(ASTNode *node, SymbolTable *global_table, ScopeStack *local_stack, Frame *local_frame) {
+DataType evaluate_expression_type(ASTNode *node, SymbolTable *global_table, ScopeStack *local_stack) {
 
     switch (node->type) {
         case AST_INT: {
@@ -382,7 +353,12 @@ DataType evaluate_expression_type(ASTNode *node, SymbolTable *global_table, Scop
             return AST_SLICE;
 
         } case AST_IDENTIFIER: { 
-            Symbol *symbol = lookup_symbol_in_scope(local_stack, node->Identifier.identifier, local_frame);
+            // Type of an expression is computed only once, later it is read from the node
+            if (node->expr.evaluated) {
+                return node->expr.data_type;
+            }
+
+            Symbol *symbol = local_symbol(local_stack, node->Identifier.symbol);
             
             if (!symbol) {
                 // When variable has been used but wasnt declared, it results in undefined error
@@ -394,10 +370,21 @@ DataType evaluate_expression_type(ASTNode *node, SymbolTable *global_table, Scop
                 symbol->var.used = true;
             }
             
+            // Only constants initialized by a literal have value known at compile time
+            node->expr = (ExpressionInfo){.data_type = symbol->var.type, .nullable = symbol->var.is_nullable,
+                                          .constant = symbol->var.is_constant && symbol->var.has_literal, .evaluated = true};
             return symbol->var.type;
 
         } case AST_BIN_OP: {
-            return evaluate_operator_type(node, global_table, local_stack, local_frame);
+            if (node->expr.evaluated) {
+                return node->expr.data_type;
+            }
+
+            // Operands are evaluated first, result is constant only if both of them are
+            DataType operator_type = evaluate_operator_type(node, global_table, local_stack);
+            bool is_constant = node->BinaryOperator.left->expr.constant && node->BinaryOperator.right->expr.constant;
+            node->expr = (ExpressionInfo){.data_type = operator_type, .nullable = false, .constant = is_constant, .evaluated = true};
+            return operator_type;
 
         } case AST_ARG: {
 
@@ -407,9 +394,13 @@ DataType evaluate_expression_type(ASTNode *node, SymbolTable *global_table, Scop
 
             // Recursively evaluate expression
             // We perform this because every node in this case can be a child node of AST_ARG_NODE
-            return evaluate_expression_type(node->Argument.expression, global_table, local_stack, local_frame);
+            return evaluate_expression_type(node->Argument.expression, global_table, local_stack);
 
         } case AST_FN_CALL: {
+            if (node->expr.evaluated) {
+                return node->expr.data_type;
+            }
+
             const char *fn_name = node->FnCall.fn_name;
     
             // Lookup the function symbol
@@ -422,10 +413,12 @@ DataType evaluate_expression_type(ASTNode *node, SymbolTable *global_table, Scop
             if (!fn_symbol) {
                 // Function not found, has to be built-in one
                 DataType built_in_fn_data_type = deduce_builtin_function_type(fn_name);
+                node->expr = (ExpressionInfo){.data_type = built_in_fn_data_type, .nullable = builtin_is_nullable(fn_name), .evaluated = true};
                 return built_in_fn_data_type;
 
             } else {
                 // Function found, retrieve type from the symbol table                
+                node->expr = (ExpressionInfo){.data_type = fn_symbol->func.type, .nullable = fn_symbol->func.is_nullable, .evaluated = true};
                 return fn_symbol->func.type;
             }
 
@@ -483,7 +476,7 @@ void check_type_compatibility(DataType data_type_declared, DataType data_type_st
 
 void populate_global_table_with_functions(ASTNode *root, SymbolTable *global_table) {
     for (int i = 0; i < root->Program.decl_count; i++) {
-        ASTNode *decl = root->Program.declarations[i];
+        ASTNode *decl = ast_child(root->Program.declarations, i);
         if (decl->type == AST_FN_DECL) {
             const char *name = decl->FnDecl.fn_name;
             DataType function_type = decl->FnDecl.return_type;
@@ -510,12 +503,12 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
             populate_global_table_with_functions(node, global_table);
 
             for (int i = 0; i < node->Program.decl_count; i++) {
-                ASTNode *decl = node->Program.declarations[i];
+                ASTNode *decl = ast_child(node->Program.declarations, i);
                 Symbol *symbol = lookup_symbol(global_table, decl->FnDecl.fn_name);
 
                 if (!symbol->func.is_initialized) {
                     // Performing semantic analysis on function declarations
-                    semantic_analysis(node->Program.declarations[i], global_table, local_stack);
+                    semantic_analysis(ast_child(node->Program.declarations, i), global_table, local_stack);
                 }
             }
 
@@ -539,19 +532,27 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
             bool func_is_nullable = node->FnDecl.nullable;
             DataType return_type = node->FnDecl.return_type;
 
-            // Retrieve the function symbol to access its scope stack
+            // Retrieve the function symbol
             Symbol *fn_symbol = lookup_symbol(global_table, fn_name);
-            ScopeStack *function_stack = fn_symbol->func.scope_stack;
+
+            // Function can be analyzed from a call in another function, symbols of the caller are kept aside
+            Symbol *caller_symbols = local_stack->symbols;
+            Symbol *caller_function = local_stack->function;
+            local_stack->symbols = malloc((node->FnDecl.local_count + 1) * sizeof(Symbol));
+            if (!local_stack->symbols) {
+                exit(INTERNAL_ERROR);
+            }
+            local_stack->function = fn_symbol;
 
             // Push a frame for the function parameters
-            push_frame(function_stack);
+            push_frame(local_stack);
 
             // Process function parameters
             for (int i = 0; i < node->FnDecl.param_count; i++) {
-                semantic_analysis(node->FnDecl.params[i], global_table, function_stack);
+                semantic_analysis(ast_child(node->FnDecl.params, i), global_table, local_stack);
             }
 
-            // When the declared function is nullable, we assign it a true flag in appropriate entry of fn_symbol in fn_scope_stack
+            // When the declared function is nullable, we assign it a true flag in fn_symbol
             if (func_is_nullable) {
                 fn_symbol->func.is_nullable = true;
             }
@@ -560,11 +561,11 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
             fn_symbol->func.is_initialized = true;
 
             // Push a new frame for the function body
-            push_frame(function_stack);
+            push_frame(local_stack);
 
             // Recursively analyze the function block
             if (node->FnDecl.block) {
-                semantic_analysis(node->FnDecl.block, global_table, function_stack);
+                semantic_analysis(node->FnDecl.block, global_table, local_stack);
             }
 
             // Ensure non-void functions have a return statement
@@ -574,8 +575,12 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
                 }
             }
 
-            // Cleanup the function's scope stack (pop all frames)
-            pop_frame(function_stack);
+            // Pop the body and parameter frames, calls are checked against parameters in the AST
+            pop_frame(local_stack);
+            pop_frame(local_stack);
+            free(local_stack->symbols);
+            local_stack->symbols = caller_symbols;
+            local_stack->function = caller_function;
             break;
         }
     
@@ -589,16 +594,13 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
                 exit(SEMANTIC_ERROR_PARAMS);
             }
 
-            Frame *frame = top_frame(local_stack);
-            Symbol *existing_symbol = lookup_symbol_in_scope(local_stack, param_name, frame);
-
             // Check for already defined parameter
-            if (existing_symbol) {
+            if (node->Param.redeclared) {
                 fprintf(stderr, "Semantic Error: Duplicate parameter name.\n");
                 exit(SEMANTIC_ERROR_REDEF);
 
             } else {
-                add_variable_symbol(local_stack->frames[local_stack->top]->symbol_table, param_name, param_type, true, node->Param.nullable, false, 0);
+                add_scope_variable(local_stack, node->Param.symbol, param_name, param_type, true, node->Param.nullable, false, 0);
             }
             break;
         }
@@ -607,19 +609,11 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
         case AST_BLOCK: {
             // Push a new frame to the local stack for the block
             push_frame(local_stack);
-            Symbol *enclosing_function;
-
-            // Iterate through the global symbol table to find the matching function
-            for (int i = 0; i < global_table->capacity; i++) {
-                Symbol *symbol = global_table->symbols[i];
-                if (symbol && symbol->type == SYMBOL_FUNC && symbol->func.scope_stack == local_stack) {
-                    enclosing_function = symbol;
-                }
-            }
+            Symbol *enclosing_function = local_stack->function;
 
             // Traverse all nodes within the block
             for (int i = 0; i < node->Block.node_count; i++) {
-                ASTNode *child_node = node->Block.nodes[i];
+                ASTNode *child_node = ast_child(node->Block.nodes, i);
 
                 // Perform semantic analysis on each child node
                 semantic_analysis(child_node, global_table, local_stack);
@@ -664,25 +658,17 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
                 }
             }
             
-            // Check for unused variables in the current frame
-            Frame *current_frame = top_frame(local_stack);
-            
-            if (current_frame && current_frame->symbol_table) {
-
-                // Get the current table
-                SymbolTable *current_table = current_frame->symbol_table;
-
-                for (int j = 0; j < current_table->capacity; j++) {
-                    Symbol *symbol = current_table->symbols[j];
+            // Check for unused variables in the current frame (bindings declared since the frame was pushed)
+            for (int j = top_frame(local_stack); j < local_stack->declared_count; j++) {
+                Symbol *symbol = declared_symbol(local_stack, j);
 
-                    // When found symbol that doesnt have flag .used == true => SEMANTIC_ERROR_UNUSED_VAR
-                    if (symbol && symbol->type == SYMBOL_VAR && !symbol->var.used) {
-                        exit(SEMANTIC_ERROR_UNUSED_VAR);
+                // When found symbol that doesnt have flag .used == true => SEMANTIC_ERROR_UNUSED_VAR
+                if (symbol->type == SYMBOL_VAR && !symbol->var.used) {
+                    exit(SEMANTIC_ERROR_UNUSED_VAR);
 
-                    // When found symbol that doesnt have flag .used == true => SEMANTIC_ERROR_UNUSED_VAR
-                    } else if (symbol && symbol->type == SYMBOL_VAR && !symbol->var.is_constant  && !symbol->var.redefined) {
-                        exit(SEMANTIC_ERROR_UNUSED_VAR);
-                    }
+                // When found symbol that doesnt have flag .used == true => SEMANTIC_ERROR_UNUSED_VAR
+                } else if (symbol->type == SYMBOL_VAR && !symbol->var.is_constant  && !symbol->var.redefined) {
+                    exit(SEMANTIC_ERROR_UNUSED_VAR);
                 }
             }
 
@@ -697,7 +683,6 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
             
             // Push a frame for the block
             push_frame(local_stack);
-            Frame *current_frame = top_frame(local_stack);
 
             // Handle condition expression differently for `while` and `if-else`
             ASTNode *condition_expression = (node->type == AST_WHILE) ? node->WhileCycle.expression : node->IfElse.expression;
@@ -706,14 +691,14 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
             // Evaluate the condition expression
             if (condition_expression) {
 
-                DataType condition_type = evaluate_expression_type(condition_expression, global_table, local_stack, current_frame);
+                DataType condition_type = evaluate_expression_type(condition_expression, global_table, local_stack);
 
                 if (bind_name) {
                     Symbol *symbol = NULL;
                     bool has_literal = false;
 
                     if (condition_expression->type == AST_IDENTIFIER) {
-                        symbol = lookup_symbol_in_scope(local_stack, condition_expression->Identifier.identifier, current_frame);
+                        symbol = local_symbol(local_stack, condition_expression->Identifier.symbol);
                         has_literal = symbol->var.has_literal ? true : false;
 
                         // Ensures the condition is a boolean-compatible type
@@ -722,7 +707,8 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
                         }
                     }
                     
-                    process_binding(condition_expression, global_table, local_stack, current_frame, bind_name, condition_type, has_literal);
+                    int bind_symbol = (node->type == AST_WHILE) ? node->WhileCycle.bind_symbol : node->IfElse.bind_symbol;
+                    process_binding(condition_expression, global_table, local_stack, bind_name, bind_symbol, condition_type, has_literal);
 
                 } else {
                     // Perform semantic analysis on the condition if no binding
@@ -768,7 +754,6 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
 
         case AST_FN_CALL: {
             const char *fn_name = node->FnCall.fn_name;
-            Frame *current_frame = top_frame(local_stack);
 
             // Check if the function is built-in
             bool is_builtin = false;
@@ -792,7 +777,7 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
                 // Validate argument types for built-in functions
                 for (int i = 0; i < node->FnCall.arg_count; i++) {
 
-                    DataType arg_type = evaluate_expression_type(node->FnCall.args[i], global_table, local_stack, current_frame);
+                    DataType arg_type = evaluate_expression_type(ast_child(node->FnCall.args, i), global_table, local_stack);
 
                     if (builtin_func->param_count != -1 && arg_type != builtin_func->expected_arg_types[i]) {
                         exit(SEMANTIC_ERROR_TYPE_COMPAT);
@@ -819,24 +804,9 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
                     fn_symbol->func.is_initialized = true;
                 }
 
-                // Check argument count for user-defined functions
-                ScopeStack *fn_scope_stack = fn_symbol->func.scope_stack;
-
-                // Perform check for initialization
-                if (!fn_scope_stack || fn_scope_stack->top < 0) {
-                    exit(INTERNAL_ERROR);
-                }
-
-                // Function parameters are in the first frame
-                Frame *fn_frame_args = fn_scope_stack->frames[0];
-                
-                // If arguments not present in symbol table check
-                if (!fn_frame_args || !fn_frame_args->symbol_table) {
-                    exit(INTERNAL_ERROR);
-                }
-
-                SymbolTable *param_table = fn_frame_args->symbol_table;
-                int expected_arg_count = param_table->count;
+                // Check argument count for user-defined functions, parameters were validated when the function was analyzed
+                ASTNode *fn_decl = fn_symbol->func.fn_node;
+                int expected_arg_count = fn_decl->FnDecl.param_count;
                 
                 // Check if declared argument count corresponds to the expected argument cound
                 if (node->FnCall.arg_count != expected_arg_count) {
@@ -845,40 +815,15 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
 
                 for (int i = 0; i < node->FnCall.arg_count; i++) {
                     
-                    ASTNode *arg = node->FnCall.args[i];
-                    DataType arg_type = evaluate_expression_type(arg, global_table, local_stack, current_frame);
+                    ASTNode *arg = ast_child(node->FnCall.args, i);
+                    DataType arg_type = evaluate_expression_type(arg, global_table, local_stack);
                     
 
-                    // Locate the corresponding parameter in the hash table
-                    Symbol *param_symbol = NULL;
-                    int param_index = 0; // Logical parameter index
-
-                    for (int j = param_index; j < param_table->capacity; j++) {
-                        Symbol *current_symbol = param_table->symbols[j];
-
-                        // Skip NULL entries and non-parameter symbols
-                        if (!current_symbol || current_symbol->type != SYMBOL_VAR) {
-                            continue;
-                        }
-
-                        // Match the logical parameter index with the current argument index
-                        if (param_index == i) {
-                            param_symbol = current_symbol;
-                            break;
-                        }
-
-                        // Increment logical parameter index
-                        param_index++;
-                    }
-
-                    // Ensure the parameter symbol is found
-                    if (!param_symbol) {
-                        
-                        exit(INTERNAL_ERROR);
-                    }
+                    // Parameters are matched in declaration order
+                    ASTNode *param = ast_child(fn_decl->FnDecl.params, i);
 
                     // Check type compatibility
-                    if (param_symbol->var.type != arg_type) {
+                    if (param->Param.data_type != arg_type) {
                         exit(SEMANTIC_ERROR_PARAMS);
                     }
                 }
@@ -890,14 +835,13 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
         }
 
         case AST_ARG: {
-            Frame *current_frame = top_frame(local_stack);
 
             if (!node->Argument.expression) {
                 exit(SEMANTIC_ERROR_UNDEFINED);
             }
 
             // Evaluate the type of the expression
-            DataType arg_type = evaluate_expression_type(node->Argument.expression, global_table, local_stack, current_frame);
+            DataType arg_type = evaluate_expression_type(node->Argument.expression, global_table, local_stack);
             
             // Ensure the expression is valid (further checks can be added here if needed)
             if (arg_type == AST_UNSPECIFIED) {
@@ -908,26 +852,13 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
         }
 
         case AST_RETURN: {
-            // Ensure the function context is valid (local stack must not be NULL)
-            if (local_stack == NULL || local_stack->top == -1) {
+            // Ensure the function context is valid (return has to be inside of a function)
+            if (local_stack == NULL || local_stack->function == NULL) {
                 exit(SEMANTIC_ERROR_RETURN);
             }
 
-            // Retrieve the first frame in the local stack (function scope)
-            Frame *current_frame = local_stack->frames[0];
-            if (!current_frame || !current_frame->symbol_table) {
-                exit(INTERNAL_ERROR);
-            }
-
-            // Find the function name directly from the global symbol table
-            Symbol *function_symbol = NULL;
-            for (int i = 0; i < global_table->capacity; i++) {
-                Symbol *symbol = global_table->symbols[i];
-                if (symbol && symbol->type == SYMBOL_FUNC && symbol->func.scope_stack == local_stack) {
-                    function_symbol = symbol;
-                    break;
-                }
-            }
+            // Function that is being analyzed
+            Symbol *function_symbol = local_stack->function;
 
             DataType expected_return_type = function_symbol->func.type;
 
@@ -937,7 +868,7 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
                 if (node->Return.expression) {
 
                     // Evaluate the type of the return expression
-                    DataType return_type = evaluate_expression_type(node->Return.expression, global_table, local_stack, current_frame);
+                    DataType return_type = evaluate_expression_type(node->Return.expression, global_table, local_stack);
                     
 
                     // Check if the return type matches the expected return type and that main is of type void
@@ -967,6 +898,8 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
                 global_table,
                 local_stack,
                 node->VarDecl.var_name,
+                node->VarDecl.symbol,
+                node->VarDecl.redeclared,
                 node->VarDecl.data_type,
                 node->VarDecl.expression,
                 false, // is_constant
@@ -981,6 +914,8 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
                 global_table,
                 local_stack,
                 node->ConstDecl.const_name,
+                node->ConstDecl.symbol,
+                node->ConstDecl.redeclared,
                 node->ConstDecl.data_type,
                 node->ConstDecl.expression,
                 true, // is_constant
@@ -1007,9 +942,8 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
         }
 
         case AST_IDENTIFIER: {
-            Frame *current_frame = top_frame(local_stack);
             // Look up the identifier in the current scope stack or global table.
-            Symbol *symbol = lookup_symbol_in_scope(local_stack, node->Identifier.identifier, current_frame);
+            Symbol *symbol = local_symbol(local_stack, node->Identifier.symbol);
 
             if (!symbol) {
                 // If the identifier is not found, it's an undeclared variable.
@@ -1031,18 +965,17 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
         }
 
         case AST_ASSIGNMENT: {
-            Frame *current_frame = top_frame(local_stack);
             const char *identifier = node->Assignment.identifier;
             DataType expression_type = 0;
 
             // We call expression type even though it is of discard type assignment to flag usage of variables and correct usage of binary operands
             if (strcmp(identifier, "_") == 0) {
-                expression_type = evaluate_expression_type(node->Assignment.expression, global_table, local_stack, current_frame);
+                expression_type = evaluate_expression_type(node->Assignment.expression, global_table, local_stack);
                 break;
             }
 
             // Lookup the identifier in the symbol table (local or global)
-            Symbol *symbol = lookup_symbol_in_scope(local_stack, identifier, current_frame);
+            Symbol *symbol = local_symbol(local_stack, node->Assignment.symbol);
             
             if (!symbol) {
                 // If the variable/constant is not declared, raise an error
@@ -1065,7 +998,7 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
             }
 
             // Evaluate the expression type for the right side of the assignment
-            expression_type = evaluate_expression_type(node->Assignment.expression, global_table, local_stack, current_frame);
+            expression_type = evaluate_expression_type(node->Assignment.expression, global_table, local_stack);
 
             bool expression_is_literal = false;
 
@@ -1074,6 +1007,9 @@ void semantic_analysis(ASTNode *node, SymbolTable *global_table, ScopeStack *loc
             }
 
             check_type_compatibility(symbol->var.type, expression_type, symbol->var.is_nullable, symbol->var.value, expression_is_literal);
+
+            // Type of the variable is recorded for code generation (implicit conversion of literals)
+            node->Assignment.data_type = symbol->var.type;
             break;
         }
 
@@ -1120,6 +1056,8 @@ void process_declaration(
     SymbolTable *global_table,
     ScopeStack *local_stack,
     const char *name,
+    int symbol,
+    bool redeclared,
     DataType data_type_declared,
     ASTNode *expression,
     bool is_constant,
@@ -1132,15 +1070,8 @@ void process_declaration(
         return;
     }
 
-    // Determine the current frame
-    Frame *current_frame = NULL;
-    if (local_stack && local_stack->top >= 0) {
-        current_frame = top_frame(local_stack);
-    }
-
     // Check if already declared
-    Symbol *existing_symbol = lookup_symbol_in_scope(local_stack, name, current_frame);
-    if (existing_symbol) {
+    if (redeclared) {
         exit(SEMANTIC_ERROR_REDEF);
     }
 
@@ -1162,7 +1093,7 @@ void process_declaration(
     }
 
     // Deduce data type
-    DataType data_type_stored = evaluate_expression_type(expression, global_table, local_stack, current_frame);
+    DataType data_type_stored = evaluate_expression_type(expression, global_table, local_stack);
     
     // Data type wasnt specified in decleration
     if (data_type_declared == AST_UNSPECIFIED) {
@@ -1177,16 +1108,12 @@ void process_declaration(
     // Perform type compatibility check
     check_type_compatibility(data_type_declared, data_type_stored, is_nullable, value, has_literal);
 
-    // Add the variable/constant to the appropriate symbol table
+    // Add the variable/constant to the top frame
     if (local_stack && local_stack->top >= 0) {
-        if (current_frame && current_frame->symbol_table) {
             
-            // We store the declaration unless it is discard token
-            if (!(strcmp(name, "_") == 0)) {
-                add_variable_symbol(current_frame->symbol_table, name, data_type_declared, is_constant, is_nullable, has_literal, value);
-            }
-        } else {
-            exit(INTERNAL_ERROR);
+        // We store the declaration unless it is discard token
+        if (!(strcmp(name, "_") == 0)) {
+            add_scope_variable(local_stack, symbol, name, data_type_declared, is_constant, is_nullable, has_literal, value);
         }
     }
 }
@@ -0,0 +1,120 @@
+/**
+ * @file source.c
+ * @brief Contains definitions of functions declared in source.h
+ * @authors Michal Repcik (xrepcim00)
+*/
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "source.h"
+
+#define READ_CHUNK (1 << 20) // Initial size of the buffer for non mappable input
+
+// Maps regular file into memory, returns -1 if the file can not be mapped
+static int map_source(SourceBuffer* src, FILE* fp) {
+    struct stat st;
+    int fd = fileno(fp);
+    if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return -1;
+    }
+
+    off_t offset = ftello(fp); // Respect anything already consumed from fp
+    if (offset < 0 || offset > st.st_size) {
+        return -1;
+    }
+
+    if (st.st_size == 0) { // Nothing to map, empty source
+        src->data = NULL;
+        src->len = 0;
+        return 0;
+    }
+
+    void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+    posix_madvise(map, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+
+    src->map = map;
+    src->map_len = (size_t)st.st_size;
+    src->data = (const unsigned char*)map;
+    src->len = (size_t)st.st_size;
+    src->pos = (size_t)offset;
+    return 0;
+}
+
+// Reads whole stream into heap buffer, doubling it whenever it gets full
+static int read_source(SourceBuffer* src, FILE* fp) {
+    size_t cap = READ_CHUNK;
+    size_t len = 0;
+    unsigned char* data = malloc(cap);
+    if (data == NULL) {
+        return -1;
+    }
+
+    size_t n;
+    while ((n = fread(data + len, 1, cap - len, fp)) > 0) {
+        len += n;
+        if (len == cap) {
+            cap *= 2;
+            unsigned char* tmp = realloc(data, cap);
+            if (tmp == NULL) {
+                free(data);
+                return -1;
+            }
+            data = tmp;
+        }
+    }
+
+    if (ferror(fp)) {
+        free(data);
+        return -1;
+    }
+
+    src->data = data;
+    src->len = len;
+    return 0;
+}
+
+int init_source(SourceBuffer* src, FILE* fp) {
+    if (src == NULL || fp == NULL) {
+        return -1;
+    }
+
+    src->data = NULL;
+    src->len = 0;
+    src->pos = 0;
+    src->map = NULL;
+    src->map_len = 0;
+    src->fp = fp;
+
+    if (map_source(src, fp) == 0) {
+        return 0;
+    }
+    return read_source(src, fp);
+}
+
+void destroy_source(SourceBuffer* src) {
+    if (src == NULL) {
+        return;
+    }
+
+    if (src->map != NULL) {
+        munmap(src->map, src->map_len);
+    }
+    else if (src->data != NULL) {
+        free((void*)src->data);
+    }
+    src->map = NULL;
+    src->data = NULL;
+    src->len = 0;
+    src->pos = 0;
+
+    if (src->fp != NULL) {
+        fclose(src->fp);
+        src->fp = NULL;
+    }
+}
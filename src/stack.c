@@ -14,77 +14,64 @@
 #define INITIAL_STACK_CAPACITY 10
 
 /**
- * @brief Resizes the ScopeStack by doubling its capacity.
+ * @brief Initializes a new empty ScopeStack.
  *
- * @param scopeStack Pointer to the ScopeStack to resize.
- */
-void resize_scope_stack(ScopeStack *scopeStack) {
-    scopeStack->capacity *= 2;
-    scopeStack->frames = realloc(scopeStack->frames, scopeStack->capacity * sizeof(Frame *));
-}
-
-/**
- * @brief Initializes a new ScopeStack for managing frames within a function.
- *
- * @return Pointer to the initialized ScopeStack, or NULL if memory allocation fails.
+ * @return Pointer to the initialized ScopeStack.
  */
 ScopeStack *init_scope_stack() {
     ScopeStack *stack = malloc(sizeof(ScopeStack));
     if (!stack) {
         exit(INTERNAL_ERROR);
     }
+    stack->symbols = NULL;
+    stack->declared_count = 0;
+    stack->declared_capacity = INITIAL_STACK_CAPACITY;
+    stack->declared = malloc(sizeof(int) * stack->declared_capacity);
     stack->top = -1; // Initialize stack as empty
     stack->capacity = INITIAL_STACK_CAPACITY; // Ensure capacity is set
-    stack->frames = malloc(sizeof(Frame *) * stack->capacity);
-    if (!stack->frames) {
+    stack->scopes = malloc(sizeof(int) * stack->capacity);
+    if (!stack->scopes || !stack->declared) {
         exit(INTERNAL_ERROR);
     }
+    stack->function = NULL;
     return stack;
 }
 
 /**
- * @brief Looks up a symbol in the local stack, global table, or provided frame.
+ * @brief Declares a variable in the top scope.
  *
- * This function searches for a symbol starting from the specified local frame,
- * falling back to the local stack, and then the global table if not found.
- *
- * @param local_stack Pointer to the local scope stack.
- * @param name Name of the symbol to look for.
- * @param local_frame Pointer to a specific local frame to search first, or NULL to skip.
- * @return Pointer to the found symbol or NULL if not found.
+ * @param stack Pointer to the scope stack.
+ * @param symbol Local symbol id of the declaration.
+ * @param name Interned name of the variable.
+ * @param type The data type of the variable.
+ * @param is_constant Whether the variable is a constant.
+ * @param is_nullable Whether the variable can hold null.
+ * @param has_literal Whether the variable has a literal value.
+ * @param value The initial value of the variable.
  */
-Symbol *lookup_symbol_in_scope(ScopeStack *local_stack, const char *name, Frame *local_frame) {
-
-    // 1. Check if local_frame is explicitly provided
-    if (local_frame) {
-        Symbol *symbol = lookup_symbol(local_frame->symbol_table, name);
-        if (symbol) {
-            return symbol;
-        }
+void add_scope_variable(ScopeStack *stack, int symbol, const char *name, DataType type, bool is_constant, bool is_nullable, bool has_literal, double value) {
+    if (stack->top < 0 || symbol < 0) {
+        exit(INTERNAL_ERROR);
     }
-
-    // 2. If local_stack exists, search from top to bottom
-    if (local_stack) {
-        for (int i = local_stack->top; i >= 0; i--) {
-            Frame *frame = local_stack->frames[i];
-
-            Symbol *symbol = lookup_symbol(frame->symbol_table, name);
-            if (symbol) {
-                return symbol;
-            }
+    if (stack->declared_count >= stack->declared_capacity) {
+        stack->declared_capacity *= 2;
+        stack->declared = realloc(stack->declared, sizeof(int) * stack->declared_capacity);
+        if (!stack->declared) {
+            exit(INTERNAL_ERROR);
         }
     }
+    stack->declared[stack->declared_count++] = symbol;
 
-    // 3. Symbol not found
-    return NULL;
+    Symbol *entry = &stack->symbols[symbol];
+    entry->type = SYMBOL_VAR;
+    entry->var = (VarSymbol){.name = name, .type = type, .is_constant = is_constant, .used = false, .is_nullable = is_nullable,
+                             .redefined = false, .has_literal = has_literal, .value = value};
 }
 
 /**
- * @brief Pushes a new frame onto the ScopeStack, resizing if needed.
- *
- * Allocates memory for a new frame and its symbol table, pushing it onto the stack.
+ * @brief Opens a new scope on top of the ScopeStack, resizing if needed.
  *
- * @param stack Pointer to the ScopeStack where the frame will be pushed.
+ * @param stack Pointer to the ScopeStack where the scope will be pushed.
  */
 void push_frame(ScopeStack *stack) {
     if (!stack) {
@@ -92,98 +79,47 @@ void push_frame(ScopeStack *stack) {
     }
     if (stack->top + 1 >= stack->capacity) {
         stack->capacity *= 2;
-        stack->frames = realloc(stack->frames, sizeof(Frame *) * stack->capacity);
-        if (!stack->frames) {
+        stack->scopes = realloc(stack->scopes, sizeof(int) * stack->capacity);
+        if (!stack->scopes) {
             exit(INTERNAL_ERROR);
         }
     }
-    stack->top++;
-    stack->frames[stack->top] = malloc(sizeof(Frame));
-    if (!stack->frames[stack->top]) {
-        exit(INTERNAL_ERROR);
-    }
-    stack->frames[stack->top]->symbol_table = init_symbol_table();
+    stack->scopes[++stack->top] = stack->declared_count;
 }
 
 /**
- * @brief Removes the top frame from the ScopeStack.
+ * @brief Closes the top scope of the ScopeStack.
  *
- * Frees the memory associated with the top frame and removes it from the stack.
- *
- * @param scope_stack Pointer to the ScopeStack to pop from.
+ * @param stack Pointer to the ScopeStack to pop from.
  */
-void pop_frame(ScopeStack *scope_stack) {
-    if (scope_stack->top >= 0) {
-        free(scope_stack->frames[scope_stack->top--]);
+void pop_frame(ScopeStack *stack) {
+    if (stack->top >= 0) {
+        stack->declared_count = stack->scopes[stack->top--];
     }
 }
 
 /**
- * @brief Retrieves the top frame of the ScopeStack without removing it.
+ * @brief Returns index into `declared` of the first symbol of the top scope.
  *
- * @param scope_stack Pointer to the ScopeStack.
- * @return Pointer to the top Frame, or NULL if the stack is empty.
+ * @param stack Pointer to the ScopeStack.
+ * @return Index of the first symbol, `declared_count` if no scope is open.
  */
-Frame *top_frame(ScopeStack *scope_stack) {
-    if (scope_stack->top >= 0) {
-        return scope_stack->frames[scope_stack->top];
+int top_frame(ScopeStack *stack) {
+    if (stack->top >= 0) {
+        return stack->scopes[stack->top];
     }
-    return NULL;
-}
-
-/**
- * @brief Frees the memory associated with a single frame.
- *
- * Cleans up the symbol table and the frame structure itself.
- *
- * @param frame Pointer to the Frame to be freed.
- */
-void free_frame(Frame *frame) {
-    if (!frame) return;
-
-    // Free the symbol table within the frame
-    if (frame->symbol_table) {
-        free_symbol_table(frame->symbol_table);
-    }
-
-    // Free the frame itself
-    free(frame);
+    return stack->declared_count;
 }
 
 /**
  * @brief Frees the memory associated with a ScopeStack.
  *
- * Cleans up all frames within the stack and then the stack structure itself.
- *
  * @param stack Pointer to the ScopeStack to be freed.
  */
 void free_scope_stack(ScopeStack *stack) {
     if (!stack) return;
 
-    // Free each frame in the stack
-    for (int i = 0; i <= stack->top; i++) {
-        free_frame(stack->frames[i]);
-    }
-
-    // Free the frames array
-    free(stack->frames);
-
-    // Free the stack itself
+    free(stack->declared);
+    free(stack->scopes);
     free(stack);
 }
-
-/**
- * @brief Initializes a Frame with a new symbol table.
- *
- * Allocates memory for the frame and its associated symbol table.
- *
- * @return Pointer to the initialized Frame, or NULL if memory allocation fails.
- */
-Frame *init_frame() {
-    Frame *frame = malloc(sizeof(Frame));
-    if (frame) {
-        frame->symbol_table = init_symbol_table();
-    }
-    return frame;
-}
-
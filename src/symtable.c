@@ -10,38 +10,30 @@
 #include <stdio.h>
 #include <error.h>
 #include "symtable.h"
-#include "stack.h"
+#include "intern.h"
 
-#define INITIAL_CAPACITY 10 /**< Initial capacity of the symbol table. */
-#define LOAD_FACTOR 0.75 /**< Maximum load factor before resizing the table. */
+#define INITIAL_CAPACITY 8 /**< Initial capacity of the symbol table (power of two). */
 
-/**
- * @brief Hash function using the djb2 algorithm.
- * @param key The string key to hash.
- * @param capacity The current capacity of the hash table.
- * @return The computed hash value, modulo the table capacity.
- */
-static unsigned int hash(const char *key, int capacity) {
-    unsigned long hash = 5381;
-    int c;
-    while ((c = *key++)) {
-        hash = ((hash << 5) + hash) + c;
-    }
-    return hash % capacity;
-}
+const char symbol_tombstone = 0;
 
 /**
  * @brief Initializes an empty symbol table.
+ *
+ * Slots are allocated when the first symbol is added, most frames never get any.
+ *
  * @return Pointer to the initialized symbol table.
  */
 SymbolTable *init_symbol_table() {
     SymbolTable *table = malloc(sizeof(SymbolTable));
-    table->symbols = malloc(INITIAL_CAPACITY * sizeof(Symbol *));
-    for (int i = 0; i < INITIAL_CAPACITY; i++) {
-        table->symbols[i] = NULL;
+    if (!table) {
+        exit(INTERNAL_ERROR);
     }
+    table->names = NULL;
+    table->hashes = NULL;
+    table->symbols = NULL;
     table->count = 0;
-    table->capacity = INITIAL_CAPACITY;
+    table->used = 0;
+    table->capacity = 0;
     return table;
 }
 
@@ -54,20 +46,7 @@ void free_symbol_table(SymbolTable *table) {
         return;
     }
 
-    if (table->symbols != NULL) {
-        for (int i = 0; i < table->capacity; i++) {
-            if (table->symbols[i] != NULL) {
-                if (table->symbols[i]->type == SYMBOL_FUNC) {
-                    free(table->symbols[i]->func.name);
-                    free_scope_stack(table->symbols[i]->func.scope_stack);
-                } else if (table->symbols[i]->type == SYMBOL_VAR) {
-                    free(table->symbols[i]->var.name);
-                }
-                free(table->symbols[i]);
-            }
-        }
-        free(table->symbols);
-    }
+    free(table->symbols); // All slot arrays share one allocation
     free(table);
 }
 
@@ -76,76 +55,89 @@ void free_symbol_table(SymbolTable *table) {
  * @param table Pointer to the symbol table to resize.
  */
 void resize(SymbolTable *table) {
-    int old_capacity = table->capacity;
-    Symbol **old_symbols = table->symbols;
+    int capacity = table->capacity ? table->capacity : INITIAL_CAPACITY;
+    // Grow only when the table is really full, otherwise just drop tombstones
+    while ((table->count + 1) * 2 > capacity) {
+        capacity *= 2;
+    }
 
-    table->capacity *= 2;
-    table->symbols = malloc(table->capacity * sizeof(Symbol *));
-    for (int i = 0; i < table->capacity; i++) {
-        table->symbols[i] = NULL;
+    // Symbols, names and hashes in one allocation (in order of alignment)
+    Symbol *symbols = malloc(capacity * (sizeof(Symbol) + sizeof(const char *) + sizeof(uint32_t)));
+    if (!symbols) {
+        exit(INTERNAL_ERROR);
     }
-    table->count = 0;
+    const char **names = (const char **)(symbols + capacity);
+    uint32_t *hashes = (uint32_t *)(names + capacity);
+    memset(names, 0, capacity * sizeof(const char *));
 
-    for (int i = 0; i < old_capacity; i++) {
-        if (old_symbols[i] != NULL) {
-            Symbol *symbol = old_symbols[i];
-            unsigned int index = hash(
-                symbol->type == SYMBOL_FUNC ? symbol->func.name : symbol->var.name,
-                table->capacity
-            );
-            while (table->symbols[index] != NULL) {
-                index = (index + 1) % table->capacity;
+    unsigned int mask = capacity - 1;
+    for (int i = 0; i < table->capacity; i++) {
+        if (symbol_at(table, i)) {
+            unsigned int index = table->hashes[i] & mask;
+            while (names[index] != NULL) {
+                index = (index + 1) & mask;
             }
-            table->symbols[index] = symbol;
-            table->count++;
+            names[index] = table->names[i];
+            hashes[index] = table->hashes[i];
+            symbols[index] = table->symbols[i];
         }
     }
-    free(old_symbols);
+    free(table->symbols);
+    table->names = names;
+    table->hashes = hashes;
+    table->symbols = symbols;
+    table->capacity = capacity;
+    table->used = table->count;
 }
 
 /**
- * @brief Adds a function symbol to the symbol table.
+ * @brief Finds slot for a new symbol, resizes the table if needed.
  * @param table Pointer to the symbol table.
- * @param name The name of the function.
- * @param return_type The return type of the function.
- * @param is_initialized Whether the function is initialized.
- * @param fn_node Pointer to the function's AST node.
- * @param is_nullable Whether the function can return null.
+ * @param name Interned name of the new symbol (must not be in the table yet).
+ * @return Pointer to the symbol in the slot.
  */
-void add_function_symbol(SymbolTable *table, const char *name, DataType return_type, bool is_initialized, ASTNode *fn_node, bool is_nullable) {
-    if ((float)table->count / table->capacity >= LOAD_FACTOR) {
+static Symbol *insert_slot(SymbolTable *table, const char *name) {
+    // Keep at most 3/4 of slots used (including tombstones)
+    if ((table->used + 1) * 4 > table->capacity * 3) {
         resize(table);
     }
 
-    unsigned int index = hash(name, table->capacity);
-    while (table->symbols[index] != NULL) {
-        index = (index + 1) % table->capacity;
+    uint32_t hash = intern_hash(name);
+    unsigned int mask = table->capacity - 1;
+    unsigned int index = hash & mask;
+    while (table->names[index] != NULL && table->names[index] != SYMBOL_TOMBSTONE) {
+        index = (index + 1) & mask;
     }
 
-    FuncSymbol *func = malloc(sizeof(FuncSymbol));
-    if (!func) {
-        exit(INTERNAL_ERROR);
+    if (table->names[index] == NULL) {
+        table->used++; // Reused tombstone is already counted
     }
+    table->names[index] = name;
+    table->hashes[index] = hash;
+    table->count++;
+    return &table->symbols[index];
+}
 
-    func->name = strdup(name);
-    func->type = return_type;
-    func->has_return = false;
-    func->used = false;
-    func->is_nullable = is_nullable;
-    func->is_initialized = is_initialized;
-    func->fn_node = fn_node;
-    func->scope_stack = init_scope_stack();
-
-    Symbol *symbol = malloc(sizeof(Symbol));
-    if (!symbol) {
-        exit(INTERNAL_ERROR);
-    }
+/**
+ * @brief Adds a function symbol to the symbol table.
+ * @param table Pointer to the symbol table.
+ * @param name The name of the function.
+ * @param return_type The return type of the function.
+ * @param is_initialized Whether the function is initialized.
+ * @param fn_node Pointer to the function's AST node.
+ * @param is_nullable Whether the function can return null.
+ */
+void add_function_symbol(SymbolTable *table, const char *name, DataType return_type, bool is_initialized, ASTNode *fn_node, bool is_nullable) {
+    Symbol *symbol = insert_slot(table, name);
 
     symbol->type = SYMBOL_FUNC;
-    symbol->func = *func;
-
-    table->symbols[index] = symbol;
-    table->count++;
+    symbol->func.name = name;
+    symbol->func.type = return_type;
+    symbol->func.has_return = false;
+    symbol->func.used = false;
+    symbol->func.is_nullable = is_nullable;
+    symbol->func.is_initialized = is_initialized;
+    symbol->func.fn_node = fn_node;
 }
 
 /**
@@ -159,26 +151,34 @@ void add_function_symbol(SymbolTable *table, const char *name, DataType return_t
  * @param value The initial value of the variable.
  */
 void add_variable_symbol(SymbolTable *table, const char *name, DataType type, bool is_constant, bool is_nullable, bool has_literal, double value) {
-    if ((float)table->count / table->capacity >= LOAD_FACTOR) {
-        resize(table);
-    }
+    Symbol *symbol = insert_slot(table, name);
 
-    unsigned int index = hash(name, table->capacity);
-    while (table->symbols[index] != NULL) {
-        index = (index + 1) % table->capacity;
-    }
-
-    VarSymbol var = {.name = strdup(name), .type = type, .is_constant = false, .used = false, .is_nullable = false, .redefined = false, .has_literal = false, .value = 0};
-    Symbol *symbol = malloc(sizeof(Symbol));
     symbol->type = SYMBOL_VAR;
-    symbol->var = var;
-    symbol->var.is_constant = is_constant;
-    symbol->var.value = value;
-    symbol->var.is_nullable = is_nullable;
-    symbol->var.has_literal = has_literal;
+    symbol->var = (VarSymbol){.name = name, .type = type, .is_constant = is_constant, .used = false, .is_nullable = is_nullable,
+                              .redefined = false, .has_literal = has_literal, .value = value};
+}
 
-    table->symbols[index] = symbol;
-    table->count++;
+/**
+ * @brief Finds index of the slot holding a symbol with the given name.
+ * @param table Pointer to the symbol table.
+ * @param name Interned name of the symbol.
+ * @return Index of the slot, or -1 if not found.
+ */
+static int find_slot(SymbolTable *table, const char *name) {
+    if (table->count == 0) {
+        return -1;
+    }
+
+    unsigned int mask = table->capacity - 1;
+    unsigned int index = intern_hash(name) & mask;
+    while (table->names[index] != NULL) {
+        // Interned names are equal only if pointers are equal
+        if (table->names[index] == name) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+    return -1;
 }
 
 /**
@@ -188,15 +188,23 @@ void add_variable_symbol(SymbolTable *table, const char *name, DataType type, bo
  * @return Pointer to the found symbol, or NULL if not found.
  */
 Symbol *lookup_symbol(SymbolTable *table, const char *name) {
-    unsigned int index = hash(name, table->capacity);
-    while (table->symbols[index] != NULL) {
-        const char *current_name = table->symbols[index]->type == SYMBOL_FUNC
-                                       ? table->symbols[index]->func.name
-                                       : table->symbols[index]->var.name;
-        if (strcmp(current_name, name) == 0) {
-            return table->symbols[index];
-        }
-        index = (index + 1) % table->capacity;
+    int index = find_slot(table, name);
+    return index >= 0 ? &table->symbols[index] : NULL;
+}
+
+/**
+ * @brief Removes a symbol from the symbol table.
+ * @param table Pointer to the symbol table.
+ * @param name The name of the symbol to remove.
+ * @return true if the symbol was removed, false if not found.
+ */
+bool remove_symbol(SymbolTable *table, const char *name) {
+    int index = find_slot(table, name);
+    if (index < 0) {
+        return false;
     }
-    return NULL;
+
+    table->names[index] = SYMBOL_TOMBSTONE;
+    table->count--;
+    return true;
 }
@@ -0,0 +1,111 @@
+/**
+ * @file token_stream.c
+ * @brief Contains implementation of the token stream
+ * @authors Michal Repcik (xrepcim00)
+*/
+#include <stdlib.h>
+#include <string.h>
+
+#include "token_stream.h"
+
+// Reallocates array to capacity elements of size, returns 0 on success
+static int grow_array(void** array, size_t capacity, size_t size) {
+    void* tmp = realloc(*array, capacity * size);
+    if (tmp == NULL) {
+        return -1;
+    }
+    *array = tmp;
+    return 0;
+}
+
+// Resizes all arrays of the stream to capacity tokens
+static int resize_token_stream(TokenStream* stream, size_t capacity) {
+    if (grow_array((void**)&stream->types, capacity, sizeof(*stream->types)) != 0 ||
+        grow_array((void**)&stream->offsets, capacity, sizeof(*stream->offsets)) != 0 ||
+        grow_array((void**)&stream->lengths, capacity, sizeof(*stream->lengths)) != 0 ||
+        grow_array((void**)&stream->lines, capacity, sizeof(*stream->lines)) != 0 ||
+        grow_array((void**)&stream->cols, capacity, sizeof(*stream->cols)) != 0 ||
+        grow_array((void**)&stream->flags, capacity, sizeof(*stream->flags)) != 0) {
+        return -1;
+    }
+    stream->capacity = capacity;
+    return 0;
+}
+
+int init_token_stream(TokenStream* stream, size_t capacity) {
+    if (stream == NULL) {
+        return -1;
+    }
+    stream->types = NULL;
+    stream->offsets = NULL;
+    stream->lengths = NULL;
+    stream->lines = NULL;
+    stream->cols = NULL;
+    stream->flags = NULL;
+    stream->count = 0;
+    stream->capacity = 0;
+
+    if (resize_token_stream(stream, capacity > 0 ? capacity : 1) != 0) {
+        destroy_token_stream(stream);
+        return -1;
+    }
+    return 0;
+}
+
+void destroy_token_stream(TokenStream* stream) {
+    if (stream == NULL) {
+        return;
+    }
+
+    free(stream->types);
+    free(stream->offsets);
+    free(stream->lengths);
+    free(stream->lines);
+    free(stream->cols);
+    free(stream->flags);
+    stream->types = NULL;
+    stream->offsets = NULL;
+    stream->lengths = NULL;
+    stream->lines = NULL;
+    stream->cols = NULL;
+    stream->flags = NULL;
+    stream->count = 0;
+    stream->capacity = 0;
+}
+
+int push_token(TokenStream* stream, const Token* token) {
+    if (stream->count == stream->capacity && resize_token_stream(stream, stream->capacity * 2) != 0) {
+        return -1;
+    }
+
+    size_t i = stream->count++;
+    stream->types[i] = (uint8_t)token->token_type;
+    stream->offsets[i] = token->offset;
+    stream->lengths[i] = token->length;
+    stream->lines[i] = token->line;
+    stream->cols[i] = token->col;
+    stream->flags[i] = token->flags;
+    return 0;
+}
+
+int append_tokens(TokenStream* stream, const TokenStream* other, size_t count, uint32_t line_offset) {
+    size_t capacity = stream->capacity;
+    while (capacity < stream->count + count) {
+        capacity *= 2;
+    }
+    if (capacity != stream->capacity && resize_token_stream(stream, capacity) != 0) {
+        return -1;
+    }
+
+    size_t i = stream->count;
+    memcpy(stream->types + i, other->types, count * sizeof(*stream->types));
+    memcpy(stream->offsets + i, other->offsets, count * sizeof(*stream->offsets));
+    memcpy(stream->lengths + i, other->lengths, count * sizeof(*stream->lengths));
+    memcpy(stream->cols + i, other->cols, count * sizeof(*stream->cols));
+    memcpy(stream->flags + i, other->flags, count * sizeof(*stream->flags));
+    for (size_t j = 0; j < count; j++) {
+        stream->lines[i + j] = other->lines[j] + line_offset;
+    }
+    stream->count += count;
+    return 0;
+}
@@ -0,0 +1,222 @@
+/**
+ * @file writer.c
+ * @brief Contains implementation of the buffered output writer
+ * @authors Michal Repcik (xrepcim00)
+*/
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+
+#include "writer.h"
+
+/**
+ * @struct Writer
+ * @brief Output buffers and state of the flush thread.
+ *
+ * Buffer that is being written by the flush thread is pending, generation
+ * waits for it only when its own buffer is full again before the write ended.
+*/
+typedef struct {
+    char* buffer;           ///< Buffer the output is appended to.
+    size_t length;          ///< Number of used bytes of buffer.
+    char* spare;            ///< Second buffer, owned by the flush thread while it is pending.
+    FILE* out;              ///< Output stream.
+    bool background;        ///< Flag if the flush thread is running.
+    bool failed;            ///< Flag if any write failed.
+    pthread_t thread;       ///< Flush thread.
+    pthread_mutex_t lock;   ///< Guards pending, pending_length, stop and failed while the thread runs.
+    pthread_cond_t cond;    ///< Signals new pending buffer, finished write and stop.
+    char* pending;          ///< Buffer handed to the flush thread, NULL if the thread is idle.
+    size_t pending_length;  ///< Number of bytes of pending buffer.
+    bool stop;              ///< Flag for the flush thread to exit once it is idle.
+} Writer;
+
+static Writer writer = {0};
+
+static void* flush_thread(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&writer.lock);
+    while (true) {
+        while (writer.pending == NULL && !writer.stop) {
+            pthread_cond_wait(&writer.cond, &writer.lock);
+        }
+        if (writer.pending == NULL) {
+            break;
+        }
+        char* data = writer.pending;
+        size_t length = writer.pending_length;
+        pthread_mutex_unlock(&writer.lock);
+
+        bool failed = fwrite(data, 1, length, writer.out) != length;
+
+        pthread_mutex_lock(&writer.lock);
+        writer.failed |= failed;
+        writer.pending = NULL;
+        pthread_cond_broadcast(&writer.cond);
+    }
+    pthread_mutex_unlock(&writer.lock);
+    return NULL;
+}
+
+// Blocks until the flush thread finished the pending buffer, lock must be held
+static void wait_idle(void) {
+    while (writer.pending != NULL) {
+        pthread_cond_wait(&writer.cond, &writer.lock);
+    }
+}
+
+// Writes out the whole buffer, in background the spare buffer is taken for further output
+static void flush_buffer(void) {
+    if (writer.length == 0) {
+        return;
+    }
+    if (!writer.background) {
+        writer.failed |= fwrite(writer.buffer, 1, writer.length, writer.out) != writer.length;
+        writer.length = 0;
+        return;
+    }
+
+    char* full = writer.buffer;
+    pthread_mutex_lock(&writer.lock);
+    wait_idle(); // Spare buffer is free again
+    writer.pending = full;
+    writer.pending_length = writer.length;
+    pthread_cond_signal(&writer.cond);
+    pthread_mutex_unlock(&writer.lock);
+
+    writer.buffer = writer.spare;
+    writer.spare = full;
+    writer.length = 0;
+}
+
+int init_writer(FILE* out, bool background) {
+    writer = (Writer){0};
+    writer.out = out;
+    writer.buffer = malloc(WRITER_BUFFER_SIZE);
+    if (writer.buffer == NULL) {
+        return 1;
+    }
+    if (!background) {
+        return 0;
+    }
+
+    writer.spare = malloc(WRITER_BUFFER_SIZE);
+    if (writer.spare == NULL) {
+        free(writer.buffer);
+        return 1;
+    }
+    pthread_mutex_init(&writer.lock, NULL);
+    pthread_cond_init(&writer.cond, NULL);
+    if (pthread_create(&writer.thread, NULL, flush_thread, NULL) != 0) {
+        pthread_mutex_destroy(&writer.lock);
+        pthread_cond_destroy(&writer.cond);
+        free(writer.buffer);
+        free(writer.spare);
+        return 1;
+    }
+    writer.background = true;
+    return 0;
+}
+
+int destroy_writer(void) {
+    if (writer.background) {
+        pthread_mutex_lock(&writer.lock);
+        wait_idle();
+        writer.stop = true;
+        pthread_cond_signal(&writer.cond);
+        pthread_mutex_unlock(&writer.lock);
+        pthread_join(writer.thread, NULL);
+        pthread_mutex_destroy(&writer.lock);
+        pthread_cond_destroy(&writer.cond);
+        writer.background = false;
+    }
+    flush_buffer(); // Rest of the output is written directly
+    bool failed = writer.failed || fflush(writer.out) != 0;
+
+    free(writer.buffer);
+    free(writer.spare);
+    writer = (Writer){0};
+    return failed ? 1 : 0;
+}
+
+void write_chars(const char* data, size_t length) {
+    while (length > 0) {
+        if (writer.length == WRITER_BUFFER_SIZE) {
+            flush_buffer();
+        }
+        size_t count = WRITER_BUFFER_SIZE - writer.length;
+        if (count > length) {
+            count = length;
+        }
+        memcpy(writer.buffer + writer.length, data, count);
+        writer.length += count;
+        data += count;
+        length -= count;
+    }
+}
+
+void write_str(const char* str) {
+    write_chars(str, strlen(str));
+}
+
+void write_char(char c) {
+    if (writer.length == WRITER_BUFFER_SIZE) {
+        flush_buffer();
+    }
+    writer.buffer[writer.length++] = c;
+}
+
+void write_int(long long value) {
+    char digits[24];
+    int count = 0;
+    unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[sizeof(digits) - 1 - count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) {
+        digits[sizeof(digits) - 1 - count++] = '-';
+    }
+    write_chars(digits + sizeof(digits) - count, count);
+}
+
+void write_float(double value) {
+    // Subnormal numbers, infinities and NaN are rare enough for printf
+    if (!isfinite(value) || (value != 0 && fabs(value) < DBL_MIN)) {
+        char text[64];
+        int length = snprintf(text, sizeof(text), "%a", value);
+        write_chars(text, length);
+        return;
+    }
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if (bits >> 63) {
+        write_char('-');
+    }
+    if (value == 0) {
+        write_chars("0x0p+0", 6);
+        return;
+    }
+
+    int exponent = (int)((bits >> 52) & 0x7ff) - 1023;
+    uint64_t mantissa = bits & ((UINT64_C(1) << 52) - 1);
+    write_chars("0x1", 3);
+    if (mantissa != 0) {
+        int digits = 13; // 52 bits of mantissa, trailing zero digits are not printed
+        while ((mantissa & 0xf) == 0) {
+            mantissa >>= 4;
+            digits--;
+        }
+        write_char('.');
+        for (int i = digits - 1; i >= 0; i--) {
+            write_char("0123456789abcdef"[(mantissa >> (4 * i)) & 0xf]);
+        }
+    }
+    write_char('p');
+    write_char(exponent < 0 ? '-' : '+');
+    write_int(exponent < 0 ? -exponent : exponent);
+}
@@ -0,0 +1,196 @@
+/**
+ * @file bench_lexer.c
+ * @brief Lexer throughput benchmark
+ *
+ * Lexes a source file several times and reports the best observed throughput.
+ * When no file is given, generated synthetic IFJ24 program is used together
+ * with inputs dominated by a single lexer state (whitespace, comments,
+ * identifiers and string literals) to show throughput per state. Synthetic
+ * program is also lexed into the token stream with 1 to N threads
+ * (tokenize_parallel) to show cost of the pre-pass and its scaling.
+ *
+ * Usage: ./bench_lexer [file] [runs]
+ * @authors Michal Repcik (xrepcim00)
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "lexer.h"
+#include "token.h"
+#include "error.h"
+
+#define SYNTH_FUNCTIONS 20000
+#define SYNTH_LINES 100000
+#define DEFAULT_RUNS 5
+
+// Writes synthetic IFJ24 program into fp
+static void generate_source(FILE* fp) {
+    fprintf(fp, "const ifj = @import(\"ifj24.zig\");\n");
+    for (int i = 0; i < SYNTH_FUNCTIONS; i++) {
+        fprintf(fp,
+            "// function number %d computes something moderately interesting\n"
+            "pub fn func_%d(alpha_%d: i32, beta_%d: f64) i32 {\n"
+            "    var counter_value = alpha_%d;\n"
+            "    const scale_factor: f64 = beta_%d * 2.5e0;\n"
+            "    var accumulator: i32 = 0;\n"
+            "    const message = \"function %d says hello \\n with \\\"quotes\\\" and \\x41\";\n"
+            "    const text: []u8 = ifj.string(\\\\multi line\n"
+            "        \\\\ string literal\n"
+            "    );\n"
+            "    const maybe: ?i32 = null;\n"
+            "    while (counter_value > 0) {\n"
+            "        accumulator = accumulator + counter_value * 3 - 1;\n"
+            "        counter_value = counter_value - 1;\n"
+            "    }\n"
+            "    if (scale_factor >= 1.0) {\n"
+            "        ifj.write(message);\n"
+            "    } else {\n"
+            "        ifj.write(scale_factor);\n"
+            "    }\n"
+            "    return accumulator;\n"
+            "}\n",
+            i, i, i, i, i, i, i);
+    }
+    fprintf(fp, "pub fn main() void {\n}\n");
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Writes input consisting mostly of whitespace (START state)
+static void generate_whitespace(FILE* fp) {
+    for (int i = 0; i < SYNTH_LINES; i++) {
+        fprintf(fp, "x%-64s;\n\t\t    \t        \n", "");
+    }
+}
+
+// Writes input consisting mostly of comments (COMMENT state)
+static void generate_comments(FILE* fp) {
+    for (int i = 0; i < SYNTH_LINES; i++) {
+        fprintf(fp, "// comment line %d, nothing to see here, keep scanning until the end\n", i);
+    }
+}
+
+// Writes input consisting mostly of long identifiers (ID_OR_KEY state)
+static void generate_identifiers(FILE* fp) {
+    for (int i = 0; i < SYNTH_LINES; i++) {
+        fprintf(fp, "some_rather_long_identifier_%d another_Identifier_With_Caps_%d\n", i, i);
+    }
+}
+
+// Writes input consisting mostly of string literals (STRING state)
+static void generate_strings(FILE* fp) {
+    for (int i = 0; i < SYNTH_LINES; i++) {
+        fprintf(fp, "\"string literal number %d with \\n escapes and a fairly long body\",\n", i);
+    }
+}
+
+// Lexes file runs times (into token stream using threads if not 0) and prints best throughput, returns 0 on success
+static int bench_file(const char* label, const char* path, int runs, int threads) {
+    double best = -1.0;
+    long size = 0;
+    long tokens = 0;
+    for (int run = 0; run < runs; run++) {
+        FILE* fp = fopen(path, "r");
+        if (fp == NULL) {
+            fprintf(stderr, "Failed to read from the file\n");
+            return INTERNAL_ERROR;
+        }
+        fseek(fp, 0, SEEK_END);
+        size = ftell(fp);
+        rewind(fp);
+
+        double start = now();
+        Lexer lexer;
+        if (init_lexer(&lexer, fp) != 0) {
+            return INTERNAL_ERROR;
+        }
+        tokens = 0;
+        if (threads > 0) {
+            if (tokenize_parallel(&lexer, threads) != 0) {
+                return INTERNAL_ERROR;
+            }
+            tokens = (long)lexer.tokens.count;
+            if (lexer.tokens.types[tokens - 1] == INVALID) {
+                fprintf(stderr, "Lexical error after %ld tokens\n", tokens - 1);
+                return LEXICAL_ERROR;
+            }
+        }
+        while (threads == 0) {
+            Token token = get_token(&lexer);
+            if (token.token_type == INVALID) {
+                fprintf(stderr, "Lexical error after %ld tokens\n", tokens);
+                return LEXICAL_ERROR;
+            }
+            tokens++;
+            if (token.token_type == TOKEN_EOF) {
+                break;
+            }
+        }
+        destroy_lexer(&lexer);
+        double elapsed = now() - start;
+        if (best < 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+
+    printf("%-12s %9ld bytes, %8ld tokens, best of %d runs: %8.3f ms, %7.1f MB/s, %5.1f Mtok/s\n",
+           label, size, tokens, runs, best * 1e3, size / best / 1e6, tokens / best / 1e6);
+    return 0;
+}
+
+// Lexes file into token stream with 1, 2, 4, ... threads up to number of cores
+static int bench_scaling(const char* path, int runs) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int ret = 0;
+    for (long threads = 1; ret == 0; threads *= 2) {
+        threads = threads < cores ? threads : cores; // Last step runs on all cores
+        char label[32];
+        snprintf(label, sizeof(label), "  -j%ld", threads);
+        ret = bench_file(label, path, runs, (int)threads);
+        if (threads >= cores) {
+            break;
+        }
+    }
+    return ret;
+}
+
+// Generates temporary source file and benchmarks it
+static int bench_generated(const char* label, void (*generate)(FILE*), int runs, int scaling) {
+    char tmp_path[] = "/tmp/bench_lexer_XXXXXX";
+    int fd = mkstemp(tmp_path);
+    FILE* fp = fd < 0 ? NULL : fdopen(fd, "w");
+    if (fp == NULL) {
+        fprintf(stderr, "Failed to create temporary source file\n");
+        return INTERNAL_ERROR;
+    }
+    generate(fp);
+    fclose(fp);
+
+    int ret = bench_file(label, tmp_path, runs, 0);
+    if (ret == 0 && scaling) {
+        ret = bench_scaling(tmp_path, runs);
+    }
+    remove(tmp_path);
+    return ret;
+}
+
+int main(int argc, char** argv) {
+    int runs = argc > 2 ? atoi(argv[2]) : DEFAULT_RUNS;
+    if (argc > 1) {
+        int ret = bench_file(argv[1], argv[1], runs, 0);
+        return ret == 0 ? bench_scaling(argv[1], runs) : ret;
+    }
+
+    int ret = bench_generated("program", generate_source, runs, 1);
+    if (ret == 0) ret = bench_generated("whitespace", generate_whitespace, runs, 0);
+    if (ret == 0) ret = bench_generated("comments", generate_comments, runs, 0);
+    if (ret == 0) ret = bench_generated("identifiers", generate_identifiers, runs, 0);
+    if (ret == 0) ret = bench_generated("strings", generate_strings, runs, 0);
+    return ret;
+}
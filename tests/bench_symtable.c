@@ -0,0 +1,109 @@
+/**
+ * @file bench_symtable.c
+ * @brief Symbol table microbenchmark
+ *
+ * Inserts N variable symbols into a symbol table, looks all of them up
+ * (hits), looks up N names that are not in the table (misses) and removes
+ * and re-inserts every symbol (churn through tombstones). Reports best time
+ * per operation for 10, 1k and 1M symbols.
+ *
+ * Usage: ./bench_symtable [runs]
+ * @authors Michal Repcik (xrepcim00)
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "symtable.h"
+#include "intern.h"
+#include "error.h"
+
+#define DEFAULT_RUNS 5
+#define MIN_OPS 2000000 // Small tables are repeated until at least this many operations are done
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Interns count names with given prefix
+static const char** make_names(const char* prefix, int count) {
+    const char** names = malloc(count * sizeof(const char*));
+    if (names == NULL) {
+        return NULL;
+    }
+    char buff[64];
+    for (int i = 0; i < count; i++) {
+        int len = snprintf(buff, sizeof(buff), "%s_%d", prefix, i);
+        names[i] = intern(buff, len);
+    }
+    return names;
+}
+
+// Runs all phases on count symbols, times are accumulated into best (ns per operation)
+static int bench_size(int count, int runs) {
+    const char** names = make_names("symbol", count);
+    const char** missing = make_names("missing", count);
+    if (names == NULL || missing == NULL) {
+        free(names);
+        free(missing);
+        return INTERNAL_ERROR;
+    }
+
+    int reps = count < MIN_OPS ? MIN_OPS / count : 1;
+    double best[4] = {-1.0, -1.0, -1.0, -1.0};
+    long found = 0;
+    for (int run = 0; run < runs; run++) {
+        double phase[4] = {0.0, 0.0, 0.0, 0.0};
+        for (int rep = 0; rep < reps; rep++) {
+            SymbolTable* table = init_symbol_table();
+
+            double start = now();
+            for (int i = 0; i < count; i++) {
+                add_variable_symbol(table, names[i], AST_I32, false, false, false, 0);
+            }
+            double inserted = now();
+            for (int i = 0; i < count; i++) {
+                found += lookup_symbol(table, names[i]) != NULL;
+            }
+            double hits = now();
+            for (int i = 0; i < count; i++) {
+                found += lookup_symbol(table, missing[i]) != NULL;
+            }
+            double misses = now();
+            for (int i = 0; i < count; i++) {
+                remove_symbol(table, names[i]);
+                add_variable_symbol(table, names[i], AST_I32, false, false, false, 0);
+            }
+            double churn = now();
+
+            free_symbol_table(table);
+            phase[0] += inserted - start;
+            phase[1] += hits - inserted;
+            phase[2] += misses - hits;
+            phase[3] += churn - misses;
+        }
+        for (int i = 0; i < 4; i++) {
+            if (best[i] < 0 || phase[i] < best[i]) {
+                best[i] = phase[i];
+            }
+        }
+    }
+
+    double ops = (double)count * reps;
+    printf("%8d symbols: insert %6.1f ns, lookup hit %6.1f ns, lookup miss %6.1f ns, remove+insert %6.1f ns (found %ld)\n",
+           count, best[0] / ops * 1e9, best[1] / ops * 1e9, best[2] / ops * 1e9, best[3] / ops * 1e9, found);
+    free(names);
+    free(missing);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int runs = argc > 1 ? atoi(argv[1]) : DEFAULT_RUNS;
+    int ret = bench_size(10, runs);
+    if (ret == 0) ret = bench_size(1000, runs);
+    if (ret == 0) ret = bench_size(1000000, runs);
+    free_interns();
+    return ret;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file gen_keyword_hash.c
+ * @brief Generates perfect hash table of IFJ24 keywords
+ * @authors Michal Repcik (xrepcim00)
+ *
+ * Searches for the smallest power of two table size and multipliers A, B
+ * such that (first * A + last * B + length) & (size - 1) is different for
+ * every keyword and prints the table as C source to stdout.
+ *
+ * Usage: ./gen_keyword_hash > inc/keyword_table.h (make keywords)
+*/
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @struct Keyword
+ * @brief Keyword and name of its token constant.
+*/
+typedef struct {
+    const char* keyword;    ///< Keyword string.
+    const char* token;      ///< Name of the token constant.
+} Keyword;
+
+static const Keyword keywords[] = {
+    {"const", "TOKEN_CONST"},
+    {"else", "TOKEN_ELSE"},
+    {"fn", "TOKEN_FN"},
+    {"if", "TOKEN_IF"},
+    {"i32", "TOKEN_I32"},
+    {"f64", "TOKEN_F64"},
+    {"u8", "TOKEN_U8"},
+    {"null", "TOKEN_NULL"},
+    {"pub", "TOKEN_PUB"},
+    {"return", "TOKEN_RETURN"},
+    {"var", "TOKEN_VAR"},
+    {"void", "TOKEN_VOID"},
+    {"while", "TOKEN_WHILE"},
+};
+
+#define KEYWORD_COUNT (int)(sizeof(keywords) / sizeof(keywords[0]))
+#define MAX_SIZE 256
+#define MAX_MULT 64
+
+static unsigned hash(const char* kw, unsigned a, unsigned b, unsigned mask) {
+    size_t len = strlen(kw);
+    return ((unsigned char)kw[0] * a + (unsigned char)kw[len - 1] * b + (unsigned)len) & mask;
+}
+
+// Returns 1 if multipliers a, b map every keyword to a different slot
+static int is_perfect(unsigned a, unsigned b, unsigned mask) {
+    int used[MAX_SIZE] = {0};
+    for (int i = 0; i < KEYWORD_COUNT; i++) {
+        unsigned h = hash(keywords[i].keyword, a, b, mask);
+        if (used[h]) {
+            return 0;
+        }
+        used[h] = 1;
+    }
+    return 1;
+}
+
+int main(void) {
+    size_t min_len = (size_t)-1;
+    size_t max_len = 0;
+    for (int i = 0; i < KEYWORD_COUNT; i++) {
+        size_t len = strlen(keywords[i].keyword);
+        min_len = len < min_len ? len : min_len;
+        max_len = len > max_len ? len : max_len;
+    }
+
+    for (unsigned size = 1; size <= MAX_SIZE; size *= 2) {
+        if ((int)size < KEYWORD_COUNT) {
+            continue;
+        }
+        for (unsigned a = 1; a < MAX_MULT; a++) {
+            for (unsigned b = 0; b < MAX_MULT; b++) {
+                if (!is_perfect(a, b, size - 1)) {
+                    continue;
+                }
+
+                const Keyword* slots[MAX_SIZE] = {0};
+                for (int i = 0; i < KEYWORD_COUNT; i++) {
+                    slots[hash(keywords[i].keyword, a, b, size - 1)] = &keywords[i];
+                }
+
+                printf("/* Generated by tools/gen_keyword_hash.c (make keywords), do not edit. */\n\n");
+                printf("#define KEYWORD_HASH_A %u ///< Multiplier of the first character.\n", a);
+                printf("#define KEYWORD_HASH_B %u ///< Multiplier of the last character.\n", b);
+                printf("#define KEYWORD_TABLE_SIZE %u ///< Number of slots in keyword table.\n", size);
+                printf("#define KEYWORD_MIN_LEN %zu ///< Length of the shortest keyword.\n", min_len);
+                printf("#define KEYWORD_MAX_LEN %zu ///< Length of the longest keyword.\n\n", max_len);
+                printf("static const KeywordEntry keyword_table[KEYWORD_TABLE_SIZE] = {\n");
+                for (unsigned i = 0; i < size; i++) {
+                    if (slots[i] != NULL) {
+                        printf("    {\"%s\", %zu, %s},\n", slots[i]->keyword, strlen(slots[i]->keyword), slots[i]->token);
+                    }
+                    else {
+                        printf("    {\"\", 0, TOKEN_IDENTIFIER},\n");
+                    }
+                }
+                printf("};\n");
+                return 0;
+            }
+        }
+    }
+
+    fprintf(stderr, "gen_keyword_hash: no perfect hash found\n");
+    return 1;
+}
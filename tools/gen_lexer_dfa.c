@@ -0,0 +1,247 @@
+/**
+ * @file gen_lexer_dfa.c
+ * @brief Generates transition table of the table driven lexer
+ * @authors Michal Repcik (xrepcim00)
+ *
+ * Behaviour of the lexer is described by classify() and step() functions
+ * which mirror FSM in lexer.c. Generator evaluates step() for every state
+ * and every character class, checks that all characters of a class lead to
+ * the same transition and prints the dense tables as C source to stdout.
+ *
+ * Usage: ./gen_lexer_dfa > lexer_dfa_table.h
+ * (linked together with ascii_lookup.c)
+*/
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ascii_lookup.h"
+#include "lexer_dfa.h"
+
+/**
+ * @struct Step
+ * @brief Single transition of the DFA.
+*/
+typedef struct {
+    int state;      ///< Next state.
+    int action;     ///< Action performed on transition.
+} Step;
+
+static LookupTable ascii_l_table; // Single character tokens, same table as in the FSM
+
+static int isvalid(int c) {
+    return c < 128 && ascii_l_table[c] != INVALID;
+}
+
+static int isterm(int c) {
+    return isspace(c) || isvalid(c);
+}
+
+static int ishexnum(int c) {
+    return isxdigit(c);
+}
+
+static int isescseq(int c) {
+    return c == 'n' || c == 't' || c == 'r' || c == '"' || c == '\\';
+}
+
+static int classify(int c) {
+    switch (c) {
+        case '\n': return CLS_NEWLINE;
+        case ' ': case '\t': return CLS_BLANK;
+        case '\v': case '\f': case '\r': return CLS_SPACE;
+        case '/': return CLS_SLASH;
+        case '\\': return CLS_BSLASH;
+        case '@': return CLS_AT;
+        case '"': return CLS_QUOTE;
+        case '0': return CLS_ZERO;
+        case '?': return CLS_QMARK;
+        case '_': return CLS_UNDERSCORE;
+        case '[': return CLS_L_BRACKET;
+        case ']': return CLS_R_BRACKET;
+        case '<': case '>': case '!': return CLS_CMP;
+        case '=': return CLS_EQ;
+        case '.': return CLS_DOT;
+        case '+': case '-': return CLS_SIGN;
+        case 'e': case 'E': return CLS_E;
+        case 'x': return CLS_X;
+        case 'n': case 't': case 'r': return CLS_ESC;
+        default:
+            if (c >= '1' && c <= '9') return CLS_DIGIT;
+            if (isvalid(c)) return CLS_PUNCT;
+            if (isxdigit(c)) return CLS_HEX;
+            if (isalpha(c)) return CLS_ALPHA;
+            return CLS_OTHER;
+    }
+}
+
+#define GO(s, a) do { Step st = { (s), (a) }; return st; } while (0)
+
+// Transition from state s on character c, errors keep the state like the FSM does
+static Step step(int s, int c) {
+    switch (s) {
+        case START:
+            switch (c) {
+                case '\n': GO(START, ACT_NEWLINE);
+                case ' ': case '\t': GO(START, ACT_NONE);
+                case '/': GO(FWD_SLASH, ACT_MARK);
+                case '\\': GO(BCK_SLASH, ACT_MARK_ML);
+                case '@': GO(IMPORT, ACT_MARK);
+                case '"': GO(STRING, ACT_MARK);
+                case '0': GO(ZERO, ACT_MARK);
+                case '?': GO(Q_MARK, ACT_EMIT_Q_MARK);
+                case '_': GO(UNDERSCORE, ACT_MARK);
+                case '[': GO(L_SQ_BRACKET, ACT_MARK);
+                case '>': case '<': case '=': case '!': GO(MULTI_OP, ACT_MARK);
+                default:
+                    if (isalpha(c)) GO(ID_OR_KEY, ACT_MARK);
+                    if (c > '0' && c <= '9') GO(INTEGER, ACT_MARK);
+                    if (isvalid(c)) GO(START, ACT_EMIT_CHAR);
+                    GO(START, ACT_MARK_ERROR);
+            }
+        case BCK_SLASH:
+            if (c == '\\') GO(MULTI_STRING, ACT_NONE);
+            GO(s, ACT_ERROR);
+        case MULTI_STRING:
+            if (c == '\n') GO(EO_ML_STRING, ACT_ML_NEWLINE);
+            GO(MULTI_STRING, ACT_NONE);
+        case EO_ML_STRING:
+            if (c == ' ' || c == '\t') GO(EO_ML_STRING, ACT_NONE);
+            if (c == '\\') GO(BCK_SLASH, ACT_NONE);
+            GO(START, ACT_EMIT_ML_STRING);
+        case IMPORT: GO(DFA_IMPORT1, ACT_NONE);
+        case DFA_IMPORT1: GO(DFA_IMPORT2, ACT_NONE);
+        case DFA_IMPORT2: GO(DFA_IMPORT3, ACT_NONE);
+        case DFA_IMPORT3: GO(DFA_IMPORT4, ACT_NONE);
+        case DFA_IMPORT4: GO(DFA_IMPORT5, ACT_NONE);
+        case DFA_IMPORT5: GO(START, ACT_EMIT_IMPORT);
+        case MULTI_OP:
+            if (c == '=') GO(START, ACT_EMIT_MULTI_EQ);
+            GO(START, ACT_EMIT_MULTI_OP);
+        case ID_OR_KEY:
+            if (isalnum(c) || c == '_') GO(ID_OR_KEY, ACT_NONE);
+            if (isterm(c)) GO(START, ACT_EMIT_ID);
+            GO(s, ACT_ERROR);
+        case STRING:
+        case DFA_STRING_X:
+            if (c == '"') GO(START, ACT_EMIT_STRING);
+            if (c == '\\') GO(s == STRING ? ESC_SEQ : DFA_ESC_SEQ_X, ACT_NONE);
+            if (c == '\n') GO(s, ACT_ERROR);
+            GO(s, ACT_NONE);
+        case ESC_SEQ:
+            if (isescseq(c)) GO(STRING, ACT_NONE);
+            if (c == 'x') GO(HEX_NUM, ACT_NONE);
+            GO(s, ACT_ERROR);
+        case DFA_ESC_SEQ_X:
+            if (isescseq(c)) GO(DFA_STRING_X, ACT_NONE);
+            if (c == 'x') GO(DFA_HEX_DEAD, ACT_NONE);
+            GO(s, ACT_ERROR);
+        case HEX_NUM:
+            if (ishexnum(c)) GO(DFA_HEX2, ACT_NONE);
+            GO(s, ACT_ERROR);
+        case DFA_HEX2:
+            if (ishexnum(c)) GO(DFA_STRING_X, ACT_NONE);
+            GO(s, ACT_ERROR);
+        case DFA_HEX_DEAD:
+            GO(s, ACT_ERROR);
+        case UNDERSCORE:
+            if (isalnum(c) || c == '_') GO(ID_OR_KEY, ACT_NONE);
+            if (isterm(c)) GO(START, ACT_EMIT_UNDERSCORE);
+            GO(s, ACT_ERROR);
+        case ZERO:
+            if (c == '.') GO(FLOAT, ACT_NONE);
+            if (isterm(c)) GO(START, ACT_EMIT_INTEGER);
+            GO(s, ACT_ERROR);
+        case INTEGER:
+            if (c == '.') GO(FLOAT, ACT_NONE);
+            if (c == 'e' || c == 'E') GO(EXPONENT, ACT_NONE);
+            if (isdigit(c)) GO(INTEGER, ACT_NONE);
+            if (isterm(c)) GO(START, ACT_EMIT_INTEGER);
+            GO(s, ACT_ERROR);
+        case FLOAT:
+            if (isdigit(c)) GO(FLOAT, ACT_NONE);
+            if (c == 'e' || c == 'E') GO(EXPONENT, ACT_NONE);
+            if (isterm(c)) GO(START, ACT_EMIT_FLOAT);
+            GO(s, ACT_ERROR);
+        case EXPONENT:
+            if (c == '+' || c == '-') GO(SIGN, ACT_NONE);
+            if (isdigit(c)) GO(EXPONENT_NUM, ACT_NONE);
+            GO(s, ACT_ERROR);
+        case SIGN:
+            if (isdigit(c)) GO(EXPONENT_NUM, ACT_NONE);
+            GO(s, ACT_ERROR);
+        case EXPONENT_NUM:
+            if (isdigit(c)) GO(EXPONENT_NUM, ACT_NONE);
+            if (isterm(c)) GO(START, ACT_EMIT_FLOAT);
+            GO(s, ACT_ERROR);
+        case FWD_SLASH:
+            if (c == '/') GO(COMMENT, ACT_NONE);
+            if (isterm(c) || isalnum(c)) GO(START, ACT_EMIT_DIV);
+            GO(s, ACT_ERROR);
+        case COMMENT:
+            if (c == '\n') GO(START, ACT_NEWLINE);
+            GO(COMMENT, ACT_NONE);
+        case Q_MARK:
+            if (c == '[') GO(L_SQ_BRACKET, ACT_NONE);
+            if (isalpha(c)) GO(KEYWORD, ACT_NONE);
+            GO(s, ACT_ERROR);
+        case KEYWORD:
+            if (isalnum(c)) GO(KEYWORD, ACT_NONE);
+            if (isterm(c)) GO(START, ACT_EMIT_ID);
+            GO(s, ACT_ERROR);
+        case L_SQ_BRACKET:
+            if (c == ']') GO(R_SQ_BRACKET, ACT_EMIT_SLICE);
+            GO(s, ACT_ERROR);
+        case R_SQ_BRACKET:
+            if (isalpha(c)) GO(KEYWORD, ACT_NONE);
+            GO(s, ACT_ERROR);
+        default:
+            fprintf(stderr, "gen_lexer_dfa: unknown state %d\n", s);
+            exit(1);
+    }
+}
+
+int main(void) {
+    int repr[DFA_CLASS_COUNT];
+    init_lookup_table(ascii_l_table);
+    for (int cls = 0; cls < DFA_CLASS_COUNT; cls++) {
+        repr[cls] = -1;
+    }
+    for (int c = 0; c < 256; c++) {
+        if (repr[classify(c)] < 0) {
+            repr[classify(c)] = c;
+        }
+    }
+
+    // Every character has to behave exactly like the representative of its class
+    for (int s = 0; s < DFA_STATE_COUNT; s++) {
+        for (int c = 0; c < 256; c++) {
+            Step a = step(s, c);
+            Step b = step(s, repr[classify(c)]);
+            if (a.state != b.state || a.action != b.action) {
+                fprintf(stderr, "gen_lexer_dfa: class %d is not uniform in state %d (char %d)\n",
+                        classify(c), s, c);
+                return 1;
+            }
+        }
+    }
+
+    printf("/* Generated by tools/gen_lexer_dfa.c, do not edit. */\n\n");
+    printf("static const unsigned char dfa_class[256] = {");
+    for (int c = 0; c < 256; c++) {
+        printf("%s%2d,", c % 16 ? " " : "\n    ", classify(c));
+    }
+    printf("\n};\n\n");
+
+    printf("static const unsigned short dfa_table[DFA_STATE_COUNT][DFA_CLASS_COUNT] = {\n");
+    for (int s = 0; s < DFA_STATE_COUNT; s++) {
+        printf("    {");
+        for (int cls = 0; cls < DFA_CLASS_COUNT; cls++) {
+            Step st = repr[cls] < 0 ? step(s, 0) : step(s, repr[cls]);
+            printf("%s0x%03x", cls ? ", " : "", (st.action << DFA_STATE_BITS) | st.state);
+        }
+        printf("},\n");
+    }
+    printf("};\n");
+    return 0;
+}